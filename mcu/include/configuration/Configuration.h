@@ -11,9 +11,11 @@
 
 #include <Arduino.h>
 #include <FS.h>
+#include <Preferences.h>
+#include <esp32/rom/crc.h>
 
 #include "configuration/SystemConfiguration.h"
-#include "util/BinaryFile.h"
+#include "util/InMemoryBinaryFile.h"
 #include "logging/Logger.h"
 
 namespace TesLight
@@ -82,7 +84,7 @@ namespace TesLight
 			float gyroZDeg;	  // Z rotation in deg/s
 		};
 
-		Configuration(FS *fileSystem, const String fileName);
+		Configuration(const String nvsNamespace);
 		~Configuration();
 
 		TesLight::Configuration::SystemConfig getSystemConfig();
@@ -97,20 +99,43 @@ namespace TesLight
 		TesLight::Configuration::MotionSensorCalibration getMotionSensorCalibration();
 		void setMotionSensorCalibration(const TesLight::Configuration::MotionSensorCalibration calibration);
 
+		void setBackupFile(FS *fileSystem, const String fileName);
+
 		void loadDefaults();
 		bool load();
 		bool save();
+		bool flush(const bool force = false);
+
+		bool importFromFile(FS *fileSystem, const String fileName);
+		bool exportToFile(FS *fileSystem, const String fileName);
+		bool clear();
 
 	private:
-		FS *fileSystem;
-		String fileName;
+		String nvsNamespace;
+		FS *backupFileSystem;
+		String backupFileName;
 		uint16_t configurationVersion;
+		uint8_t activeSlot;
+		uint32_t generation;
+		bool saveRequested;
+		unsigned long lastChange;
 
 		TesLight::Configuration::SystemConfig systemConfig;
 		TesLight::Configuration::LedConfig ledConfig[LED_NUM_ZONES];
 		TesLight::Configuration::WiFiConfig wifiConfig;
 		TesLight::Configuration::MotionSensorCalibration motionSensorCalibration;
 
+		bool readSlot(const uint8_t slot, uint32_t &generation, const bool apply);
+		bool writeSlot(const uint8_t slot, const uint32_t generation);
+		size_t getSlotSize();
+		bool createSlot(TesLight::InMemoryBinaryFile &binary, const uint32_t generation);
+		bool parseSlot(uint8_t *buffer, const size_t size, uint32_t &generation, const bool apply);
+		bool parseLegacy(uint8_t *buffer, const size_t size);
+
+		uint16_t getSerializedSize();
+		void serialize(TesLight::InMemoryBinaryFile &binary);
+		void deserialize(TesLight::InMemoryBinaryFile &binary);
+
 		uint16_t getSimpleHash();
 		uint16_t getSimpleStringHash(const String input);
 	};
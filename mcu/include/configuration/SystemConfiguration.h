@@ -9,6 +9,12 @@
 #ifndef SYSTEM_CONFIGURATION_H
 #define SYSTEM_CONFIGURATION_H
 
+// Boot configuration
+#define BOOT_TASK_STACK_SIZE 8192	 // Stack size of the background initialization task
+#define BOOT_TASK_PRIORITY 1		 // Priority of the background initialization task
+#define BOOT_TASK_CORE 0			 // Core of the background initialization task, the main loop runs on core 1
+#define BOOT_PROFILER_MAX_STAGES 24 // Maximum number of boot stages recorded by the boot profiler
+
 // SD configuration
 #define SD_CS_PIN 5			 // CS pin for the SD card
 #define SD_SPI_SPEED 4000000 // SPI data rate
@@ -19,9 +25,18 @@
 #define SERIAL_BAUD_RATE 460800			// Serial baud rate
 #define LOG_FILE_NAME "/system_log.txt" // File name of the log file
 #define LOG_DEFAULT_LEVEL 1 			// Default log level
+#define TELEMETRY_SECOND_SAMPLES 300	// Number of telemetry samples with a resolution of one second
+#define TELEMETRY_MINUTE_SAMPLES 240	// Number of telemetry samples with a resolution of one minute
+#define TELEMETRY_HOUR_SAMPLES 168		// Number of telemetry samples with a resolution of one hour
 
 // Configuration of the runtime configuration
-#define CONFIGURATION_FILE_NAME "/config.tli" // File name of the configuration file
+#define CONFIGURATION_NVS_NAMESPACE "teslight"				   // Namespace of the configuration in the non volatile storage
+#define CONFIGURATION_NVS_SLOT_KEYS {"config_a", "config_b"}   // Keys of the two configuration slots in the non volatile storage
+#define CONFIGURATION_BACKUP_FILE_NAME "/config_backup.tli"	   // File name of the configuration backup on the SD card
+#define CONFIGURATION_FILE_NAME "/config.tli"				   // File name of the legacy configuration file on the SD card
+#define CONFIGURATION_SLOT_HEADER_SIZE 8					   // Size of the header of a configuration slot
+#define CONFIGURATION_SLOT_MAX_SIZE 2048					   // Maximum size of a configuration slot
+#define CONFIGURATION_SAVE_DELAY 1000000					   // Time in µs without changes before the configuration is written
 
 // LED and animator configuration
 #define LED_NUM_ZONES 8 											// Number of LED zones
@@ -35,6 +50,7 @@
 #define ANIMATOR_DEFAULT_BRIGHTNESS 50 								// Default zone brightness
 #define ANIMATOR_DEFAULT_REVERSE false 								// Default reversal of the animation
 #define ANIMATOR_DEFAULT_FADE_SPEED 30 								// Default fading speed
+#define ANIMATOR_TRANSITION_TIME 500000								// Duration of the crossfade between animations in µs, 0 to disable
 
 // Voltage regulator
 #define REGULATOR_POWER_LIMIT 12																		// W per regulator
@@ -53,10 +69,22 @@
 #define FAN_PWM_MAX 255		 	// Maximum PWm value for the fan
 #define FAN_TEMP_MIN 60		 	// Minimum temperature where the fan starts
 #define FAN_TEMP_MAX 80		 	// Maximum temeprature where the fan runs at full speed
+#define FAN_CONTROL_KP 0.1f				// Proportional gain of the fan controller (fan speed per °C)
+#define FAN_CONTROL_KI 0.005f			// Integral gain of the fan controller (fan speed per °C and s)
+#define FAN_CONTROL_KD 0.05f			// Derivative gain of the fan controller (fan speed per °C/s)
+#define FAN_CONTROL_TEMP_MARGIN 8.0f	// Distance in °C to the regulator high temperature the fan controller aims for
+#define FAN_THERMAL_RESISTANCE 2.5f		// Temperature rise of the regulators in K per W of LED power
+#define FAN_THERMAL_TIME_CONSTANT 90.0f	// Thermal time constant of the regulators in s
+#define FAN_PREDICTION_HORIZON 30.0f	// Time in s the regulator temperature is predicted ahead
 
 // I2C configuration
 #define IIC_SDA_PIN 32 // SDA pin
 #define IIC_SCL_PIN 33 // SCL pin
+#define IIC_TIMEOUT 50 // Timeout for I²C transactions in ms
+#define IIC_BUS_TASK_STACK_SIZE 6144 // Stack size of the task owning the I²C bus
+#define IIC_BUS_TASK_PRIORITY 2		 // Priority of the task owning the I²C bus
+#define IIC_BUS_TASK_CORE 0			 // Core of the task owning the I²C bus, the main loop runs on core 1
+#define IIC_BUS_ERROR_DELAY 10000000 // Time in µs a device is not read after an error
 
 // OneWire configuration
 #define ONE_WIRE_PIN 26 // Pin of the OneWire bus
@@ -72,11 +100,31 @@
 #define LIGHT_SENSOR_ADC_PIN 35					// Physical pin for the analog voltage sensor
 #define IIC_ADDRESS_BH1750 0x23					// I²C Adress of the BH1750 brightness sensor
 
+// ADC configuration
+#define ADC_I2S_PORT 0				// I2S peripheral used to sample the ADC continuously
+#define ADC_SAMPLE_RATE 20000		// Sample rate of the continuous sampling in Hz
+#define ADC_DMA_BUFFER_COUNT 4		// Number of DMA buffers for the continuous sampling
+#define ADC_DMA_BUFFER_LENGTH 1024	// Number of samples per DMA buffer
+#define ADC_DMA_READ_SIZE 256		// Number of samples moved from the DMA buffers at once
+#define ADC_FILTER_WINDOW_SIZE 256	// Number of samples in the window of the mean filter
+
 // Motion sensor configuration
-#define IIC_ADDRESS_MPU6050 0x68 // I²C Adress of the MPU6050 motion sensor
+#define IIC_ADDRESS_MPU6050 0x68			  // I²C Adress of the MPU6050 motion sensor
+#define MOTION_SENSOR_FIFO_MODE true		  // Collect samples in the hardware FIFO of the MPU6050 at a fixed rate and read them in batches
+#define MOTION_SENSOR_SAMPLE_RATE_DIVIDER 9 // Sample rate divider for the FIFO mode, sample rate is 1kHz / (1 + divider)
+#define MOTION_SENSOR_FIFO_BATCH_SIZE 16	  // Maximum number of samples read from the FIFO in one cycle
+#define MOTION_SENSOR_INT_PIN -1			  // Pin connected to the data ready interrupt of the MPU6050, -1 when not connected
+#define MOTION_SENSOR_FILTER_BETA 0.033f	  // Gain of the Madgwick filter, higher values trust the accelerometer more than the gyro
+#define MOTION_SENSOR_GYRO_BIAS_RATE 0.002f // Rate at which the remaining gyro bias is learned while the car is standing still
+#define MOTION_SENSOR_HISTORY_SIZE 8		  // Number of timestamped motion samples kept to interpolate the motion to the LED frame time
+#define MOTION_SENSOR_INTERPOLATION_DELAY 30000 // Delay of the motion data in µs, so that the LED frames can be interpolated between two samples
+#define MOTION_SENSOR_MOUNTING_ROTATION {1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f} // Row major rotation matrix from the sensor frame into the vehicle frame
 
 // Temperature sensor
 #define TEMP_SENSOR_RESOLUTION 127	// Resolution register of the temperature sensors
+#define TEMP_SENSOR_REGULATOR_MAPPING {0, 1} // Map a sensor index to a regulator index, sensors without mapping belong to all regulators
+#define TEMP_SENSOR_CONVERSION_INTERVAL 250000 // Time in µs after all sensors were read until the next conversion is started
+#define TEMP_SENSOR_ERROR_DELAY 5000000 // Time in µs until the OneWire bus is used again after an error
 
 // WiFi configuration
 #define AP_DEFAULT_SSID "TesLight"		 // Default SSID of the access point
@@ -96,15 +144,49 @@
 #define TEMP_CYCLE_TIME 250000		   // Cycle time for reading temperatures and run fan controll in µs
 #define LIGHT_SENSOR_CYCLE_TIME 40000  // Cycle time for the light sensor in µs
 #define MOTION_SENSOR_CYCLE_TIME 20000 // Cycle time for the motion sensor in µs
+#define SENSOR_RECORDER_CYCLE_TIME 250000 // Cycle time for writing sensor recordings and reading replays in µs
 #define WEB_SERVER_CYCLE_TIME 20000	   // Cycle time for the web server to accept conenctions in µs
 #define STATUS_CYCLE_TIME 5000000	   // Cycle time for printing the current status in µs
+#define TELEMETRY_CYCLE_TIME 1000000   // Cycle time for collecting the telemetry in µs, must be one second
 #define WATCHDOG_RESET_TIME 5		   // Time until a watchdog reset is triggered
 
 // FSEQ configuration
-#define FSEQ_DIRECTORY "/fseq" // Directory for fseq files
+#define FSEQ_DIRECTORY "/fseq"			// Directory for fseq files
+#define FSEQ_INDEX_FILE_NAME "/fseq.idx" // File name of the fseq index
+#define FSEQ_INDEX_VERSION 2			// Version of the fseq index file
+#define FSEQ_INDEX_INITIAL_CAPACITY 16	// Initial number of entries the fseq index can hold before it grows
+#define FSEQ_UPLOAD_BUFFER_SIZE 16384	// Size of the write buffer for fseq uploads, must be a multiple of the SD sector size
+
+// Realtime streaming configuration
+#define STREAM_DDP_PORT 4048			// UDP port for DDP packets
+#define STREAM_E131_PORT 5568			// UDP port for E1.31 (sACN) packets
+#define STREAM_E131_UNIVERSE 1			// First E1.31 universe, following universes are mapped to the next channels
+#define STREAM_E131_UNIVERSE_SIZE 510	// Number of channels per E1.31 universe
+#define STREAM_DDP_PACKET_PAYLOAD 1440	// Typical number of channels per DDP packet, limits the packets handled per call
+#define STREAM_JITTER_BUFFER_FRAMES 3	// Number of frames the jitter buffer can hold
+#define STREAM_PACKET_BUFFER_SIZE 1472	// Maximum size of a single UDP packet
+#define STREAM_TIMEOUT 2000000			// Time in µs without packets after which the LEDs are turned off
+
+// Upload session configuration
+#define UPLOAD_SESSION_DIRECTORY "/upload"		// Directory for the data of unfinished uploads
+#define UPLOAD_SESSION_MAX_CHUNK_SIZE 32768		// Maximum size of a single chunk of an upload session
+#define UPLOAD_SESSION_CRC_BUFFER_SIZE 1024		// Size of the buffer used to calculate the checksum of received data
+
+// Sensor recording configuration
+#define SENSOR_RECORDING_DIRECTORY "/recordings"	// Directory for sensor recordings
+#define SENSOR_RECORDER_BUFFER_SIZE 256			// Number of records buffered in memory before they are written to the MicroSD card
+#define SENSOR_RECORDER_MAX_DURATION 3600000000	// Maximum duration of a recording in µs
+#define SENSOR_REPLAY_MOTION_BUFFER_SIZE 64		// Number of motion records the replay can buffer for the motion sensor
+#define SENSOR_REPLAY_MAX_TEMPERATURES 8		// Maximum number of temperature sensors in a replay
 
 // Update configuration
 #define UPDATE_DIRECTORY "/update"	  // Update folder
 #define UPDATE_FILE_NAME "update.tup" // Update package file name
+#define UPDATE_STAGING_DIRECTORY "/update/staging" // Directory to which the files are unpacked before they replace the old files
+#define UPDATE_BUFFER_SIZE 16384	  // Size of the buffer used to install the firmware and unpack files
+#define UPDATE_TUP_VERSION 3		  // Supported version of the TUP file format
+#define UPDATE_TUP_MAX_CHUNK_SIZE 65536 // Maximum size of a single data chunk inside a TUP file
+#define UPDATE_TUP_WINDOW_SIZE 4096	  // Size of the LZSS window used to decompress TUP data chunks, must match the packaging tool
+#define UPDATE_TUP_INPUT_BUFFER_SIZE 512 // Size of the buffer for compressed data while decompressing TUP data chunks
 
 #endif
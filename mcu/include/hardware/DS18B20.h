@@ -37,6 +37,7 @@ namespace TesLight
 		bool setResolution(const uint8_t sensorIndex, const TesLight::DS18B20::DS18B20Res resolution);
 		bool getResolution(const uint8_t sensorIndex, TesLight::DS18B20::DS18B20Res &resolution);
 
+		bool startMeasurement();
 		bool startMeasurement(const uint8_t sensorIndex);
 		bool isMeasurementReady(const uint8_t sensorIndex);
 		bool getTemperature(const uint8_t sensorIndex, float &temp);
@@ -50,6 +51,7 @@ namespace TesLight
 		unsigned long *measurementReadyTime;
 
 		bool getSensors(uint8_t &sensorCount, uint64_t sensorAddresses[], const uint8_t bufferSize);
+		unsigned long getConversionTime(const TesLight::DS18B20::DS18B20Res resolution);
 	};
 }
 
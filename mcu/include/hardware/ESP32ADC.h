@@ -10,6 +10,9 @@
 #define ESP32ADC_H
 
 #include <Arduino.h>
+#include <driver/adc.h>
+#include <driver/i2s.h>
+#include "configuration/SystemConfiguration.h"
 #include "logging/Logger.h"
 
 namespace TesLight
@@ -31,6 +34,10 @@ namespace TesLight
 		void setMaxVoltage(const float maxVoltage);
 		float getMaxVoltage();
 
+		bool startContinuous();
+		void stopContinuous();
+		bool isContinuous();
+
 		uint16_t getAnalogValue();
 		float getAnalogVoltage(const bool usePolynomialCorrection = true);
 
@@ -38,8 +45,17 @@ namespace TesLight
 		uint8_t inputPin;
 		uint8_t inputMode;
 		float maxVoltage;
+		bool continuous;
+		uint16_t *window;
+		uint16_t windowIndex;
+		uint16_t windowCount;
+		uint32_t windowSum;
+
+		static uint16_t *calibrationTable;
 
 		void setupPin();
+		void readContinuous();
+		static void createCalibrationTable();
 	};
 }
 
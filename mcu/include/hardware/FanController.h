@@ -13,6 +13,8 @@
 #include "configuration/SystemConfiguration.h"
 #include "configuration/Configuration.h"
 #include "logging/Logger.h"
+#include "util/ThermalModel.h"
+#include "util/PidController.h"
 
 namespace TesLight
 {
@@ -22,11 +24,18 @@ namespace TesLight
 		FanController(const uint8_t fanPin, TesLight::Configuration *configuration);
 		~FanController();
 
-		void setTemperature(const uint8_t temp);
+		void update(const float temperature, const float power);
+		float getPredictedTemperature();
+		uint8_t getPwm();
 
 	private:
 		uint8_t fanPin;
 		TesLight::Configuration *configuration;
+		TesLight::ThermalModel *thermalModel;
+		TesLight::PidController *pidController;
+		unsigned long lastUpdate;
+		float predictedTemperature;
+		uint8_t pwm;
 	};
 }
 
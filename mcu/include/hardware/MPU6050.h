@@ -70,13 +70,25 @@ namespace TesLight
 
 		bool getData(TesLight::MPU6050::MPU6050MotionData &motionData);
 
+		bool enableFifo(const uint8_t sampleRateDivider);
+		bool disableFifo();
+		bool resetFifo();
+		bool setDataReadyInterrupt(const bool enabled);
+		bool getFifoData(TesLight::MPU6050::MPU6050MotionData *motionData, const uint16_t maxCount, uint16_t &count);
+
+		static float getScaleDiv(const TesLight::MPU6050::MPU6050AccScale accScale);
+		static float getScaleDiv(const TesLight::MPU6050::MPU6050GyScale gyScale);
+
 	private:
 		uint8_t deviceAddress;
 		TesLight::MPU6050::MPU6050AccScale accScale;
 		TesLight::MPU6050::MPU6050GyScale gyScale;
+		float accScaleInv;
+		float gyScaleInv;
 
-		float getScaleDiv(const TesLight::MPU6050::MPU6050AccScale accScale);
-		float getScaleDiv(const TesLight::MPU6050::MPU6050GyScale gyScale);
+		bool writeRegister(const uint8_t reg, const uint8_t value);
+		bool readRegisters(const uint8_t reg, uint8_t *buffer, const uint8_t length);
+		void convertSample(const uint8_t *buffer, TesLight::MPU6050::MPU6050MotionData &motionData);
 	};
 }
 
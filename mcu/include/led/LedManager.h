@@ -16,6 +16,7 @@
 
 #include "logging/Logger.h"
 #include "util/FileUtil.h"
+#include "util/FseqIndex.h"
 #include "FastLED.h"
 
 #include "led/animator/RainbowAnimator.h"
@@ -25,6 +26,7 @@
 #include "led/animator/ColorBarAnimator.h"
 #include "led/animator/RainbowAnimatorMotion.h"
 #include "led/animator/GradientAnimatorMotion.h"
+#include "led/animator/StreamAnimator.h"
 
 #include "sensor/MotionSensor.h"
 
@@ -33,10 +35,11 @@ namespace TesLight
 	class LedManager
 	{
 	public:
-		LedManager(TesLight::Configuration *config);
+		LedManager(TesLight::Configuration *config, TesLight::FseqIndex *fseqIndex);
 		~LedManager();
 
 		bool reloadAnimations();
+		bool updateAnimations();
 		void clearAnimations();
 
 		void setAmbientBrightness(const float ambientBrightness);
@@ -45,35 +48,75 @@ namespace TesLight
 		void setTargetFrameTime(const uint32_t targetFrameTime);
 		uint32_t getTargetFrameTime();
 
-		void setMotionSensorData(const TesLight::MotionSensor::MotionSensorData motionSensorData);
-		bool getMotionSensorData(TesLight::MotionSensor::MotionSensorData &motionSensorData);
+		void setTransitionTime(const uint32_t transitionTime);
+		uint32_t getTransitionTime();
 
-		void setRegulatorTemperature(const float regulatorTemperature);
-		float getRegulatorTemperature();
+		void updateMotionSensorData(TesLight::MotionSensor *motionSensor);
+		TesLight::MotionSensor::MotionSensorData getMotionSensorData();
+
+		void setRegulatorTemperature(const uint8_t regulatorIndex, const float regulatorTemperature);
+		float getRegulatorTemperature(const uint8_t regulatorIndex);
 
 		float getLedPowerDraw();
+		float getRegulatorPowerDraw(const uint8_t regulatorIndex);
+		bool isRegulatorLimited(const uint8_t regulatorIndex);
+
+		void receiveStream();
 
 		bool render();
 		void show();
 
 	private:
 		TesLight::Configuration *config;
+		TesLight::FseqIndex *fseqIndex;
 
 		CRGB *ledData[LED_NUM_ZONES];
 		TesLight::LedAnimator *ledAnimator[LED_NUM_ZONES];
 		TesLight::FseqLoader *fseqLoader = nullptr;
+		TesLight::StreamReceiver *streamReceiver = nullptr;
 		uint32_t targetFrameTime;
 
-		float regulatorTemperature;
+		TesLight::LedAnimator *previousAnimator[LED_NUM_ZONES];
+		CRGB *transitionData[LED_NUM_ZONES];
+		unsigned long transitionStart[LED_NUM_ZONES];
+		TesLight::FseqLoader *previousFseqLoader = nullptr;
+		TesLight::StreamReceiver *previousStreamReceiver = nullptr;
+		uint32_t transitionTime;
+
+		TesLight::Configuration::LedConfig appliedLedConfig[LED_NUM_ZONES];
+		bool appliedLedConfigValid;
+		uint16_t zonePowerCoefficient[LED_NUM_ZONES][3];
+		uint8_t zoneRegulator[LED_NUM_ZONES];
+
+		float regulatorTemperature[REGULATOR_COUNT];
+		float framePower[REGULATOR_COUNT];
+		bool frameLimited[REGULATOR_COUNT];
+
+		TesLight::MotionSensor::MotionSensorData motionSensorData;
+		unsigned long renderStart;
+		unsigned long frameDuration;
 
 		bool createLedData();
 		bool createAnimators();
 		bool loadCalculatedAnimations();
+		TesLight::LedAnimator *createCalculatedAnimator(const TesLight::Configuration::LedConfig &ledConfig);
 		bool loadCustomAnimation();
+		bool loadStreamAnimation();
+
+		bool isReloadRequired();
+		bool isLayoutChanged();
+		void applyAnimatorSettings(const uint8_t index, const TesLight::Configuration::LedConfig &ledConfig);
+		void applyAnimatorColor(const uint8_t index, const TesLight::Configuration::LedConfig &ledConfig);
+
+		void beginTransition();
+		void startZoneTransition(const uint8_t index);
+		void renderZoneTransition(const uint8_t index);
+		void endZoneTransition(const uint8_t index);
+		void finishTransitions();
 
+		void updatePowerCoefficients(const uint8_t index, const TesLight::Configuration::LedConfig &ledConfig);
 		bool calculateRegulatorPowerDraw(float regulatorPower[REGULATOR_COUNT]);
-		bool limitPowerConsumption();
-		bool limitRegulatorTemperature();
+		bool limitRegulatorPower();
 
 		uint8_t getRegulatorIndexFromPin(const uint8_t pin);
 	};
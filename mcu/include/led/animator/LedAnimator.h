@@ -47,8 +47,8 @@ namespace TesLight
 		void setReverse(const bool reverse);
 		bool getReverse();
 
-		void setMotionSensorData(const TesLight::MotionSensor::MotionSensorData motionSensorData);
-		TesLight::MotionSensor::MotionSensorData getMotionSensorData();
+		void setMotionSensorData(const TesLight::MotionSensor::MotionSensorData *motionSensorData);
+		const TesLight::MotionSensor::MotionSensorData *getMotionSensorData();
 
 		virtual void init() = 0;
 		virtual void render() = 0;
@@ -65,7 +65,7 @@ namespace TesLight
 		float fadeSpeed;
 		bool reverse;
 
-		TesLight::MotionSensor::MotionSensorData motionSensorData;
+		const TesLight::MotionSensor::MotionSensorData *motionSensorData;
 
 		void applyBrightness();
 		static float trapezoid(float angle);
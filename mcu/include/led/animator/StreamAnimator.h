@@ -0,0 +1,36 @@
+/**
+ * @file StreamAnimator.h
+ * @author TheRealKasumi
+ * @brief Contains a class to render realtime LED data received over the network.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef STREAM_ANIMATOR_H
+#define STREAM_ANIMATOR_H
+
+#include "led/animator/LedAnimator.h"
+#include "util/StreamReceiver.h"
+
+namespace TesLight
+{
+	class StreamAnimator : public LedAnimator
+	{
+	public:
+		StreamAnimator();
+		StreamAnimator(TesLight::StreamReceiver *streamReceiver, const uint32_t channelOffset);
+		~StreamAnimator();
+
+		void setStreamReceiver(TesLight::StreamReceiver *streamReceiver);
+		void setChannelOffset(const uint32_t channelOffset);
+
+		void init();
+		void render();
+
+	private:
+		TesLight::StreamReceiver *streamReceiver;
+		uint32_t channelOffset;
+	};
+}
+
+#endif
@@ -11,6 +11,7 @@
 
 #include <Arduino.h>
 #include <FS.h>
+#include <freertos/semphr.h>
 
 #define SOURCE_LOCATION __FILE__, __func__, __LINE__
 
@@ -47,9 +48,11 @@ namespace TesLight
 		static FS *fileSystem;
 		static String fileName;
 		static TesLight::Logger::LogLevel minLogLevel;
+		static SemaphoreHandle_t mutex;
 
 		Logger(){};
 
+		static void createMutex();
 		static bool testOpenFile(FS *fs, const String fn);
 		static String getLogLevelString(const TesLight::Logger::LogLevel logLevel);
 		static String getTimeString();
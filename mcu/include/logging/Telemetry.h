@@ -0,0 +1,80 @@
+/**
+ * @file Telemetry.h
+ * @author TheRealKasumi
+ * @brief Contains a class to keep a history of the power draw, temperatures and LED performance.
+ * The history is stored in fixed size ring buffers with a resolution of one second, one minute and one hour.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "configuration/SystemConfiguration.h"
+
+namespace TesLight
+{
+	class Telemetry
+	{
+	public:
+		enum Resolution
+		{
+			SECOND = 0,
+			MINUTE = 1,
+			HOUR = 2
+		};
+
+		struct __attribute__((packed)) Sample
+		{
+			uint16_t power[REGULATOR_COUNT];	 // Average power draw per regulator in W x100
+			int16_t temperature[REGULATOR_COUNT]; // Maximum temperature per regulator in °C x10
+			uint8_t limited[REGULATOR_COUNT];	 // Percentage of frames in which the regulator limited the brightness
+			uint8_t fanPwm;						 // Average pwm value of the fan
+			uint8_t fps;						 // Average frames per second
+		};
+
+		static void addFrame(const float power[REGULATOR_COUNT], const bool limited[REGULATOR_COUNT]);
+		static void update(const float temperature[REGULATOR_COUNT], const uint8_t fanPwm);
+
+		static uint16_t getSampleCount(const TesLight::Telemetry::Resolution resolution);
+		static bool getSample(const TesLight::Telemetry::Resolution resolution, const uint16_t index, TesLight::Telemetry::Sample &sample);
+
+	private:
+		Telemetry();
+
+		struct Ring
+		{
+			TesLight::Telemetry::Sample *samples;
+			uint16_t size;
+			uint16_t newest;
+			uint16_t count;
+		};
+
+		struct Accumulator
+		{
+			float power[REGULATOR_COUNT];
+			float temperature[REGULATOR_COUNT];
+			float limited[REGULATOR_COUNT];
+			float fanPwm;
+			float fps;
+			uint8_t count;
+		};
+
+		static TesLight::Telemetry::Sample secondSamples[TELEMETRY_SECOND_SAMPLES];
+		static TesLight::Telemetry::Sample minuteSamples[TELEMETRY_MINUTE_SAMPLES];
+		static TesLight::Telemetry::Sample hourSamples[TELEMETRY_HOUR_SAMPLES];
+		static TesLight::Telemetry::Ring rings[3];
+		static TesLight::Telemetry::Accumulator accumulators[2];
+
+		static float framePower[REGULATOR_COUNT];
+		static uint16_t frameLimited[REGULATOR_COUNT];
+		static uint16_t frameCount;
+
+		static void addSample(const TesLight::Telemetry::Resolution resolution, const TesLight::Telemetry::Sample &sample);
+	};
+}
+
+#endif
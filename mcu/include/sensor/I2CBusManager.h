@@ -0,0 +1,46 @@
+/**
+ * @file I2CBusManager.h
+ * @author TheRealKasumi
+ * @brief Contains a class running a task that owns the I²C bus and reads all I²C sensors at their own rates.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef I2C_BUS_MANAGER_H
+#define I2C_BUS_MANAGER_H
+
+#include <stdint.h>
+#include <Arduino.h>
+#include <freertos/task.h>
+
+#include "configuration/SystemConfiguration.h"
+#include "logging/Logger.h"
+#include "sensor/LightSensor.h"
+#include "sensor/MotionSensor.h"
+
+namespace TesLight
+{
+	class I2CBusManager
+	{
+	public:
+		I2CBusManager(TesLight::MotionSensor *motionSensor, TesLight::LightSensor *lightSensor);
+		~I2CBusManager();
+
+		bool begin();
+		void end();
+
+	private:
+		TesLight::MotionSensor *motionSensor;
+		TesLight::LightSensor *lightSensor;
+		TaskHandle_t taskHandle;
+		volatile bool running;
+		unsigned long motionSensorTimer;
+		unsigned long lightSensorTimer;
+
+		static void task(void *parameter);
+		void run();
+		bool checkTimer(unsigned long &timer, const unsigned long cycleTime);
+	};
+}
+
+#endif
@@ -18,6 +18,9 @@
 #include "logging/Logger.h"
 
 #include "sensor/MotionSensor.h"
+#include "sensor/SensorRecorder.h"
+#include "sensor/SensorReplay.h"
+#include "util/SeqLock.h"
 
 namespace TesLight
 {
@@ -39,13 +42,24 @@ namespace TesLight
 		~LightSensor();
 
 		bool getBrightness(float &brightness, TesLight::MotionSensor *motionSensor = nullptr);
+		bool updateBh1750();
 
 	private:
+		struct Bh1750Sample
+		{
+			float lux;
+			bool valid;
+		};
+
 		TesLight::Configuration *configuration;
 		TesLight::ESP32ADC *esp32adc;
+		bool adcMode;
 		TesLight::BH1750 *bh1750;
+		TesLight::SeqLock<TesLight::LightSensor::Bh1750Sample> bh1750Sample;
 		TesLight::MotionSensor::MotionSensorData motionData;
 		unsigned long motionSensorTriggerTime;
+
+		void updateAdcMode(const TesLight::LightSensor::LightSensorMode lightSensorMode);
 	};
 }
 
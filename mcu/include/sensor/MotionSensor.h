@@ -10,11 +10,16 @@
 #define MOTION_SENSOR_H
 
 #include <stdint.h>
+#include <Arduino.h>
 
 #include "configuration/SystemConfiguration.h"
 #include "configuration/Configuration.h"
 #include "hardware/MPU6050.h"
 #include "logging/Logger.h"
+#include "sensor/SensorRecorder.h"
+#include "sensor/SensorReplay.h"
+#include "util/MadgwickFilter.h"
+#include "util/SeqLock.h"
 
 namespace TesLight
 {
@@ -67,19 +72,50 @@ namespace TesLight
 			float temperatureDeg;
 		};
 
+		struct MotionHistory
+		{
+			TesLight::MotionSensor::MotionSensorData data[MOTION_SENSOR_HISTORY_SIZE];
+			unsigned long timestamp[MOTION_SENSOR_HISTORY_SIZE];
+			uint8_t newest;
+			uint8_t count;
+		};
+
 		MotionSensor(const uint8_t sensorAddress, TesLight::Configuration *configuration);
 		~MotionSensor();
 
 		bool begin();
 		bool run();
-		uint8_t calibrate(const bool failOnTemperature);
+		bool startCalibration(const bool failOnTemperature);
+		uint8_t getCalibrationState();
+		bool getFinishedCalibration(TesLight::Configuration::MotionSensorCalibration &calibration);
+		void setCalibration(const TesLight::Configuration::MotionSensorCalibration calibration);
 		TesLight::MotionSensor::MotionSensorData getMotion();
+		void getMotion(const unsigned long time, TesLight::MotionSensor::MotionSensorData &motionData);
 
 	private:
 		TesLight::MPU6050 *mpu6050;
-		TesLight::Configuration *configuration;
 		TesLight::MotionSensor::MotionSensorData motionData;
+		TesLight::MotionSensor::MotionHistory history;
+		TesLight::SeqLock<TesLight::MotionSensor::MotionHistory> motionHistory;
+		volatile bool calibrationRequested;
+		volatile bool calibrationFailOnTemperature;
+		volatile uint8_t calibrationState;
+		volatile bool calibrationFinished;
+		TesLight::SeqLock<TesLight::Configuration::MotionSensorCalibration> calibration;
+		TesLight::SeqLock<TesLight::Configuration::MotionSensorCalibration> calibrationResult;
+		TesLight::MPU6050::MPU6050MotionData *fifoBuffer;
+		TesLight::MadgwickFilter *filter;
 		unsigned long lastMeasure;
+
+		static volatile bool dataReady;
+		static void IRAM_ATTR dataReadyIsr();
+
+		bool measure();
+		uint8_t runCalibration(const bool failOnTemperature);
+		void processSample(const TesLight::MPU6050::MPU6050MotionData &sensorData, const float timeScale, const unsigned long timestamp);
+		static void interpolate(const TesLight::MotionSensor::MotionSensorData &older, const TesLight::MotionSensor::MotionSensorData &newer, const float factor, TesLight::MotionSensor::MotionSensorData &motionData);
+		static float interpolateAngle(const float older, const float newer, const float factor);
+		static void rotateToVehicle(float &x, float &y, float &z);
 	};
 }
 
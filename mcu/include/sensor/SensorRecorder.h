@@ -0,0 +1,63 @@
+/**
+ * @file SensorRecorder.h
+ * @author TheRealKasumi
+ * @brief Contains a static class to record the motion, light and temperature sensor data to the MicroSD card.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef SENSOR_RECORDER_H
+#define SENSOR_RECORDER_H
+
+#include <stdint.h>
+#include <Arduino.h>
+#include <FS.h>
+
+#include "configuration/SystemConfiguration.h"
+#include "hardware/MPU6050.h"
+#include "logging/Logger.h"
+#include "sensor/SensorRecording.h"
+
+namespace TesLight
+{
+	class SensorRecorder
+	{
+	public:
+		static void begin(FS *_fileSystem);
+		static void setMotionScale(const TesLight::MPU6050::MPU6050AccScale accScale, const TesLight::MPU6050::MPU6050GyScale gyScale);
+
+		static bool start(const String fileName);
+		static void stop();
+		static bool isRecording();
+		static uint32_t getRecordCount();
+		static uint32_t getDroppedCount();
+
+		static void recordMotion(const TesLight::MPU6050::MPU6050MotionData &motionData, const unsigned long timestamp);
+		static void recordLight(const float lux);
+		static void recordTemperature(const uint8_t sensorIndex, const float temperature);
+
+		static bool flush();
+
+	private:
+		SensorRecorder();
+
+		static FS *fileSystem;
+		static File file;
+		static volatile bool recording;
+		static unsigned long startTime;
+		static uint8_t accScale;
+		static uint8_t gyScale;
+		static TesLight::SensorRecording::Record *buffer;
+		static TesLight::SensorRecording::Record *writeBuffer;
+		static uint16_t bufferCount;
+		static uint32_t recordCount;
+		static uint32_t droppedCount;
+		static portMUX_TYPE lock;
+
+		static void addRecord(const uint8_t type, const uint8_t index, const unsigned long timestamp, const void *data, const uint8_t length);
+		static bool writeRecords();
+		static void freeBuffers();
+	};
+}
+
+#endif
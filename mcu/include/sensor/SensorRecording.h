@@ -0,0 +1,53 @@
+/**
+ * @file SensorRecording.h
+ * @author TheRealKasumi
+ * @brief Contains the binary format of sensor recordings. It has no dependencies to the hardware,
+ * so recordings can also be read on a host by the sensor replay tool.
+ *
+ * A recording starts with a {@link TesLight::SensorRecording::FileHeader} followed by a list of
+ * {@link TesLight::SensorRecording::Record} with a fixed size, ordered by their timestamp.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef SENSOR_RECORDING_H
+#define SENSOR_RECORDING_H
+
+#include <stdint.h>
+
+#define SENSOR_RECORDING_VERSION 1 // Version of the recording format
+
+namespace TesLight
+{
+	class SensorRecording
+	{
+	public:
+		enum RecordType : uint8_t
+		{
+			MOTION = 0,		 // data contains the raw acc x, y, z, gyro x, y, z and temperature values of the MPU6050
+			LIGHT = 1,		 // data contains the brightness of the BH1750 in lux as float
+			TEMPERATURE = 2 // data contains the temperature of the DS18B20 with the given index in °C as float
+		};
+
+		struct FileHeader
+		{
+			char magic[4];	  // "TLSR"
+			uint8_t version;  // SENSOR_RECORDING_VERSION
+			uint8_t accScale; // acc scale register value of the MPU6050
+			uint8_t gyScale;  // gyro scale register value of the MPU6050
+		} __attribute__((packed));
+
+		struct Record
+		{
+			uint8_t type;		// type of the record
+			uint8_t index;		// index of the sensor
+			uint32_t timestamp; // time since the start of the recording in µs
+			int16_t data[7];	// data, depending on the type of the record
+		} __attribute__((packed));
+
+	private:
+		SensorRecording();
+	};
+}
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * @file SensorReplay.h
+ * @author TheRealKasumi
+ * @brief Contains a static class to replay a sensor recording. While a replay is running, the recorded values
+ * replace the values of the MPU6050 and BH1750 sensors. Recorded DS18B20 temperatures can only raise the measured ones,
+ * so the thermal protection keeps working.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef SENSOR_REPLAY_H
+#define SENSOR_REPLAY_H
+
+#include <stdint.h>
+#include <Arduino.h>
+#include <FS.h>
+
+#include "configuration/SystemConfiguration.h"
+#include "hardware/MPU6050.h"
+#include "logging/Logger.h"
+#include "sensor/SensorRecording.h"
+
+namespace TesLight
+{
+	class SensorReplay
+	{
+	public:
+		static void begin(FS *_fileSystem);
+
+		static bool start(const String fileName);
+		static void stop();
+		static bool isActive();
+
+		static bool update();
+
+		static bool getMotionData(TesLight::MPU6050::MPU6050MotionData &motionData, float &timeStep, unsigned long &timestamp);
+		static bool getLight(float &lux);
+		static bool getTemperature(const uint8_t sensorIndex, float &temperature);
+
+	private:
+		SensorReplay();
+
+		static FS *fileSystem;
+		static File file;
+		static volatile bool active;
+		static unsigned long startTime;
+		static float accScaleInv;
+		static float gyScaleInv;
+		static TesLight::SensorRecording::Record pendingRecord;
+		static bool hasPendingRecord;
+		static TesLight::SensorRecording::Record *motionBuffer;
+		static uint16_t motionHead;
+		static uint16_t motionCount;
+		static uint32_t lastMotionTimestamp;
+		static bool hasMotionTimestamp;
+		static float lux;
+		static bool luxValid;
+		static float temperature[SENSOR_REPLAY_MAX_TEMPERATURES];
+		static bool temperatureValid[SENSOR_REPLAY_MAX_TEMPERATURES];
+		static portMUX_TYPE lock;
+
+		static bool applyRecord(const TesLight::SensorRecording::Record &record);
+	};
+}
+
+#endif
@@ -13,6 +13,8 @@
 #include "configuration/SystemConfiguration.h"
 #include "hardware/DS18B20.h"
 #include "logging/Logger.h"
+#include "sensor/SensorRecorder.h"
+#include "sensor/SensorReplay.h"
 
 namespace TesLight
 {
@@ -23,12 +25,28 @@ namespace TesLight
 		~TemperatureSensor();
 
 		uint8_t getNumSensors();
+		bool run();
 		bool getMinTemperature(float &temp);
 		bool getMaxTemperature(float &temp);
 		bool getAverageTemperature(float &temp);
+		bool getRegulatorTemperature(const uint8_t regulatorIndex, float &temp);
 
 	private:
+		enum BusState
+		{
+			START_CONVERSION,
+			READ_SENSOR
+		};
+
 		TesLight::DS18B20 *ds18b20;
+		TesLight::TemperatureSensor::BusState busState;
+		uint8_t sensorIndex;
+		unsigned long nextStepTime;
+		float *temperature;
+		bool *temperatureValid;
+
+		bool readTemperature(const uint8_t sensorIndex, float &temp);
+		static bool isSensorOfRegulator(const uint8_t sensorIndex, const uint8_t regulatorIndex);
 	};
 }
 
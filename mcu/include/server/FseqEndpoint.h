@@ -17,28 +17,38 @@
 #include "logging/Logger.h"
 #include "util/FileUtil.h"
 #include "util/FseqLoader.h"
+#include "util/FseqIndex.h"
 
 namespace TesLight
 {
 	class FseqEndpoint : public RestEndpoint
 	{
 	public:
-		static void begin(FS *_fileSystem, TesLight::Configuration *_configuration);
+		static void begin(FS *_fileSystem, TesLight::Configuration *_configuration, TesLight::FseqIndex *_fseqIndex);
+		static bool verifyFileName(const String fileName);
 
 	private:
 		FseqEndpoint();
 
 		static FS *fileSystem;
 		static TesLight::Configuration *configuration;
+		static TesLight::FseqIndex *fseqIndex;
 		static File uploadFile;
+		static uint8_t *uploadBuffer;
+		static size_t uploadBufferFill;
+		static uint32_t uploadBytesReceived;
+		static uint32_t uploadExpectedSize;
+		static bool uploadHeaderVerified;
+		static bool uploadFailed;
 
 		static void getFseqList();
 		static void postFseq();
 		static void fseqUpload();
 		static void deleteFseq();
 
-		static bool verifyFileName(const String fileName);
-		static bool verifyFseqFile(const String fileName);
+		static bool verifyFseqHeader(const uint8_t *header, uint32_t &expectedSize);
+		static bool flushUploadBuffer();
+		static void failUpload(const int code, const String message, const bool removeFile);
 	};
 }
 
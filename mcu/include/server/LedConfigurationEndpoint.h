@@ -32,6 +32,10 @@ namespace TesLight
 
 		static void getLedConfig();
 		static void postLedConfig();
+		static void patchLedConfig();
+
+		static void readLedConfig(TesLight::InMemoryBinaryFile &binary, TesLight::Configuration::LedConfig &ledConfig);
+		static bool saveAndApply();
 
 		static bool validateLedPin(const int ledPin);
 		static bool validateLedCount(const int ledCount);
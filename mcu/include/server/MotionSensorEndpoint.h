@@ -32,6 +32,7 @@ namespace TesLight
 		static void getCalibrationData();
 		static void postCalibrationData();
 		static void runCalibration();
+		static void getCalibrationState();
 	};
 }
 
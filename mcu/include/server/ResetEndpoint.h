@@ -10,6 +10,7 @@
 #define RESET_ENDPOINT_H
 
 #include "configuration/SystemConfiguration.h"
+#include "configuration/Configuration.h"
 #include "server/RestEndpoint.h"
 #include "logging/Logger.h"
 #include "update/Updater.h"
@@ -19,12 +20,12 @@ namespace TesLight
 	class ResetEndpoint : public RestEndpoint
 	{
 	public:
-		static void begin(FS *_fileSystem);
+		static void begin(TesLight::Configuration *_configuration);
 
 	private:
 		ResetEndpoint();
 
-		static FS *fileSystem;
+		static TesLight::Configuration *configuration;
 
 		static void handleSoftReset();
 		static void handleHardReset();
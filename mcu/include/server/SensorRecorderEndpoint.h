@@ -0,0 +1,39 @@
+/**
+ * @file SensorRecorderEndpoint.h
+ * @author TheRealKasumi
+ * @brief Contains a REST endpoint to record and replay the sensor data.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef SENSOR_RECORDER_ENDPOINT_H
+#define SENSOR_RECORDER_ENDPOINT_H
+
+#include "server/RestEndpoint.h"
+#include "configuration/SystemConfiguration.h"
+#include "util/InMemoryBinaryFile.h"
+#include "logging/Logger.h"
+#include "sensor/SensorRecorder.h"
+#include "sensor/SensorReplay.h"
+
+namespace TesLight
+{
+	class SensorRecorderEndpoint : public RestEndpoint
+	{
+	public:
+		static void begin();
+
+	private:
+		SensorRecorderEndpoint();
+
+		static void getStatus();
+		static void startRecording();
+		static void stopRecording();
+		static void startReplay();
+		static void stopReplay();
+
+		static bool verifyFileName(const String fileName);
+	};
+}
+
+#endif
@@ -0,0 +1,32 @@
+/**
+ * @file TelemetryEndpoint.h
+ * @author TheRealKasumi
+ * @brief Contains a REST endpoint to read the telemetry history.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef TELEMETRY_ENDPOINT_H
+#define TELEMETRY_ENDPOINT_H
+
+#include "server/RestEndpoint.h"
+#include "configuration/SystemConfiguration.h"
+#include "util/InMemoryBinaryFile.h"
+#include "logging/Logger.h"
+#include "logging/Telemetry.h"
+
+namespace TesLight
+{
+	class TelemetryEndpoint : public RestEndpoint
+	{
+	public:
+		static void begin();
+
+	private:
+		TelemetryEndpoint();
+
+		static void getTelemetry();
+	};
+}
+
+#endif
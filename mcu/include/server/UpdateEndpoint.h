@@ -12,6 +12,7 @@
 #include <FS.h>
 
 #include "configuration/SystemConfiguration.h"
+#include "configuration/Configuration.h"
 #include "server/RestEndpoint.h"
 #include "logging/Logger.h"
 #include "util/FileUtil.h"
@@ -22,12 +23,13 @@ namespace TesLight
 	class UpdateEndpoint : public RestEndpoint
 	{
 	public:
-		static void begin(FS *_fileSystem);
+		static void begin(FS *_fileSystem, TesLight::Configuration *_configuration);
 
 	private:
 		UpdateEndpoint();
 
 		static FS *fileSystem;
+		static TesLight::Configuration *configuration;
 		static File uploadFile;
 
 		static void postPackage();
@@ -0,0 +1,76 @@
+/**
+ * @file UploadSessionEndpoint.h
+ * @author TheRealKasumi
+ * @brief Contains a REST endpoint for resumable uploads of fseq files and update packages in multiple chunks.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef UPLOAD_SESSION_ENDPOINT_H
+#define UPLOAD_SESSION_ENDPOINT_H
+
+#include <FS.h>
+#include <esp32/rom/crc.h>
+
+#include "configuration/SystemConfiguration.h"
+#include "configuration/Configuration.h"
+#include "server/RestEndpoint.h"
+#include "server/FseqEndpoint.h"
+#include "logging/Logger.h"
+#include "util/FileUtil.h"
+#include "util/BinaryFile.h"
+#include "util/FseqLoader.h"
+#include "util/FseqIndex.h"
+#include "update/Updater.h"
+
+namespace TesLight
+{
+	class UploadSessionEndpoint : public RestEndpoint
+	{
+	public:
+		static void begin(FS *_fileSystem, TesLight::Configuration *_configuration, TesLight::FseqIndex *_fseqIndex);
+
+	private:
+		UploadSessionEndpoint();
+
+		enum UploadTarget
+		{
+			FSEQ = 0,
+			UPDATE = 1
+		};
+
+		struct UploadSession
+		{
+			TesLight::UploadSessionEndpoint::UploadTarget target;
+			String fileName;
+			uint32_t size;
+			uint32_t crc;
+		};
+
+		static FS *fileSystem;
+		static TesLight::Configuration *configuration;
+		static TesLight::FseqIndex *fseqIndex;
+		static uint8_t *chunkBuffer;
+		static size_t chunkSize;
+		static bool chunkFailed;
+
+		static void createSession();
+		static void getSession();
+		static void putChunk();
+		static void chunkUpload();
+		static void deleteSession();
+		static void commitSession();
+
+		static String getSessionId(const TesLight::UploadSessionEndpoint::UploadSession &session);
+		static String getPartFileName(const String id);
+		static String getSessionFileName(const String id);
+		static bool readSession(const String id, TesLight::UploadSessionEndpoint::UploadSession &session);
+		static bool writeSession(const String id, const TesLight::UploadSessionEndpoint::UploadSession &session);
+		static uint32_t getOffset(const String id);
+		static bool getPartCrc(const String id, const uint32_t offset, const uint32_t size, uint32_t &crc);
+		static void removeSession(const String id);
+		static void freeChunkBuffer();
+	};
+}
+
+#endif
@@ -11,6 +11,10 @@
 
 #include <Arduino.h>
 #include <FS.h>
+#include <esp32/rom/crc.h>
+#include "mbedtls/sha256.h"
+
+#include "configuration/SystemConfiguration.h"
 #include "logging/Logger.h"
 
 namespace TesLight
@@ -22,7 +26,7 @@ namespace TesLight
 		{
 			char magic[4];
 			uint8_t fileVersion;
-			uint32_t hash;
+			uint8_t hash[32];
 			uint32_t numberBlocks;
 		};
 
@@ -30,7 +34,8 @@ namespace TesLight
 		{
 			FIRMWARE = 0,
 			FILE = 1,
-			DIRECTORY = 2
+			DIRECTORY = 2,
+			FIRMWARE_DELTA = 3
 		};
 
 		struct TupDataBlock
@@ -46,22 +51,44 @@ namespace TesLight
 		~TupFile();
 
 		bool load(FS *fileSystem, const String fileName);
-		bool unpack(FS *fileSystem, const String root);
 		void close();
 
+		bool readBlock(TesLight::TupFile::TupDataBlock &dataBlock);
+		bool readData(uint8_t *buffer, const size_t size);
+		bool verify();
+
 		TesLight::TupFile::TupHeader getHeader();
+		String createAbsolutePath(const String root, const TesLight::TupFile::TupDataBlock &dataBlock);
 
 	private:
 		File file;
 		TesLight::TupFile::TupHeader tupHeader;
+		char blockPath[256];
+		mbedtls_sha256_context shaContext;
+		uint32_t blocksRead;
+		uint32_t blockRemaining;
+		uint32_t chunkRemaining;
+		uint32_t chunkStoredRemaining;
+		bool chunkCompressed;
+		uint32_t chunkCrc;
+		uint32_t chunkExpectedCrc;
+
+		uint8_t *window;
+		uint16_t windowPosition;
+		uint8_t *inputBuffer;
+		uint16_t inputLength;
+		uint16_t inputPosition;
+		uint8_t flags;
+		uint8_t flagBits;
+		uint16_t matchDistance;
+		uint8_t matchRemaining;
 
 		void initHeader();
 		bool loadTupHeader();
-
-		bool verify();
-		uint32_t generateHash();
-
-		String createAbsolutePath(const String root, const char *name, uint16_t nameLength);
+		bool readChunkHeader();
+		bool readHashed(uint8_t *buffer, const size_t size);
+		bool readCompressed(uint8_t &value);
+		bool decompress(uint8_t *buffer, const size_t size);
 	};
 }
 
@@ -12,6 +12,10 @@
 #include <Arduino.h>
 #include <FS.h>
 #include <Update.h>
+#include <esp_ota_ops.h>
+#include "mbedtls/sha256.h"
+#include "configuration/SystemConfiguration.h"
+#include "configuration/Configuration.h"
 #include "logging/Logger.h"
 #include "update/TupFile.h"
 #include "util/FileUtil.h"
@@ -22,12 +26,18 @@ namespace TesLight
 	{
 	public:
 		static bool install(FS *fileSystem, const String packageFileName);
-		static void reboot(const String reason);
+		static void reboot(const String reason, TesLight::Configuration *configuration = nullptr);
 
 	private:
 		Updater();
 
-		static bool installFirmware(FS *fileSystem, const String firmwareFileName);
+		static bool writeFirmware(TesLight::TupFile &tupFile, const TesLight::TupFile::TupDataBlock &dataBlock, uint8_t *buffer);
+		static bool applyFirmwareDelta(TesLight::TupFile &tupFile, const TesLight::TupFile::TupDataBlock &dataBlock, uint8_t *buffer);
+		static bool verifyPartition(const esp_partition_t *partition, const uint32_t size, const uint8_t *hash, uint8_t *buffer);
+		static bool readDeltaData(TesLight::TupFile &tupFile, uint8_t *buffer, const size_t size, uint32_t &remaining);
+		static bool unpackFile(FS *fileSystem, TesLight::TupFile &tupFile, const TesLight::TupFile::TupDataBlock &dataBlock, uint8_t *buffer);
+		static bool swapStagedFiles(FS *fileSystem);
+		static void abort(FS *fileSystem, const String packageFileName);
 	};
 }
 
@@ -0,0 +1,40 @@
+/**
+ * @file BootProfiler.h
+ * @author TheRealKasumi
+ * @brief Contains a static class to measure the duration of the boot stages and the time to the first LED frame.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef BOOT_PROFILER_H
+#define BOOT_PROFILER_H
+
+#include <Arduino.h>
+
+#include "configuration/SystemConfiguration.h"
+#include "logging/Logger.h"
+
+namespace TesLight
+{
+	class BootProfiler
+	{
+	public:
+		static void record(const __FlashStringHelper *stage, const unsigned long start);
+		static void markFirstFrame();
+
+		static unsigned long getTimeToFirstFrame();
+		static void printSummary();
+
+	private:
+		BootProfiler();
+
+		static const __FlashStringHelper *stageName[BOOT_PROFILER_MAX_STAGES];
+		static unsigned long stageStart[BOOT_PROFILER_MAX_STAGES];
+		static unsigned long stageDuration[BOOT_PROFILER_MAX_STAGES];
+		static uint8_t stageCount;
+		static unsigned long firstFrameTime;
+		static portMUX_TYPE lock;
+	};
+}
+
+#endif
@@ -21,6 +21,7 @@ namespace TesLight
 		static bool directoryExists(FS *fileSystem, const String path);
 
 		static bool getFileIdentifier(FS *fileSystem, const String fileName, uint32_t &identifier);
+		static void getFileIdentifier(File &file, const String fileName, uint32_t &identifier);
 
 		static bool countFiles(FS *fileSystem, const String directory, uint16_t &count, const bool includeDirs);
 		static bool getFileList(FS *fileSystem, const String directory, String &fileList, const bool includeDirs);
@@ -0,0 +1,68 @@
+/**
+ * @file FseqIndex.h
+ * @author TheRealKasumi
+ * @brief Contains a class to keep an index of all fseq files, so that they can be found without scanning the SD card.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef FSEQ_INDEX_H
+#define FSEQ_INDEX_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <esp32/rom/crc.h>
+
+#include "configuration/SystemConfiguration.h"
+#include "logging/Logger.h"
+#include "util/FileUtil.h"
+#include "util/InMemoryBinaryFile.h"
+
+namespace TesLight
+{
+	class FseqIndex
+	{
+	public:
+		struct FseqIndexEntry
+		{
+			String fileName;	   // Name of the file without the directory
+			uint32_t identifier;   // Identifier of the file, see {@link TesLight::FileUtil::getFileIdentifier}
+			uint32_t fileSize;	   // Size of the file in bytes
+			uint32_t channelCount; // Number of channels from the fseq header
+			uint32_t frameCount;   // Number of frames from the fseq header
+			uint8_t stepTime;	   // Time per frame in ms from the fseq header
+		};
+
+		FseqIndex(FS *fileSystem, const String directory, const String indexFileName);
+		~FseqIndex();
+
+		bool load();
+		bool rebuild();
+
+		bool add(const String fileName);
+		bool remove(const String fileName);
+
+		uint16_t getEntryCount();
+		bool getEntry(const uint32_t identifier, TesLight::FseqIndex::FseqIndexEntry &entry);
+		bool getFileName(const uint32_t identifier, String &fileName);
+		String getFileList();
+
+	private:
+		FS *fileSystem;
+		String directory;
+		String indexFileName;
+		TesLight::FseqIndex::FseqIndexEntry *entries;
+		uint16_t entryCount;
+		uint16_t entryCapacity;
+		uint32_t directoryDigest;
+
+		bool save();
+		bool getDirectoryDigest(uint32_t &digest);
+		bool readEntry(File &file, TesLight::FseqIndex::FseqIndexEntry &entry);
+		bool insert(const TesLight::FseqIndex::FseqIndexEntry &entry);
+		int32_t find(const uint32_t identifier);
+		void clear();
+	};
+}
+
+#endif
@@ -0,0 +1,44 @@
+/**
+ * @file MadgwickFilter.h
+ * @author TheRealKasumi
+ * @brief Contains a Madgwick quaternion filter to estimate the orientation from gyro and acceleration data.
+ * The filter has no dependencies to the hardware, so it can also be built and tested on a host.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef MADGWICK_FILTER_H
+#define MADGWICK_FILTER_H
+
+#include <math.h>
+
+namespace TesLight
+{
+	class MadgwickFilter
+	{
+	public:
+		MadgwickFilter(const float beta, const float biasRate);
+		~MadgwickFilter();
+
+		void reset();
+		void update(float gyroX, float gyroY, float gyroZ, float accX, float accY, float accZ, const float timeStep);
+
+		void getGravity(float &gravityX, float &gravityY, float &gravityZ);
+		float getRotationX();
+		float getRotationY();
+		float getRotationZ();
+
+	private:
+		float beta;
+		float biasRate;
+		float q0;
+		float q1;
+		float q2;
+		float q3;
+		float biasX;
+		float biasY;
+		float biasZ;
+	};
+}
+
+#endif
@@ -0,0 +1,36 @@
+/**
+ * @file PidController.h
+ * @author TheRealKasumi
+ * @brief Contains a PID controller with a limited output and anti-windup.
+ * The controller has no dependencies to the hardware, so it can also be built and tested on a host.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef PID_CONTROLLER_H
+#define PID_CONTROLLER_H
+
+namespace TesLight
+{
+	class PidController
+	{
+	public:
+		PidController(const float kp, const float ki, const float kd, const float outputMin, const float outputMax);
+		~PidController();
+
+		void reset();
+		float update(const float error, const float timeStep);
+
+	private:
+		float kp;
+		float ki;
+		float kd;
+		float outputMin;
+		float outputMax;
+		float integral;
+		float lastError;
+		bool initialized;
+	};
+}
+
+#endif
@@ -0,0 +1,79 @@
+/**
+ * @file SeqLock.h
+ * @author TheRealKasumi
+ * @brief Contains a sequence lock to share snapshots of data between a single writer and multiple readers without blocking.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef SEQ_LOCK_H
+#define SEQ_LOCK_H
+
+#include <stdint.h>
+#include <atomic>
+
+namespace TesLight
+{
+	template <typename T>
+	class SeqLock
+	{
+	public:
+		/**
+		 * @brief Create a new instance of {@link TesLight::SeqLock}.
+		 * @param value initial value
+		 */
+		SeqLock(const T &value = T())
+		{
+			this->sequence.store(0, std::memory_order_relaxed);
+			this->value = value;
+		}
+
+		/**
+		 * @brief Publish a new value. There must only be a single writer.
+		 * @param value new value
+		 */
+		void write(const T &value)
+		{
+			const uint32_t sequence = this->sequence.load(std::memory_order_relaxed);
+			this->sequence.store(sequence + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			this->value = value;
+			std::atomic_thread_fence(std::memory_order_release);
+			this->sequence.store(sequence + 2, std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief Read a consistent snapshot of the value. The read is repeated when a write happened at the same time.
+		 * @return T snapshot of the value
+		 */
+		T read() const
+		{
+			T snapshot;
+			uint32_t before = 0;
+			uint32_t after = 0;
+			do
+			{
+				before = this->sequence.load(std::memory_order_acquire);
+				snapshot = this->value;
+				std::atomic_thread_fence(std::memory_order_acquire);
+				after = this->sequence.load(std::memory_order_relaxed);
+			} while ((before & 1) != 0 || before != after);
+			return snapshot;
+		}
+
+		/**
+		 * @brief Get the number of published values.
+		 * @return uint32_t number of published values
+		 */
+		uint32_t getVersion() const
+		{
+			return this->sequence.load(std::memory_order_acquire) / 2;
+		}
+
+	private:
+		std::atomic<uint32_t> sequence;
+		T value;
+	};
+}
+
+#endif
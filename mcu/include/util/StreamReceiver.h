@@ -0,0 +1,71 @@
+/**
+ * @file StreamReceiver.h
+ * @author TheRealKasumi
+ * @brief Contains a class to receive realtime LED data via DDP or E1.31 (sACN) over UDP.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef STREAM_RECEIVER_H
+#define STREAM_RECEIVER_H
+
+#include <stdint.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+#include "configuration/SystemConfiguration.h"
+#include "logging/Logger.h"
+
+#include "FastLED.h"
+
+namespace TesLight
+{
+	class StreamReceiver
+	{
+	public:
+		StreamReceiver(const uint32_t channelCount);
+		~StreamReceiver();
+
+		bool begin(const uint16_t ddpPort = STREAM_DDP_PORT, const uint16_t e131Port = STREAM_E131_PORT);
+		void end();
+
+		void receive();
+		void nextFrame();
+
+		uint32_t getChannelCount();
+		uint32_t getReceivedFrames();
+		uint32_t getDroppedFrames();
+
+		bool readPixelbuffer(CRGB *pixelBuffer, const uint32_t channelOffset, const size_t bufferSize);
+
+	private:
+		uint32_t channelCount;
+		bool enabled;
+		bool listening;
+		uint16_t ddpPort;
+		uint16_t e131Port;
+		WiFiUDP ddpSocket;
+		WiFiUDP e131Socket;
+		uint8_t *packetBuffer;
+
+		uint8_t *assemblyBuffer;
+		uint8_t *outputBuffer;
+		uint8_t *jitterBuffer[STREAM_JITTER_BUFFER_FRAMES];
+		uint8_t jitterReadIndex;
+		uint8_t jitterFrameCount;
+
+		uint32_t ddpPacketCount;
+		uint32_t e131UniverseCount;
+		uint32_t e131ReceivedUniverses;
+		unsigned long lastPacketTime;
+		uint32_t receivedFrames;
+		uint32_t droppedFrames;
+
+		bool openSockets();
+		void handleDdpPacket(const size_t packetSize);
+		void handleE131Packet(const size_t packetSize);
+		void commitFrame();
+	};
+}
+
+#endif
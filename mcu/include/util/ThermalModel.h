@@ -0,0 +1,38 @@
+/**
+ * @file ThermalModel.h
+ * @author TheRealKasumi
+ * @brief Contains a simple first order thermal model to predict the regulator temperature from the LED power draw.
+ * The model has no dependencies to the hardware, so it can also be built and tested on a host.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef THERMAL_MODEL_H
+#define THERMAL_MODEL_H
+
+#include <math.h>
+
+namespace TesLight
+{
+	class ThermalModel
+	{
+	public:
+		ThermalModel(const float thermalResistance, const float timeConstant);
+		~ThermalModel();
+
+		void reset();
+		void update(const float temperature, const float power, const float timeStep);
+
+		float predictTemperature(const float horizon);
+		float getAmbientTemperature();
+
+	private:
+		float thermalResistance;
+		float timeConstant;
+		float temperature;
+		float power;
+		float filteredPower;
+	};
+}
+
+#endif
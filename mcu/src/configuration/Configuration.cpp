@@ -10,14 +10,17 @@
 
 /**
  * @brief Create a new instance of {@link TesLight::Configuration}.
- * @param fileSystem pointer to a {@link FS}
- * @param fileName file name of the configuration file
+ * @param nvsNamespace namespace in the non volatile storage in which the configuration is stored
  */
-TesLight::Configuration::Configuration(FS *fileSystem, const String fileName)
+TesLight::Configuration::Configuration(const String nvsNamespace)
 {
-	this->fileSystem = fileSystem;
-	this->fileName = fileName;
+	this->nvsNamespace = nvsNamespace;
+	this->backupFileSystem = nullptr;
 	this->configurationVersion = 7;
+	this->activeSlot = 1;
+	this->generation = 0;
+	this->saveRequested = false;
+	this->lastChange = 0;
 	this->loadDefaults();
 }
 
@@ -172,186 +175,535 @@ void TesLight::Configuration::loadDefaults()
 }
 
 /**
- * @brief Load the configuration from a binary file.
- * @param loadDefaultIfNotExist load default values when the file could not be found
+ * @brief Set a file system and file name to which a backup of the configuration is exported on every save.
+ * @param fileSystem file system for the backup or nullptr to disable the backup
+ * @param fileName full path and name of the backup file
+ */
+void TesLight::Configuration::setBackupFile(FS *fileSystem, const String fileName)
+{
+	this->backupFileSystem = fileSystem;
+	this->backupFileName = fileName;
+}
+
+/**
+ * @brief Load the configuration from the newest valid slot in the non volatile storage.
  * @return true when successful
  * @return false when there was an error
  */
 bool TesLight::Configuration::load()
 {
-	TesLight::BinaryFile file(this->fileSystem);
-	if (!file.open(this->fileName, FILE_READ))
+	uint32_t generation[2] = {0, 0};
+	bool valid[2] = {false, false};
+	for (uint8_t i = 0; i < 2; i++)
 	{
-		TesLight::Logger::log(TesLight::Logger::ERROR, SOURCE_LOCATION, (String)F("Failed to load configuration file: ") + fileName);
+		valid[i] = this->readSlot(i, generation[i], false);
+	}
+
+	if (!valid[0] && !valid[1])
+	{
+		TesLight::Logger::log(TesLight::Logger::WARN, SOURCE_LOCATION, F("No valid configuration slot was found in the non volatile storage."));
 		return false;
 	}
 
-	// Check the configuration file version
-	uint16_t configFileVersion = 0;
-	if (!file.read(configFileVersion) || configFileVersion != this->configurationVersion)
+	const uint8_t slot = valid[0] && (!valid[1] || generation[0] > generation[1]) ? 0 : 1;
+	if (!this->readSlot(slot, this->generation, true))
 	{
-		TesLight::Logger::log(TesLight::Logger::ERROR, SOURCE_LOCATION, F("Configuration file version does not match."));
-		file.close();
+		TesLight::Logger::log(TesLight::Logger::ERROR, SOURCE_LOCATION, F("Failed to load configuration slot."));
 		return false;
 	}
 
-	// System config
-	file.read(this->systemConfig.logLevel);
-	file.read(this->systemConfig.lightSensorMode);
-	file.read(this->systemConfig.lightSensorThreshold);
-	file.read(this->systemConfig.lightSensorMinAmbientBrightness);
-	file.read(this->systemConfig.lightSensorMaxAmbientBrightness);
-	file.read(this->systemConfig.lightSensorMinLedBrightness);
-	file.read(this->systemConfig.lightSensorMaxLedBrightness);
-	file.read(this->systemConfig.lightSensorDuration);
-	file.read(this->systemConfig.regulatorPowerLimit);
-	file.read(this->systemConfig.regulatorHighTemperature);
-	file.read(this->systemConfig.regulatorCutoffTemperature);
-	file.read(this->systemConfig.fanMinPwmValue);
-	file.read(this->systemConfig.fanMaxPwmValue);
-	file.read(this->systemConfig.fanMinTemperature);
-	file.read(this->systemConfig.fanMaxTemperature);
+	this->activeSlot = slot;
+	TesLight::Logger::log(TesLight::Logger::DEBUG, SOURCE_LOCATION, (String)F("Configuration loaded from slot ") + String(slot) + F(" with generation ") + String(this->generation) + F("."));
+	return true;
+}
 
-	// LED config
-	for (uint8_t i = 0; i < LED_NUM_ZONES; i++)
+/**
+ * @brief Schedule the configuration to be saved. The write is deferred until there were no further changes
+ * for {@link CONFIGURATION_SAVE_DELAY}, so that many changes in a short time result in a single write.
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::Configuration::save()
+{
+	this->saveRequested = true;
+	this->lastChange = micros();
+	return true;
+}
+
+/**
+ * @brief Write a pending configuration change once the save delay expired.
+ * When a backup file is set, the configuration is also exported to it.
+ * @param force write the pending change immediately
+ * @return true when there was nothing to write or the configuration was written successfully
+ * @return false when there was an error
+ */
+bool TesLight::Configuration::flush(const bool force)
+{
+	if (!this->saveRequested || (!force && micros() - this->lastChange < CONFIGURATION_SAVE_DELAY))
 	{
-		file.read(this->ledConfig[i].ledPin);
-		file.read(this->ledConfig[i].ledCount);
-		file.read(this->ledConfig[i].type);
-		file.read(this->ledConfig[i].speed);
-		file.read(this->ledConfig[i].offset);
-		file.read(this->ledConfig[i].brightness);
-		file.read(this->ledConfig[i].reverse);
-		file.read(this->ledConfig[i].fadeSpeed);
-		for (uint8_t j = 0; j < ANIMATOR_NUM_CUSTOM_FIELDS; j++)
-		{
-			file.read(this->ledConfig[i].customField[j]);
-		}
-		file.read(this->ledConfig[i].ledVoltage);
-		file.read(this->ledConfig[i].ledChannelCurrent[0]);
-		file.read(this->ledConfig[i].ledChannelCurrent[1]);
-		file.read(this->ledConfig[i].ledChannelCurrent[2]);
+		return true;
 	}
 
-	// WiFi config
-	file.readString(this->wifiConfig.accessPointSsid);
-	file.readString(this->wifiConfig.accessPointPassword);
-	file.read(this->wifiConfig.accessPointChannel);
-	file.read(this->wifiConfig.accessPointHidden);
-	file.read(this->wifiConfig.accessPointMaxConnections);
-	file.readString(this->wifiConfig.wifiSsid);
-	file.readString(this->wifiConfig.wifiPassword);
+	const uint8_t slot = this->activeSlot == 0 ? 1 : 0;
+	if (!this->writeSlot(slot, this->generation + 1))
+	{
+		TesLight::Logger::log(TesLight::Logger::ERROR, SOURCE_LOCATION, F("Failed to save configuration. Retrying later."));
+		this->lastChange = micros();
+		return false;
+	}
 
-	// Motion sensor calibration
-	file.read(this->motionSensorCalibration.accXRaw);
-	file.read(this->motionSensorCalibration.accYRaw);
-	file.read(this->motionSensorCalibration.accZRaw);
-	file.read(this->motionSensorCalibration.gyroXRaw);
-	file.read(this->motionSensorCalibration.gyroYRaw);
-	file.read(this->motionSensorCalibration.gyroZRaw);
-	file.read(this->motionSensorCalibration.accXG);
-	file.read(this->motionSensorCalibration.accYG);
-	file.read(this->motionSensorCalibration.accZG);
-	file.read(this->motionSensorCalibration.gyroXDeg);
-	file.read(this->motionSensorCalibration.gyroYDeg);
-	file.read(this->motionSensorCalibration.gyroZDeg);
-
-	// Check the hash
-	uint16_t fileHash = 0;
-	if (!file.read(fileHash) || fileHash != this->getSimpleHash())
-	{
-		TesLight::Logger::log(TesLight::Logger::ERROR, SOURCE_LOCATION, F("Configuration file hash does not match."));
+	this->activeSlot = slot;
+	this->generation++;
+	this->saveRequested = false;
+	TesLight::Logger::log(TesLight::Logger::DEBUG, SOURCE_LOCATION, (String)F("Configuration saved to slot ") + String(slot) + F(" with generation ") + String(this->generation) + F("."));
+
+	if (this->backupFileSystem != nullptr && !this->exportToFile(this->backupFileSystem, this->backupFileName))
+	{
+		TesLight::Logger::log(TesLight::Logger::WARN, SOURCE_LOCATION, F("Failed to export the configuration backup."));
+	}
+
+	return true;
+}
+
+/**
+ * @brief Import the configuration from a file. The file can either be an exported configuration or a legacy configuration file.
+ * The imported configuration is scheduled to be saved.
+ * @param fileSystem file system of the file
+ * @param fileName full path and name of the file
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::Configuration::importFromFile(FS *fileSystem, const String fileName)
+{
+	File file = fileSystem->open(fileName, FILE_READ);
+	if (!file)
+	{
+		TesLight::Logger::log(TesLight::Logger::DEBUG, SOURCE_LOCATION, (String)F("Configuration file ") + fileName + F(" does not exist."));
+		return false;
+	}
+
+	const size_t size = file.size();
+	if (size > CONFIGURATION_SLOT_MAX_SIZE)
+	{
+		TesLight::Logger::log(TesLight::Logger::ERROR, SOURCE_LOCATION, (String)F("Configuration file ") + fileName + F(" is too large."));
 		file.close();
 		return false;
 	}
 
+	uint8_t *buffer = new uint8_t[size];
+	const size_t bytesRead = file.read(buffer, size);
+	file.close();
+	if (bytesRead != size)
+	{
+		TesLight::Logger::log(TesLight::Logger::ERROR, SOURCE_LOCATION, (String)F("Failed to read configuration file ") + fileName + F("."));
+		delete[] buffer;
+		return false;
+	}
+
+	uint32_t generation = 0;
+	const bool imported = this->parseSlot(buffer, size, generation, true) || this->parseLegacy(buffer, size);
+	delete[] buffer;
+	if (!imported)
+	{
+		TesLight::Logger::log(TesLight::Logger::ERROR, SOURCE_LOCATION, (String)F("Configuration file ") + fileName + F(" is invalid."));
+		return false;
+	}
+
+	return this->save();
+}
+
+/**
+ * @brief Export the configuration to a file, using the same format as the configuration slots.
+ * @param fileSystem file system of the file
+ * @param fileName full path and name of the file
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::Configuration::exportToFile(FS *fileSystem, const String fileName)
+{
+	TesLight::InMemoryBinaryFile binary(this->getSlotSize());
+	if (!this->createSlot(binary, this->generation))
+	{
+		TesLight::Logger::log(TesLight::Logger::ERROR, SOURCE_LOCATION, F("Failed to serialize configuration."));
+		return false;
+	}
+
+	File file = fileSystem->open(fileName, FILE_WRITE);
+	if (!file)
+	{
+		TesLight::Logger::log(TesLight::Logger::ERROR, SOURCE_LOCATION, (String)F("Failed to open configuration file ") + fileName + F("."));
+		return false;
+	}
+
+	const size_t bytesWritten = file.write(binary.getData(), binary.getBytesWritten());
 	file.close();
+	if (bytesWritten != binary.getBytesWritten())
+	{
+		TesLight::Logger::log(TesLight::Logger::ERROR, SOURCE_LOCATION, (String)F("Failed to write configuration file ") + fileName + F("."));
+		return false;
+	}
+
 	return true;
 }
 
 /**
- * @brief Save to configuration to a file.
+ * @brief Erase the configuration from the non volatile storage and remove the backup and legacy file.
+ * The values in memory are not changed.
  * @return true when successful
  * @return false when there was an error
  */
-bool TesLight::Configuration::save()
+bool TesLight::Configuration::clear()
 {
-	TesLight::BinaryFile file(this->fileSystem);
-	if (!file.open(this->fileName, FILE_WRITE))
+	this->saveRequested = false;
+
+	Preferences preferences;
+	if (!preferences.begin(this->nvsNamespace.c_str(), false))
 	{
-		TesLight::Logger::log(TesLight::Logger::ERROR, SOURCE_LOCATION, F("Failed to open configuration file."));
+		TesLight::Logger::log(TesLight::Logger::ERROR, SOURCE_LOCATION, F("Failed to open the non volatile storage."));
 		return false;
 	}
+	const bool cleared = preferences.clear();
+	preferences.end();
 
-	// Write the configuration file version
-	file.write(this->configurationVersion);
-
-	// System cofiguration
-	file.write((uint8_t)this->systemConfig.logLevel);
-	file.write((uint8_t)this->systemConfig.lightSensorMode);
-	file.write(this->systemConfig.lightSensorThreshold);
-	file.write(this->systemConfig.lightSensorMinAmbientBrightness);
-	file.write(this->systemConfig.lightSensorMaxAmbientBrightness);
-	file.write(this->systemConfig.lightSensorMinLedBrightness);
-	file.write(this->systemConfig.lightSensorMaxLedBrightness);
-	file.write(this->systemConfig.lightSensorDuration);
-	file.write(this->systemConfig.regulatorPowerLimit);
-	file.write(this->systemConfig.regulatorHighTemperature);
-	file.write(this->systemConfig.regulatorCutoffTemperature);
-	file.write(this->systemConfig.fanMinPwmValue);
-	file.write(this->systemConfig.fanMaxPwmValue);
-	file.write(this->systemConfig.fanMinTemperature);
-	file.write(this->systemConfig.fanMaxTemperature);
+	if (this->backupFileSystem != nullptr)
+	{
+		this->backupFileSystem->remove(this->backupFileName);
+		this->backupFileSystem->remove(CONFIGURATION_FILE_NAME);
+	}
+
+	return cleared;
+}
+
+/**
+ * @brief Read and verify a configuration slot from the non volatile storage.
+ * @param slot index of the slot
+ * @param generation generation of the slot after the call
+ * @param apply true to apply the configuration values, false to only verify the slot
+ * @return true when the slot is valid
+ * @return false when the slot is missing or invalid
+ */
+bool TesLight::Configuration::readSlot(const uint8_t slot, uint32_t &generation, const bool apply)
+{
+	const char *slotKeys[2] = CONFIGURATION_NVS_SLOT_KEYS;
+	Preferences preferences;
+	if (!preferences.begin(this->nvsNamespace.c_str(), true))
+	{
+		TesLight::Logger::log(TesLight::Logger::DEBUG, SOURCE_LOCATION, F("The configuration namespace does not exist in the non volatile storage."));
+		return false;
+	}
+
+	const size_t size = preferences.getBytesLength(slotKeys[slot]);
+	if (size == 0 || size > CONFIGURATION_SLOT_MAX_SIZE)
+	{
+		TesLight::Logger::log(TesLight::Logger::DEBUG, SOURCE_LOCATION, (String)F("Configuration slot ") + slotKeys[slot] + F(" is empty or invalid."));
+		preferences.end();
+		return false;
+	}
+
+	uint8_t *buffer = new uint8_t[size];
+	const size_t bytesRead = preferences.getBytes(slotKeys[slot], buffer, size);
+	preferences.end();
+
+	const bool valid = bytesRead == size && this->parseSlot(buffer, size, generation, apply);
+	delete[] buffer;
+	if (!valid)
+	{
+		TesLight::Logger::log(TesLight::Logger::WARN, SOURCE_LOCATION, (String)F("Configuration slot ") + slotKeys[slot] + F(" is corrupted."));
+	}
+	return valid;
+}
+
+/**
+ * @brief Write the configuration to a slot in the non volatile storage.
+ * @param slot index of the slot
+ * @param generation generation to write
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::Configuration::writeSlot(const uint8_t slot, const uint32_t generation)
+{
+	TesLight::InMemoryBinaryFile binary(this->getSlotSize());
+	if (!this->createSlot(binary, generation))
+	{
+		TesLight::Logger::log(TesLight::Logger::ERROR, SOURCE_LOCATION, F("Failed to serialize configuration."));
+		return false;
+	}
+
+	const char *slotKeys[2] = CONFIGURATION_NVS_SLOT_KEYS;
+	Preferences preferences;
+	if (!preferences.begin(this->nvsNamespace.c_str(), false))
+	{
+		TesLight::Logger::log(TesLight::Logger::ERROR, SOURCE_LOCATION, F("Failed to open the non volatile storage."));
+		return false;
+	}
+
+	const size_t bytesWritten = preferences.putBytes(slotKeys[slot], binary.getData(), binary.getBytesWritten());
+	preferences.end();
+	if (bytesWritten != binary.getBytesWritten())
+	{
+		TesLight::Logger::log(TesLight::Logger::ERROR, SOURCE_LOCATION, (String)F("Failed to write configuration slot ") + slotKeys[slot] + F("."));
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Get the size of a configuration slot.
+ * @return size in bytes
+ */
+size_t TesLight::Configuration::getSlotSize()
+{
+	return CONFIGURATION_SLOT_HEADER_SIZE + this->getSerializedSize() + sizeof(uint32_t);
+}
+
+/**
+ * @brief Create a configuration slot. It contains the version, the generation, the size of the payload,
+ * the payload and a CRC32 over everything before.
+ * @param binary buffer with the size of {@link getSlotSize}
+ * @param generation generation of the slot
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::Configuration::createSlot(TesLight::InMemoryBinaryFile &binary, const uint32_t generation)
+{
+	const uint16_t payloadSize = this->getSerializedSize();
+	binary.write(this->configurationVersion);
+	binary.write(generation);
+	binary.write(payloadSize);
+	this->serialize(binary);
+	binary.write(crc32_le(0, binary.getData(), binary.getBytesWritten()));
+	return binary.getBytesWritten() == this->getSlotSize();
+}
+
+/**
+ * @brief Verify a configuration slot and optionally apply the values.
+ * @param buffer buffer containing the slot
+ * @param size size of the buffer
+ * @param generation generation of the slot after the call
+ * @param apply true to apply the configuration values, false to only verify the slot
+ * @return true when the slot is valid
+ * @return false when the slot is invalid
+ */
+bool TesLight::Configuration::parseSlot(uint8_t *buffer, const size_t size, uint32_t &generation, const bool apply)
+{
+	uint32_t crc = 0;
+	if (size < CONFIGURATION_SLOT_HEADER_SIZE + sizeof(crc))
+	{
+		return false;
+	}
+
+	memcpy(&crc, buffer + size - sizeof(crc), sizeof(crc));
+	if (crc != crc32_le(0, buffer, size - sizeof(crc)))
+	{
+		return false;
+	}
+
+	TesLight::InMemoryBinaryFile binary(size - sizeof(crc));
+	binary.loadFrom(buffer, size - sizeof(crc));
+
+	uint16_t version = 0;
+	uint16_t payloadSize = 0;
+	binary.read(version);
+	binary.read(generation);
+	binary.read(payloadSize);
+	if (version != this->configurationVersion || CONFIGURATION_SLOT_HEADER_SIZE + payloadSize + sizeof(crc) != size)
+	{
+		TesLight::Logger::log(TesLight::Logger::WARN, SOURCE_LOCATION, F("Configuration slot has an incompatible version."));
+		return false;
+	}
+
+	if (apply)
+	{
+		this->deserialize(binary);
+	}
+	return true;
+}
+
+/**
+ * @brief Verify and apply a legacy configuration file, which was protected by a simple hash only.
+ * @param buffer buffer containing the legacy configuration
+ * @param size size of the buffer
+ * @return true when successful
+ * @return false when the configuration is invalid
+ */
+bool TesLight::Configuration::parseLegacy(uint8_t *buffer, const size_t size)
+{
+	if (size < 4)
+	{
+		return false;
+	}
+
+	TesLight::InMemoryBinaryFile binary(size);
+	binary.loadFrom(buffer, size);
+
+	uint16_t version = 0;
+	if (!binary.read(version) || version != this->configurationVersion)
+	{
+		TesLight::Logger::log(TesLight::Logger::ERROR, SOURCE_LOCATION, F("Legacy configuration file version does not match."));
+		return false;
+	}
+
+	this->deserialize(binary);
+	uint16_t hash = 0;
+	if (!binary.read(hash) || hash != this->getSimpleHash())
+	{
+		TesLight::Logger::log(TesLight::Logger::ERROR, SOURCE_LOCATION, F("Legacy configuration file is invalid."));
+		this->loadDefaults();
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Get the size of the serialized configuration.
+ * @return size in bytes
+ */
+uint16_t TesLight::Configuration::getSerializedSize()
+{
+	uint16_t size = 15 + LED_NUM_ZONES * (13 + ANIMATOR_NUM_CUSTOM_FIELDS + 1) + 3 + 6 * sizeof(int16_t) + 6 * sizeof(float);
+	size += 2 + this->wifiConfig.accessPointSsid.length();
+	size += 2 + this->wifiConfig.accessPointPassword.length();
+	size += 2 + this->wifiConfig.wifiSsid.length();
+	size += 2 + this->wifiConfig.wifiPassword.length();
+	return size;
+}
+
+/**
+ * @brief Write all configuration values to the binary buffer.
+ * @param binary buffer to write to
+ */
+void TesLight::Configuration::serialize(TesLight::InMemoryBinaryFile &binary)
+{
+	// System configuration
+	binary.write((uint8_t)this->systemConfig.logLevel);
+	binary.write((uint8_t)this->systemConfig.lightSensorMode);
+	binary.write(this->systemConfig.lightSensorThreshold);
+	binary.write(this->systemConfig.lightSensorMinAmbientBrightness);
+	binary.write(this->systemConfig.lightSensorMaxAmbientBrightness);
+	binary.write(this->systemConfig.lightSensorMinLedBrightness);
+	binary.write(this->systemConfig.lightSensorMaxLedBrightness);
+	binary.write(this->systemConfig.lightSensorDuration);
+	binary.write(this->systemConfig.regulatorPowerLimit);
+	binary.write(this->systemConfig.regulatorHighTemperature);
+	binary.write(this->systemConfig.regulatorCutoffTemperature);
+	binary.write(this->systemConfig.fanMinPwmValue);
+	binary.write(this->systemConfig.fanMaxPwmValue);
+	binary.write(this->systemConfig.fanMinTemperature);
+	binary.write(this->systemConfig.fanMaxTemperature);
 
 	// LED configuration
 	for (uint8_t i = 0; i < LED_NUM_ZONES; i++)
 	{
-		file.write(this->ledConfig[i].ledPin);
-		file.write(this->ledConfig[i].ledCount);
-		file.write(this->ledConfig[i].type);
-		file.write(this->ledConfig[i].speed);
-		file.write(this->ledConfig[i].offset);
-		file.write(this->ledConfig[i].brightness);
-		file.write(this->ledConfig[i].reverse);
-		file.write(this->ledConfig[i].fadeSpeed);
+		binary.write(this->ledConfig[i].ledPin);
+		binary.write(this->ledConfig[i].ledCount);
+		binary.write(this->ledConfig[i].type);
+		binary.write(this->ledConfig[i].speed);
+		binary.write(this->ledConfig[i].offset);
+		binary.write(this->ledConfig[i].brightness);
+		binary.write(this->ledConfig[i].reverse);
+		binary.write(this->ledConfig[i].fadeSpeed);
 		for (uint8_t j = 0; j < ANIMATOR_NUM_CUSTOM_FIELDS; j++)
 		{
-			file.write(this->ledConfig[i].customField[j]);
+			binary.write(this->ledConfig[i].customField[j]);
 		}
-		file.write(this->ledConfig[i].ledVoltage);
-		file.write(this->ledConfig[i].ledChannelCurrent[0]);
-		file.write(this->ledConfig[i].ledChannelCurrent[1]);
-		file.write(this->ledConfig[i].ledChannelCurrent[2]);
+		binary.write(this->ledConfig[i].ledVoltage);
+		binary.write(this->ledConfig[i].ledChannelCurrent[0]);
+		binary.write(this->ledConfig[i].ledChannelCurrent[1]);
+		binary.write(this->ledConfig[i].ledChannelCurrent[2]);
 	}
 
 	// WiFi configuration
-	file.writeString(this->wifiConfig.accessPointSsid);
-	file.writeString(this->wifiConfig.accessPointPassword);
-	file.write(this->wifiConfig.accessPointChannel);
-	file.write(this->wifiConfig.accessPointHidden);
-	file.write(this->wifiConfig.accessPointMaxConnections);
-	file.writeString(this->wifiConfig.wifiSsid);
-	file.writeString(this->wifiConfig.wifiPassword);
+	binary.writeString(this->wifiConfig.accessPointSsid);
+	binary.writeString(this->wifiConfig.accessPointPassword);
+	binary.write(this->wifiConfig.accessPointChannel);
+	binary.write(this->wifiConfig.accessPointHidden);
+	binary.write(this->wifiConfig.accessPointMaxConnections);
+	binary.writeString(this->wifiConfig.wifiSsid);
+	binary.writeString(this->wifiConfig.wifiPassword);
 
 	// Motion sensor calibration
-	file.write(this->motionSensorCalibration.accXRaw);
-	file.write(this->motionSensorCalibration.accYRaw);
-	file.write(this->motionSensorCalibration.accZRaw);
-	file.write(this->motionSensorCalibration.gyroXRaw);
-	file.write(this->motionSensorCalibration.gyroYRaw);
-	file.write(this->motionSensorCalibration.gyroZRaw);
-	file.write(this->motionSensorCalibration.accXG);
-	file.write(this->motionSensorCalibration.accYG);
-	file.write(this->motionSensorCalibration.accZG);
-	file.write(this->motionSensorCalibration.gyroXDeg);
-	file.write(this->motionSensorCalibration.gyroYDeg);
-	file.write(this->motionSensorCalibration.gyroZDeg);
-
-	// Write the hash
-	file.write(this->getSimpleHash());
+	binary.write(this->motionSensorCalibration.accXRaw);
+	binary.write(this->motionSensorCalibration.accYRaw);
+	binary.write(this->motionSensorCalibration.accZRaw);
+	binary.write(this->motionSensorCalibration.gyroXRaw);
+	binary.write(this->motionSensorCalibration.gyroYRaw);
+	binary.write(this->motionSensorCalibration.gyroZRaw);
+	binary.write(this->motionSensorCalibration.accXG);
+	binary.write(this->motionSensorCalibration.accYG);
+	binary.write(this->motionSensorCalibration.accZG);
+	binary.write(this->motionSensorCalibration.gyroXDeg);
+	binary.write(this->motionSensorCalibration.gyroYDeg);
+	binary.write(this->motionSensorCalibration.gyroZDeg);
+}
 
-	file.close();
-	return true;
+/**
+ * @brief Read all configuration values from the binary buffer.
+ * @param binary buffer to read from
+ */
+void TesLight::Configuration::deserialize(TesLight::InMemoryBinaryFile &binary)
+{
+	// System config
+	binary.read(this->systemConfig.logLevel);
+	binary.read(this->systemConfig.lightSensorMode);
+	binary.read(this->systemConfig.lightSensorThreshold);
+	binary.read(this->systemConfig.lightSensorMinAmbientBrightness);
+	binary.read(this->systemConfig.lightSensorMaxAmbientBrightness);
+	binary.read(this->systemConfig.lightSensorMinLedBrightness);
+	binary.read(this->systemConfig.lightSensorMaxLedBrightness);
+	binary.read(this->systemConfig.lightSensorDuration);
+	binary.read(this->systemConfig.regulatorPowerLimit);
+	binary.read(this->systemConfig.regulatorHighTemperature);
+	binary.read(this->systemConfig.regulatorCutoffTemperature);
+	binary.read(this->systemConfig.fanMinPwmValue);
+	binary.read(this->systemConfig.fanMaxPwmValue);
+	binary.read(this->systemConfig.fanMinTemperature);
+	binary.read(this->systemConfig.fanMaxTemperature);
+
+	// LED config
+	for (uint8_t i = 0; i < LED_NUM_ZONES; i++)
+	{
+		binary.read(this->ledConfig[i].ledPin);
+		binary.read(this->ledConfig[i].ledCount);
+		binary.read(this->ledConfig[i].type);
+		binary.read(this->ledConfig[i].speed);
+		binary.read(this->ledConfig[i].offset);
+		binary.read(this->ledConfig[i].brightness);
+		binary.read(this->ledConfig[i].reverse);
+		binary.read(this->ledConfig[i].fadeSpeed);
+		for (uint8_t j = 0; j < ANIMATOR_NUM_CUSTOM_FIELDS; j++)
+		{
+			binary.read(this->ledConfig[i].customField[j]);
+		}
+		binary.read(this->ledConfig[i].ledVoltage);
+		binary.read(this->ledConfig[i].ledChannelCurrent[0]);
+		binary.read(this->ledConfig[i].ledChannelCurrent[1]);
+		binary.read(this->ledConfig[i].ledChannelCurrent[2]);
+	}
+
+	// WiFi config
+	binary.readString(this->wifiConfig.accessPointSsid);
+	binary.readString(this->wifiConfig.accessPointPassword);
+	binary.read(this->wifiConfig.accessPointChannel);
+	binary.read(this->wifiConfig.accessPointHidden);
+	binary.read(this->wifiConfig.accessPointMaxConnections);
+	binary.readString(this->wifiConfig.wifiSsid);
+	binary.readString(this->wifiConfig.wifiPassword);
+
+	// Motion sensor calibration
+	binary.read(this->motionSensorCalibration.accXRaw);
+	binary.read(this->motionSensorCalibration.accYRaw);
+	binary.read(this->motionSensorCalibration.accZRaw);
+	binary.read(this->motionSensorCalibration.gyroXRaw);
+	binary.read(this->motionSensorCalibration.gyroYRaw);
+	binary.read(this->motionSensorCalibration.gyroZRaw);
+	binary.read(this->motionSensorCalibration.accXG);
+	binary.read(this->motionSensorCalibration.accYG);
+	binary.read(this->motionSensorCalibration.accZG);
+	binary.read(this->motionSensorCalibration.gyroXDeg);
+	binary.read(this->motionSensorCalibration.gyroYDeg);
+	binary.read(this->motionSensorCalibration.gyroZDeg);
 }
 
 /**
@@ -162,6 +162,29 @@ bool TesLight::DS18B20::getResolution(const uint8_t sensorIndex, TesLight::DS18B
 	return this->resolution[sensorIndex];
 }
 
+/**
+ * @brief Start a temperature measurement on all sensors at once by using the Skip ROM command.
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::DS18B20::startMeasurement()
+{
+	if (!this->oneWire->reset())
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to reset OneWire bus. The bus lines might be shorted or a sensor is malfunctioning."));
+		return false;
+	}
+
+	this->oneWire->skip();
+	this->oneWire->write(0x44, 0);
+
+	for (uint8_t i = 0; i < this->numSensors; i++)
+	{
+		this->measurementReadyTime[i] = millis() + this->getConversionTime(this->resolution[i]);
+	}
+	return true;
+}
+
 /**
  * @brief Start a temperature measurement for a sensor with a given resolution.
  * @param sensorIndex index of the sensor
@@ -186,22 +209,7 @@ bool TesLight::DS18B20::startMeasurement(const uint8_t sensorIndex)
 	this->oneWire->select((uint8_t *)&this->sensorAddress[sensorIndex]);
 	this->oneWire->write(0x44, 0);
 
-	if (this->resolution[sensorIndex] == TesLight::DS18B20::DS18B20Res::DS18B20_9_BIT)
-	{
-		this->measurementReadyTime[sensorIndex] = millis() + 110;
-	}
-	else if (this->resolution[sensorIndex] == TesLight::DS18B20::DS18B20Res::DS18B20_10_BIT)
-	{
-		this->measurementReadyTime[sensorIndex] = millis() + 200;
-	}
-	else if (this->resolution[sensorIndex] == TesLight::DS18B20::DS18B20Res::DS18B20_11_BIT)
-	{
-		this->measurementReadyTime[sensorIndex] = millis() + 400;
-	}
-	else if (this->resolution[sensorIndex] == TesLight::DS18B20::DS18B20Res::DS18B20_12_BIT)
-	{
-		this->measurementReadyTime[sensorIndex] = millis() + 800;
-	}
+	this->measurementReadyTime[sensorIndex] = millis() + this->getConversionTime(this->resolution[sensorIndex]);
 	return true;
 }
 
@@ -320,4 +328,26 @@ bool TesLight::DS18B20::getSensors(uint8_t &sensorCount, uint64_t sensorAddresse
 		sensorCount++;
 	}
 	return true;
+}
+
+/**
+ * @brief Get the time a temperature conversion takes with a given resolution.
+ * @param resolution resolution of the sensor
+ * @return conversion time in ms
+ */
+unsigned long TesLight::DS18B20::getConversionTime(const TesLight::DS18B20::DS18B20Res resolution)
+{
+	if (resolution == TesLight::DS18B20::DS18B20Res::DS18B20_9_BIT)
+	{
+		return 110;
+	}
+	else if (resolution == TesLight::DS18B20::DS18B20Res::DS18B20_10_BIT)
+	{
+		return 200;
+	}
+	else if (resolution == TesLight::DS18B20::DS18B20Res::DS18B20_11_BIT)
+	{
+		return 400;
+	}
+	return 800;
 }
\ No newline at end of file
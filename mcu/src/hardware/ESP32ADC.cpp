@@ -8,6 +8,9 @@
  */
 #include "hardware/ESP32ADC.h"
 
+// Initialize
+uint16_t *TesLight::ESP32ADC::calibrationTable = nullptr;
+
 /**
  * @brief Create a new instance of {@link TesLight::ESP32ADC}.
  * @param inputPin physical input pin
@@ -17,6 +20,11 @@ TesLight::ESP32ADC::ESP32ADC(const uint8_t inputPin)
 	this->inputPin = inputPin;
 	this->inputMode = INPUT;
 	this->maxVoltage = 3.3f;
+	this->continuous = false;
+	this->window = nullptr;
+	this->windowIndex = 0;
+	this->windowCount = 0;
+	this->windowSum = 0;
 	this->setupPin();
 }
 
@@ -30,6 +38,11 @@ TesLight::ESP32ADC::ESP32ADC(const uint8_t inputPin, const uint8_t inputMode)
 	this->inputPin = inputPin;
 	this->inputMode = inputMode;
 	this->maxVoltage = 3.3f;
+	this->continuous = false;
+	this->window = nullptr;
+	this->windowIndex = 0;
+	this->windowCount = 0;
+	this->windowSum = 0;
 	this->setupPin();
 }
 
@@ -44,6 +57,11 @@ TesLight::ESP32ADC::ESP32ADC(const uint8_t inputPin, const uint8_t inputMode, co
 	this->inputPin = inputPin;
 	this->inputMode = inputMode;
 	this->maxVoltage = maxVoltage;
+	this->continuous = false;
+	this->window = nullptr;
+	this->windowIndex = 0;
+	this->windowCount = 0;
+	this->windowSum = 0;
 	this->setupPin();
 }
 
@@ -52,6 +70,7 @@ TesLight::ESP32ADC::ESP32ADC(const uint8_t inputPin, const uint8_t inputMode, co
  */
 TesLight::ESP32ADC::~ESP32ADC()
 {
+	this->stopContinuous();
 	pinMode(this->inputPin, INPUT);
 }
 
@@ -61,8 +80,14 @@ TesLight::ESP32ADC::~ESP32ADC()
  */
 void TesLight::ESP32ADC::setInputPin(const uint8_t inputPin)
 {
+	const bool continuous = this->continuous;
+	this->stopContinuous();
 	this->inputPin = inputPin;
 	this->setupPin();
+	if (continuous)
+	{
+		this->startContinuous();
+	}
 }
 
 /**
@@ -112,12 +137,105 @@ float TesLight::ESP32ADC::getMaxVoltage()
 }
 
 /**
- * @brief Get the raw analog value.
+ * @brief Start to sample the input continuously. The ADC is driven by the I2S peripheral, which writes the
+ * samples into DMA buffers without using the CPU. Only pins of ADC1 are supported and only one instance
+ * can sample continuously at the same time.
+ * @return true when successful
+ * @return false when the pin is not supported or the I2S driver could not be installed
+ */
+bool TesLight::ESP32ADC::startContinuous()
+{
+	if (this->continuous)
+	{
+		return true;
+	}
+
+	const int8_t channel = digitalPinToAnalogChannel(this->inputPin);
+	if (channel < 0 || channel >= ADC1_CHANNEL_MAX)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Pin ") + this->inputPin + F(" can not be sampled continuously because it is not connected to ADC1."));
+		return false;
+	}
+
+	i2s_config_t config = {};
+	config.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_ADC_BUILT_IN);
+	config.sample_rate = ADC_SAMPLE_RATE;
+	config.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+	config.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;
+	config.communication_format = I2S_COMM_FORMAT_STAND_I2S;
+	config.intr_alloc_flags = 0;
+	config.dma_buf_count = ADC_DMA_BUFFER_COUNT;
+	config.dma_buf_len = ADC_DMA_BUFFER_LENGTH;
+	config.use_apll = false;
+	if (i2s_driver_install((i2s_port_t)ADC_I2S_PORT, &config, 0, nullptr) != ESP_OK)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to install the I2S driver for the ADC."));
+		return false;
+	}
+
+	adc1_config_width(ADC_WIDTH_BIT_12);
+	adc1_config_channel_atten((adc1_channel_t)channel, ADC_ATTEN_DB_11);
+	if (i2s_set_adc_mode(ADC_UNIT_1, (adc1_channel_t)channel) != ESP_OK || i2s_adc_enable((i2s_port_t)ADC_I2S_PORT) != ESP_OK)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to enable the ADC on the I2S peripheral."));
+		i2s_driver_uninstall((i2s_port_t)ADC_I2S_PORT);
+		return false;
+	}
+
+	this->window = new uint16_t[ADC_FILTER_WINDOW_SIZE];
+	this->windowIndex = 0;
+	this->windowCount = 0;
+	this->windowSum = 0;
+	this->continuous = true;
+	return true;
+}
+
+/**
+ * @brief Stop the continuous sampling and release the I2S peripheral.
+ */
+void TesLight::ESP32ADC::stopContinuous()
+{
+	if (!this->continuous)
+	{
+		return;
+	}
+
+	i2s_adc_disable((i2s_port_t)ADC_I2S_PORT);
+	i2s_driver_uninstall((i2s_port_t)ADC_I2S_PORT);
+	delete[] this->window;
+	this->window = nullptr;
+	this->continuous = false;
+	this->setupPin();
+}
+
+/**
+ * @brief Check if the input is sampled continuously.
+ * @return true when the input is sampled continuously
+ * @return false when the input is read on request
+ */
+bool TesLight::ESP32ADC::isContinuous()
+{
+	return this->continuous;
+}
+
+/**
+ * @brief Get the raw analog value. When sampling continuously, this is the mean of the latest samples.
+ * Otherwise the value is read from the ADC, which is blocking.
  * @return uint16_t raw analog value
  */
 uint16_t TesLight::ESP32ADC::getAnalogValue()
 {
-	return analogRead(this->inputPin);
+	if (!this->continuous)
+	{
+		return analogRead(this->inputPin);
+	}
+
+	this->readContinuous();
+	if (this->windowCount == 0)
+	{
+		return 0;
+	}
+	return (this->windowSum + this->windowCount / 2) / this->windowCount;
 }
 
 /**
@@ -127,16 +245,16 @@ uint16_t TesLight::ESP32ADC::getAnalogValue()
  */
 float TesLight::ESP32ADC::getAnalogVoltage(const bool usePolynomialCorrection)
 {
-	const double analogValue = this->getAnalogValue();
-	if (analogValue < 1.0f || analogValue > 4095.0f)
+	const uint16_t analogValue = this->getAnalogValue();
+	if (analogValue < 1 || analogValue > 4095)
 	{
 		return 0.0f;
 	}
 
 	if (usePolynomialCorrection)
 	{
-		const double correctedVoltage = -0.000000000000016 * pow(analogValue, 4) + 0.000000000118171 * pow(analogValue, 3) - 0.000000301211691 * pow(analogValue, 2) + 0.001109019271794 * analogValue + 0.034143524634089;
-		return correctedVoltage / 3.14f * this->maxVoltage;
+		TesLight::ESP32ADC::createCalibrationTable();
+		return TesLight::ESP32ADC::calibrationTable[analogValue] / 3140.0f * this->maxVoltage;
 	}
 	else
 	{
@@ -152,3 +270,51 @@ void TesLight::ESP32ADC::setupPin()
 	pinMode(this->inputPin, this->inputMode);
 	analogReadResolution(12);
 }
+
+/**
+ * @brief Move the samples from the DMA buffers into the filter window and update the sum of the window.
+ */
+void TesLight::ESP32ADC::readContinuous()
+{
+	uint16_t buffer[ADC_DMA_READ_SIZE];
+	size_t bytesRead = 0;
+	while (i2s_read((i2s_port_t)ADC_I2S_PORT, buffer, sizeof(buffer), &bytesRead, 0) == ESP_OK && bytesRead > 0)
+	{
+		for (uint16_t i = 0; i < bytesRead / sizeof(uint16_t); i++)
+		{
+			// The upper 4 bits contain the channel
+			const uint16_t value = buffer[i] & 0x0FFF;
+			if (this->windowCount == ADC_FILTER_WINDOW_SIZE)
+			{
+				this->windowSum -= this->window[this->windowIndex];
+			}
+			else
+			{
+				this->windowCount++;
+			}
+			this->window[this->windowIndex] = value;
+			this->windowSum += value;
+			this->windowIndex = (this->windowIndex + 1) % ADC_FILTER_WINDOW_SIZE;
+		}
+	}
+}
+
+/**
+ * @brief Create the calibration table once. It contains the corrected voltage in mV for every raw value of the ADC,
+ * so that the polynomial correction doesn't need to be calculated on every read.
+ */
+void TesLight::ESP32ADC::createCalibrationTable()
+{
+	if (TesLight::ESP32ADC::calibrationTable != nullptr)
+	{
+		return;
+	}
+
+	TesLight::ESP32ADC::calibrationTable = new uint16_t[4096];
+	for (uint16_t i = 0; i < 4096; i++)
+	{
+		const double analogValue = i;
+		const double correctedVoltage = -0.000000000000016 * pow(analogValue, 4) + 0.000000000118171 * pow(analogValue, 3) - 0.000000301211691 * pow(analogValue, 2) + 0.001109019271794 * analogValue + 0.034143524634089;
+		TesLight::ESP32ADC::calibrationTable[i] = correctedVoltage * 1000.0 + 0.5;
+	}
+}
@@ -17,6 +17,11 @@ TesLight::FanController::FanController(const uint8_t fanPin, TesLight::Configura
 {
 	this->fanPin = fanPin;
 	this->configuration = configuration;
+	this->thermalModel = new TesLight::ThermalModel(FAN_THERMAL_RESISTANCE, FAN_THERMAL_TIME_CONSTANT);
+	this->pidController = new TesLight::PidController(FAN_CONTROL_KP, FAN_CONTROL_KI, FAN_CONTROL_KD, 0.0f, 1.0f);
+	this->lastUpdate = 0;
+	this->predictedTemperature = 0.0f;
+	this->pwm = 0;
 	ledcSetup(FAN_PWM_CHANNEL, FAN_PWM_FREQUENCY, FAN_PWM_RESOLUTION);
 	ledcAttachPin(this->fanPin, FAN_PWM_CHANNEL);
 }
@@ -27,34 +32,71 @@ TesLight::FanController::FanController(const uint8_t fanPin, TesLight::Configura
 TesLight::FanController::~FanController()
 {
 	ledcDetachPin(this->fanPin);
+	delete this->thermalModel;
+	this->thermalModel = nullptr;
+	delete this->pidController;
+	this->pidController = nullptr;
 }
 
 /**
- * @brief Set the temperature to calculate the new fan speed.
- * @param temp current temperature
+ * @brief Update the fan speed based on the measured temperature and the current LED power draw.
+ * The power draw is used to predict the regulator temperature before it actually rises, so the fan can start early.
+ * A PID controller keeps the predicted temperature below the high temperature of the regulators.
+ * Below the minimum temperature the fan is turned off, above the maximum temperature it runs at full speed.
+ * @param temperature current temperature in °C
+ * @param power current power draw of the LEDs in W
  */
-void TesLight::FanController::setTemperature(const uint8_t temp)
+void TesLight::FanController::update(const float temperature, const float power)
 {
 	const TesLight::Configuration::SystemConfig systemConfig = this->configuration->getSystemConfig();
+	const unsigned long now = micros();
+	const float timeStep = this->lastUpdate == 0 ? 0.0f : (now - this->lastUpdate) / 1000000.0f;
+	this->lastUpdate = now;
 
-	// Convert the temperature into a value between 0 and 1 within the min/max limits
-	float temperature = temp;
-	if (temperature < systemConfig.fanMinTemperature)
+	this->thermalModel->update(temperature, power, timeStep);
+	this->predictedTemperature = this->thermalModel->predictTemperature(FAN_PREDICTION_HORIZON);
+
+	// Turn the fan off while it is cold and run it at full speed when it is too hot
+	if (this->predictedTemperature < systemConfig.fanMinTemperature)
 	{
-		temperature = systemConfig.fanMinTemperature;
+		this->pidController->reset();
+		this->pwm = 0;
+		ledcWrite(FAN_PWM_CHANNEL, this->pwm);
+		return;
 	}
-	else if (temperature > systemConfig.fanMaxTemperature)
+	else if (temperature >= systemConfig.fanMaxTemperature)
 	{
-		temperature = systemConfig.fanMaxTemperature;
+		this->pwm = systemConfig.fanMaxPwmValue;
+		ledcWrite(FAN_PWM_CHANNEL, this->pwm);
+		return;
 	}
-	temperature = (temperature - systemConfig.fanMinTemperature) / (systemConfig.fanMaxTemperature - systemConfig.fanMinTemperature);
 
-	// Based on the temperature value, calculate the pwm value
-	uint16_t pwm = temperature == 0.0f ? 0.0f : (systemConfig.fanMaxPwmValue - systemConfig.fanMinPwmValue) * temperature + systemConfig.fanMinPwmValue;
-	if (pwm > systemConfig.fanMaxPwmValue)
+	// Keep the predicted temperature a bit below the temperature where the brightness is reduced
+	float setpoint = (float)systemConfig.regulatorHighTemperature - FAN_CONTROL_TEMP_MARGIN;
+	if (setpoint < systemConfig.fanMinTemperature)
 	{
-		pwm = systemConfig.fanMaxPwmValue;
+		setpoint = systemConfig.fanMinTemperature;
 	}
 
-	ledcWrite(FAN_PWM_CHANNEL, pwm);
+	const float output = this->pidController->update(this->predictedTemperature - setpoint, timeStep);
+	this->pwm = output == 0.0f ? 0 : (systemConfig.fanMaxPwmValue - systemConfig.fanMinPwmValue) * output + systemConfig.fanMinPwmValue;
+	ledcWrite(FAN_PWM_CHANNEL, this->pwm);
+}
+
+/**
+ * @brief Get the predicted regulator temperature from the last update.
+ * @return predicted temperature in °C
+ */
+float TesLight::FanController::getPredictedTemperature()
+{
+	return this->predictedTemperature;
+}
+
+/**
+ * @brief Get the pwm value that is currently output to the fan.
+ * @return pwm value of the fan
+ */
+uint8_t TesLight::FanController::getPwm()
+{
+	return this->pwm;
 }
@@ -17,6 +17,8 @@ TesLight::MPU6050::MPU6050(const uint8_t deviceAddress)
 	this->deviceAddress = deviceAddress;
 	this->accScale = TesLight::MPU6050::MPU6050AccScale::SCALE_2G;
 	this->gyScale = TesLight::MPU6050::MPU6050GyScale::SCALE_250DS;
+	this->accScaleInv = 1.0f / TesLight::MPU6050::getScaleDiv(this->accScale);
+	this->gyScaleInv = 1.0f / TesLight::MPU6050::getScaleDiv(this->gyScale);
 }
 
 /**
@@ -30,6 +32,8 @@ TesLight::MPU6050::MPU6050(const uint8_t deviceAddress, const TesLight::MPU6050:
 	this->deviceAddress = deviceAddress;
 	this->accScale = accScale;
 	this->gyScale = gyScale;
+	this->accScaleInv = 1.0f / TesLight::MPU6050::getScaleDiv(this->accScale);
+	this->gyScaleInv = 1.0f / TesLight::MPU6050::getScaleDiv(this->gyScale);
 }
 
 /**
@@ -113,6 +117,7 @@ bool TesLight::MPU6050::sleep()
 bool TesLight::MPU6050::setAccScale(TesLight::MPU6050::MPU6050AccScale accScale)
 {
 	this->accScale = accScale;
+	this->accScaleInv = 1.0f / TesLight::MPU6050::getScaleDiv(this->accScale);
 	Wire.beginTransmission(this->deviceAddress);
 	Wire.write(0x1C);
 	Wire.write(this->accScale);
@@ -142,6 +147,7 @@ TesLight::MPU6050::MPU6050AccScale TesLight::MPU6050::getAccScale()
 bool TesLight::MPU6050::setGyScale(TesLight::MPU6050::MPU6050GyScale gyScale)
 {
 	this->gyScale = gyScale;
+	this->gyScaleInv = 1.0f / TesLight::MPU6050::getScaleDiv(this->gyScale);
 	Wire.beginTransmission(this->deviceAddress);
 	Wire.write(0x1B);
 	Wire.write(this->gyScale);
@@ -163,67 +169,202 @@ TesLight::MPU6050::MPU6050GyScale TesLight::MPU6050::getGyScale()
 }
 
 /**
- * @brief Read the current sensor data.
+ * @brief Read the current sensor data with a single burst read of the registers 0x3B to 0x48.
  * @param motionData structure containing all data
  * @return true when successful
  * @return false when there was an error
  */
 bool TesLight::MPU6050::getData(TesLight::MPU6050::MPU6050MotionData &motionData)
 {
-	// Request the 6 acc registers
-	Wire.beginTransmission(this->deviceAddress);
-	Wire.write(0x3B);
-	if (Wire.endTransmission(false) != 0 || Wire.requestFrom(this->deviceAddress, 6, true) != 6 || Wire.available() != 6)
+	uint8_t buffer[14];
+	if (!this->readRegisters(0x3B, buffer, 14))
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("I²C communication error. Failed to request 6 acc registers of MPU6050 sensor."));
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("I²C communication error. Failed to request 14 data registers of MPU6050 sensor."));
 		return false;
 	}
 
-	// Read the acc values
-	motionData.accXRaw = (Wire.read() << 8 | Wire.read());
-	motionData.accYRaw = (Wire.read() << 8 | Wire.read());
-	motionData.accZRaw = (Wire.read() << 8 | Wire.read());
+	this->convertSample(buffer, motionData);
+	return true;
+}
 
-	// Request the 6 gyro registers
-	Wire.beginTransmission(this->deviceAddress);
-	Wire.write(0x43);
-	if (Wire.endTransmission(false) != 0 || Wire.requestFrom(this->deviceAddress, 6, true) != 6 || Wire.available() != 6)
+/**
+ * @brief Enable the hardware FIFO. The sensor will write the acc, temperature and gyro data to the FIFO at a fixed rate.
+ * @param sampleRateDivider sample rate divider, the sample rate is 1kHz / (1 + divider)
+ * @return true when successful
+ * @return false when there was a communication error
+ */
+bool TesLight::MPU6050::enableFifo(const uint8_t sampleRateDivider)
+{
+	// Enable the digital low pass filter, which sets the gyro output rate to 1kHz
+	// Set the sample rate divider
+	// Write acc (0x08), temperature (0x80) and gyro (0x70) data to the FIFO, which is the same order as the data registers
+	if (!this->writeRegister(0x1A, 0x01) || !this->writeRegister(0x19, sampleRateDivider) || !this->writeRegister(0x23, 0xF8))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("I²C communication error. Failed to configure FIFO of MPU6050 sensor."));
+		return false;
+	}
+
+	return this->resetFifo();
+}
+
+/**
+ * @brief Disable the hardware FIFO.
+ * @return true when successful
+ * @return false when there was a communication error
+ */
+bool TesLight::MPU6050::disableFifo()
+{
+	if (!this->writeRegister(0x23, 0x00) || !this->writeRegister(0x6A, 0x00))
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("I²C communication error. Failed to request 6 gyro registers of MPU6050 sensor."));
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("I²C communication error. Failed to disable FIFO of MPU6050 sensor."));
 		return false;
 	}
+	return true;
+}
 
-	// Read the rotation values
-	motionData.gyroXRaw = (Wire.read() << 8 | Wire.read());
-	motionData.gyroYRaw = (Wire.read() << 8 | Wire.read());
-	motionData.gyroZRaw = (Wire.read() << 8 | Wire.read());
+/**
+ * @brief Clear the hardware FIFO and enable it.
+ * @return true when successful
+ * @return false when there was a communication error
+ */
+bool TesLight::MPU6050::resetFifo()
+{
+	if (!this->writeRegister(0x6A, 0x04) || !this->writeRegister(0x6A, 0x40))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("I²C communication error. Failed to reset FIFO of MPU6050 sensor."));
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Enable or disable the data ready interrupt.
+ * The interrupt pin is active high and a pulse is generated each time a new sample is available.
+ * @param enabled true to enable the interrupt
+ * @return true when successful
+ * @return false when there was a communication error
+ */
+bool TesLight::MPU6050::setDataReadyInterrupt(const bool enabled)
+{
+	if (!this->writeRegister(0x37, 0x00) || !this->writeRegister(0x38, enabled ? 0x01 : 0x00))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("I²C communication error. Failed to configure interrupt of MPU6050 sensor."));
+		return false;
+	}
+	return true;
+}
 
-	// Request the 2 temperature registers
+/**
+ * @brief Read the samples collected in the hardware FIFO.
+ * When the FIFO overflowed, it is cleared and no samples are returned.
+ * @param motionData array for the samples
+ * @param maxCount maximum number of samples to read
+ * @param count number of samples which were read
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::MPU6050::getFifoData(TesLight::MPU6050::MPU6050MotionData *motionData, const uint16_t maxCount, uint16_t &count)
+{
+	count = 0;
+	uint8_t buffer[126];
+	if (!this->readRegisters(0x72, buffer, 2))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("I²C communication error. Failed to read FIFO count of MPU6050 sensor."));
+		return false;
+	}
+
+	const uint16_t fifoCount = buffer[0] << 8 | buffer[1];
+	if (fifoCount >= 1024 - 14 || fifoCount % 14 != 0)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The FIFO of the MPU6050 sensor overflowed. It will be cleared."));
+		return this->resetFifo();
+	}
+
+	const uint16_t sampleCount = fifoCount / 14 < maxCount ? fifoCount / 14 : maxCount;
+	while (count < sampleCount)
+	{
+		const uint8_t batchSize = sampleCount - count < sizeof(buffer) / 14 ? sampleCount - count : sizeof(buffer) / 14;
+		if (!this->readRegisters(0x74, buffer, batchSize * 14))
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("I²C communication error. Failed to read FIFO of MPU6050 sensor."));
+			return false;
+		}
+
+		for (uint8_t i = 0; i < batchSize; i++)
+		{
+			this->convertSample(buffer + i * 14, motionData[count++]);
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @brief Write a single register of the MPU6050.
+ * @param reg register address
+ * @param value value to write
+ * @return true when successful
+ * @return false when there was a communication error
+ */
+bool TesLight::MPU6050::writeRegister(const uint8_t reg, const uint8_t value)
+{
+	Wire.beginTransmission(this->deviceAddress);
+	Wire.write(reg);
+	Wire.write(value);
+	return Wire.endTransmission(true) == 0;
+}
+
+/**
+ * @brief Read multiple registers of the MPU6050 in a single transaction.
+ * @param reg address of the first register
+ * @param buffer buffer for the values
+ * @param length number of registers to read
+ * @return true when successful
+ * @return false when there was a communication error
+ */
+bool TesLight::MPU6050::readRegisters(const uint8_t reg, uint8_t *buffer, const uint8_t length)
+{
 	Wire.beginTransmission(this->deviceAddress);
-	Wire.write(0x41);
-	if (Wire.endTransmission(false) != 0 || Wire.requestFrom(this->deviceAddress, 2, true) != 2 || Wire.available() != 2)
+	Wire.write(reg);
+	if (Wire.endTransmission(false) != 0 || Wire.requestFrom(this->deviceAddress, length, true) != length || Wire.available() != length)
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("I²C communication error. Failed to request 2 temperature registers of MPU6050 sensor."));
 		return false;
 	}
 
-	// Read the temperature values
-	motionData.temperatureRaw = (Wire.read() << 8 | Wire.read());
+	for (uint8_t i = 0; i < length; i++)
+	{
+		buffer[i] = Wire.read();
+	}
+	return true;
+}
+
+/**
+ * @brief Convert a raw sample in the order of the data registers (acc, temperature, gyro).
+ * @param buffer 14 bytes of raw data
+ * @param motionData structure for the converted data
+ */
+void TesLight::MPU6050::convertSample(const uint8_t *buffer, TesLight::MPU6050::MPU6050MotionData &motionData)
+{
+	motionData.accXRaw = buffer[0] << 8 | buffer[1];
+	motionData.accYRaw = buffer[2] << 8 | buffer[3];
+	motionData.accZRaw = buffer[4] << 8 | buffer[5];
+	motionData.temperatureRaw = buffer[6] << 8 | buffer[7];
+	motionData.gyroXRaw = buffer[8] << 8 | buffer[9];
+	motionData.gyroYRaw = buffer[10] << 8 | buffer[11];
+	motionData.gyroZRaw = buffer[12] << 8 | buffer[13];
 
 	// Calculate G values
-	motionData.accXG = motionData.accXRaw / getScaleDiv(this->accScale);
-	motionData.accYG = motionData.accYRaw / getScaleDiv(this->accScale);
-	motionData.accZG = motionData.accZRaw / getScaleDiv(this->accScale);
+	motionData.accXG = motionData.accXRaw * this->accScaleInv;
+	motionData.accYG = motionData.accYRaw * this->accScaleInv;
+	motionData.accZG = motionData.accZRaw * this->accScaleInv;
 
 	// Calculate rotation value in degree/s
-	motionData.gyroXDeg = motionData.gyroXRaw / getScaleDiv(this->gyScale);
-	motionData.gyroYDeg = motionData.gyroYRaw / getScaleDiv(this->gyScale);
-	motionData.gyroZDeg = motionData.gyroZRaw / getScaleDiv(this->gyScale);
+	motionData.gyroXDeg = motionData.gyroXRaw * this->gyScaleInv;
+	motionData.gyroYDeg = motionData.gyroYRaw * this->gyScaleInv;
+	motionData.gyroZDeg = motionData.gyroZRaw * this->gyScaleInv;
 
 	// Calculate the temeprature from raw value
 	motionData.temperatureDeg = motionData.temperatureRaw / 340.0f + 36.53f;
-
-	return true;
 }
 
 /**
@@ -12,18 +12,38 @@
 /**
  * @brief Create a new instance of {@link TesLight::LedManager}.
  * @param config pointer to the configuration
+ * @param fseqIndex pointer to the index of the fseq files
  */
-TesLight::LedManager::LedManager(TesLight::Configuration *config)
+TesLight::LedManager::LedManager(TesLight::Configuration *config, TesLight::FseqIndex *fseqIndex)
 {
 	this->config = config;
+	this->fseqIndex = fseqIndex;
 	for (uint8_t i = 0; i < LED_NUM_ZONES; i++)
 	{
 		this->ledData[i] = nullptr;
 		this->ledAnimator[i] = nullptr;
+		this->previousAnimator[i] = nullptr;
+		this->transitionData[i] = nullptr;
+		this->transitionStart[i] = 0;
+		memset(this->zonePowerCoefficient[i], 0, sizeof(this->zonePowerCoefficient[i]));
+		this->zoneRegulator[i] = 0;
 	}
 	this->fseqLoader = nullptr;
+	this->streamReceiver = nullptr;
+	this->previousFseqLoader = nullptr;
+	this->previousStreamReceiver = nullptr;
 	this->targetFrameTime = LED_FRAME_TIME;
-	this->regulatorTemperature = 0.0f;
+	this->transitionTime = ANIMATOR_TRANSITION_TIME;
+	this->appliedLedConfigValid = false;
+	for (uint8_t i = 0; i < REGULATOR_COUNT; i++)
+	{
+		this->regulatorTemperature[i] = 0.0f;
+		this->framePower[i] = 0.0f;
+		this->frameLimited[i] = false;
+	}
+	memset(&this->motionSensorData, 0, sizeof(this->motionSensorData));
+	this->renderStart = 0;
+	this->frameDuration = 0;
 }
 
 /**
@@ -36,25 +56,104 @@ TesLight::LedManager::~LedManager()
 
 /**
  * @brief Clear and create new LED data and animators from the configuration.
+ * When the LED layout did not change, the old animators are kept alive to crossfade into the new ones.
  * @return true when successful
  * @return false when there was an error
  */
 bool TesLight::LedManager::reloadAnimations()
 {
-	this->clearAnimations();
-
-	if (!this->createLedData())
+	if (this->transitionTime > 0 && this->appliedLedConfigValid && !this->isLayoutChanged())
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to create new LED data."));
-		return false;
+		this->beginTransition();
+	}
+	else
+	{
+		this->clearAnimations();
+		if (!this->createLedData())
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to create new LED data."));
+			return false;
+		}
 	}
 
 	if (!this->createAnimators())
 	{
 		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to create new animators."));
+		this->finishTransitions();
 		return false;
 	}
 
+	for (uint8_t i = 0; i < LED_NUM_ZONES; i++)
+	{
+		if (this->previousAnimator[i] != nullptr)
+		{
+			this->ledAnimator[i]->setAmbientBrightness(this->previousAnimator[i]->getAmbientBrightness());
+		}
+		this->appliedLedConfig[i] = this->config->getLedConfig(i);
+		this->updatePowerCoefficients(i, this->appliedLedConfig[i]);
+	}
+	this->appliedLedConfigValid = true;
+
+	return true;
+}
+
+/**
+ * @brief Apply a changed LED configuration to the running animators.
+ * A full reload is only done when the LED pin, the LED count or the animation source has changed.
+ * All other values are pushed into the live animators without resetting them.
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::LedManager::updateAnimations()
+{
+	if (this->isReloadRequired())
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, F("The LED configuration requires a full reload of the LEDs and animators."));
+		return this->reloadAnimations();
+	}
+
+	const bool calculatedAnimation = this->fseqLoader == nullptr && this->streamReceiver == nullptr;
+	for (uint8_t i = 0; i < LED_NUM_ZONES; i++)
+	{
+		const TesLight::Configuration::LedConfig ledConfig = this->config->getLedConfig(i);
+		if (calculatedAnimation && ledConfig.type != this->appliedLedConfig[i].type)
+		{
+			TesLight::LedAnimator *ledAnimator = this->createCalculatedAnimator(ledConfig);
+			if (ledAnimator == nullptr)
+			{
+				TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Animator type for animator ") + String(i) + F(" is unknown. Invalid value ") + String(ledConfig.type) + F("."));
+				this->appliedLedConfigValid = false;
+				return false;
+			}
+
+			ledAnimator->setPixels(this->ledData[i]);
+			ledAnimator->setPixelCount(ledConfig.ledCount);
+			ledAnimator->setAmbientBrightness(this->ledAnimator[i]->getAmbientBrightness());
+			if (this->transitionTime > 0)
+			{
+				this->startZoneTransition(i);
+			}
+			else
+			{
+				delete this->ledAnimator[i];
+			}
+			this->ledAnimator[i] = ledAnimator;
+			this->applyAnimatorSettings(i, ledConfig);
+			this->ledAnimator[i]->init();
+		}
+		else
+		{
+			if (calculatedAnimation)
+			{
+				this->applyAnimatorColor(i, ledConfig);
+			}
+			this->applyAnimatorSettings(i, ledConfig);
+		}
+
+		this->appliedLedConfig[i] = ledConfig;
+		this->updatePowerCoefficients(i, ledConfig);
+	}
+
 	return true;
 }
 
@@ -64,6 +163,8 @@ bool TesLight::LedManager::reloadAnimations()
 void TesLight::LedManager::clearAnimations()
 {
 	FastLED.clear();
+	this->finishTransitions();
+	this->appliedLedConfigValid = false;
 
 	for (uint8_t i = 0; i < LED_NUM_ZONES; i++)
 	{
@@ -84,6 +185,12 @@ void TesLight::LedManager::clearAnimations()
 		delete this->fseqLoader;
 		this->fseqLoader = nullptr;
 	}
+
+	if (this->streamReceiver != nullptr)
+	{
+		delete this->streamReceiver;
+		this->streamReceiver = nullptr;
+	}
 }
 
 /**
@@ -141,87 +248,132 @@ uint32_t TesLight::LedManager::getTargetFrameTime()
 }
 
 /**
- * @brief Set the current motion sensor data.
- * @param motionSensorData instance of the {@link TesLight::MotionSensor::MotionSensorData}
+ * @brief Set the duration of the crossfade between the old and new animations.
+ * @param transitionTime duration of the transition in microseconds, 0 to disable the transition
  */
-void TesLight::LedManager::setMotionSensorData(const TesLight::MotionSensor::MotionSensorData motionSensorData)
+void TesLight::LedManager::setTransitionTime(const uint32_t transitionTime)
 {
-	for (uint8_t i = 0; i < LED_NUM_ZONES; i++)
-	{
-		if (this->ledAnimator[i] != nullptr)
-		{
-			this->ledAnimator[i]->setMotionSensorData(motionSensorData);
-		}
-		else
-		{
-			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to set motion sensor data for animator ") + String(i) + F(" because the animator is null."));
-		}
-	}
+	this->transitionTime = transitionTime;
 }
 
 /**
- * @brief Get the currently set and used motion sensor data.
- * @param motionSensorData reference to a {@link TesLight::MotionSensor::MotionSensorData}
- * @return true when the data was read successfully
- * @return false when there was an error
+ * @brief Get the duration of the crossfade between the old and new animations.
+ * @return duration of the transition in microseconds
  */
-bool TesLight::LedManager::getMotionSensorData(TesLight::MotionSensor::MotionSensorData &motionSensorData)
+uint32_t TesLight::LedManager::getTransitionTime()
 {
-	if (this->ledAnimator[0] != nullptr)
-	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Failed to get motion sensor data because animator with index 0 was null."));
-		return false;
-	}
+	return this->transitionTime;
+}
 
-	motionSensorData = this->ledAnimator[0]->getMotionSensorData();
-	return true;
+/**
+ * @brief Update the motion sensor data shared by all animators. The motion is interpolated to the expected
+ * presentation time of the next frame, which is estimated from the duration of the previous frame.
+ * @param motionSensor reference to the {@link TesLight::MotionSensor}
+ */
+void TesLight::LedManager::updateMotionSensorData(TesLight::MotionSensor *motionSensor)
+{
+	motionSensor->getMotion(micros() + this->frameDuration, this->motionSensorData);
 }
 
 /**
- * @brief Set the regulator temperature. Once a critical temperature is reached, the brightness will be reduced.
- * @param regulatorTemperature temperature of the generator in degree celsius.
+ * @brief Get the motion sensor data used for the current frame.
+ * @return motion sensor data of the current frame
  */
-void TesLight::LedManager::setRegulatorTemperature(const float regulatorTemperature)
+TesLight::MotionSensor::MotionSensorData TesLight::LedManager::getMotionSensorData()
 {
-	this->regulatorTemperature = regulatorTemperature;
+	return this->motionSensorData;
 }
 
 /**
- * @brief Get the currently set regulator temperature. This is not reading the temperature from the sensors.
+ * @brief Set the temperature of a regulator. Once a critical temperature is reached,
+ * the brightness of the zones fed by this regulator will be reduced.
+ * @param regulatorIndex index of the regulator
+ * @param regulatorTemperature temperature of the regulator in degree celsius.
+ */
+void TesLight::LedManager::setRegulatorTemperature(const uint8_t regulatorIndex, const float regulatorTemperature)
+{
+	if (regulatorIndex < REGULATOR_COUNT)
+	{
+		this->regulatorTemperature[regulatorIndex] = regulatorTemperature;
+	}
+}
+
+/**
+ * @brief Get the currently set temperature of a regulator. This is not reading the temperature from the sensors.
+ * @param regulatorIndex index of the regulator
  * @return currently set regulator temperature in degree celsius
  */
-float TesLight::LedManager::getRegulatorTemperature()
+float TesLight::LedManager::getRegulatorTemperature(const uint8_t regulatorIndex)
 {
-	return this->regulatorTemperature;
+	return regulatorIndex < REGULATOR_COUNT ? this->regulatorTemperature[regulatorIndex] : 0.0f;
 }
 
 /**
- * @brief Get the total power draw of all LEDs that has been calculated.
+ * @brief Get the total power draw of all LEDs that has been calculated for the last rendered frame.
  * @return total power draw in W
  */
 float TesLight::LedManager::getLedPowerDraw()
 {
-	float regulatorPower[REGULATOR_COUNT];
-	if (!this->calculateRegulatorPowerDraw(regulatorPower))
-	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Failed to calculate power draw."));
-		return 0.0f;
-	}
-
 	float sum = 0.0f;
 	for (uint8_t i = 0; i < REGULATOR_COUNT; i++)
 	{
-		sum += regulatorPower[i];
+		sum += this->framePower[i];
 	}
 
 	return sum;
 }
 
+/**
+ * @brief Get the power draw of a regulator that has been calculated for the last rendered frame.
+ * @param regulatorIndex index of the regulator
+ * @return power draw in W
+ */
+float TesLight::LedManager::getRegulatorPowerDraw(const uint8_t regulatorIndex)
+{
+	return regulatorIndex < REGULATOR_COUNT ? this->framePower[regulatorIndex] : 0.0f;
+}
+
+/**
+ * @brief Check if the brightness of the zones fed by a regulator was reduced in the last rendered frame.
+ * @param regulatorIndex index of the regulator
+ * @return true when the power or temperature limit was reached
+ * @return false when the zones were rendered with full brightness
+ */
+bool TesLight::LedManager::isRegulatorLimited(const uint8_t regulatorIndex)
+{
+	return regulatorIndex < REGULATOR_COUNT && this->frameLimited[regulatorIndex];
+}
+
+/**
+ * @brief Receive pending realtime packets when the streaming mode is active.
+ * This should be called on every loop to keep the network buffers empty.
+ */
+void TesLight::LedManager::receiveStream()
+{
+	if (this->streamReceiver != nullptr)
+	{
+		this->streamReceiver->receive();
+	}
+}
+
 /**
  * @brief Render all LEDs using their animators.
  */
 bool TesLight::LedManager::render()
 {
+	this->renderStart = micros();
+	if (this->streamReceiver != nullptr)
+	{
+		this->streamReceiver->receive();
+		this->streamReceiver->nextFrame();
+	}
+	if (this->previousStreamReceiver != nullptr)
+	{
+		this->previousStreamReceiver->receive();
+		this->previousStreamReceiver->nextFrame();
+	}
+
+	bool transitionActive = false;
 	for (uint8_t i = 0; i < LED_NUM_ZONES; i++)
 	{
 		if (this->ledAnimator[i] != nullptr)
@@ -233,18 +385,22 @@ bool TesLight::LedManager::render()
 			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to render LEDs with animator ") + String(i) + F(" because the animator is null."));
 			return false;
 		}
+
+		if (this->previousAnimator[i] != nullptr)
+		{
+			this->renderZoneTransition(i);
+			transitionActive = transitionActive || this->previousAnimator[i] != nullptr;
+		}
 	}
 
-	if (!this->limitPowerConsumption())
+	if (!transitionActive && (this->previousFseqLoader != nullptr || this->previousStreamReceiver != nullptr))
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to limit LED power consumption after rendering."));
-		return false;
+		this->finishTransitions();
 	}
 
-	if (!this->limitRegulatorTemperature())
+	if (!this->limitRegulatorPower())
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to limit regulator temperature after rendering."));
-
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to limit regulator power after rendering."));
 		return false;
 	}
 
@@ -257,6 +413,7 @@ bool TesLight::LedManager::render()
 void TesLight::LedManager::show()
 {
 	FastLED.show();
+	this->frameDuration = micros() - this->renderStart;
 }
 
 /**
@@ -320,10 +477,17 @@ bool TesLight::LedManager::createAnimators()
 	// Custom animations will be used when the first animator type is set to 255
 	// The used file identifier is set by the custom fields [10-13]
 	// Field 14 is reserved to store the previous, calculated animation type
+	// Realtime streaming over the network will be used when the first animator type is set to 254
 	const bool customAnimation = this->config->getLedConfig(0).type == 255;
+	const bool streamAnimation = this->config->getLedConfig(0).type == 254;
 	uint32_t identifier = 0;
 	memcpy(&identifier, &this->config->getLedConfig(0).customField[10], sizeof(identifier));
-	if (!customAnimation)
+	if (streamAnimation)
+	{
+		this->setTargetFrameTime(LED_FRAME_TIME);
+		return this->loadStreamAnimation();
+	}
+	else if (!customAnimation)
 	{
 		this->setTargetFrameTime(LED_FRAME_TIME);
 		return this->loadCalculatedAnimations();
@@ -331,13 +495,22 @@ bool TesLight::LedManager::createAnimators()
 	else
 	{
 		String fileName;
-		if (TesLight::FileUtil::getFileNameFromIdentifier(&SD, FSEQ_DIRECTORY, identifier, fileName) && fileName.length() > 0)
+		if (!this->fseqIndex->getFileName(identifier, fileName))
+		{
+			// Files might have been copied to the SD card directly, so the index is rebuilt once before giving up
+			TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("Animation file with id ") + String(identifier) + F(" is not indexed. Rebuilding the fseq index."));
+			this->fseqIndex->rebuild();
+			this->fseqIndex->getFileName(identifier, fileName);
+		}
+
+		if (fileName.length() > 0)
 		{
 			this->fseqLoader = new TesLight::FseqLoader(&SD);
 			if (!this->fseqLoader->loadFromFile(FSEQ_DIRECTORY + (String)F("/") + fileName))
 			{
 				TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to load fseq file. Cleaning FseqLoader."));
 				delete this->fseqLoader;
+				this->fseqLoader = nullptr;
 				return false;
 			}
 		}
@@ -364,145 +537,139 @@ bool TesLight::LedManager::loadCalculatedAnimations()
 	for (uint8_t i = 0; i < LED_NUM_ZONES; i++)
 	{
 		const TesLight::Configuration::LedConfig ledConfig = this->config->getLedConfig(i);
-
-		// Rainbow solid type
-		if (ledConfig.type == 0)
+		ledAnimator[i] = this->createCalculatedAnimator(ledConfig);
+		if (ledAnimator[i] == nullptr)
 		{
-			ledAnimator[i] = new TesLight::RainbowAnimator(TesLight::RainbowAnimator::RainbowMode::RAINBOW_SOLID);
-		}
-
-		// Rainbow linear type
-		else if (ledConfig.type == 1)
-		{
-			ledAnimator[i] = new TesLight::RainbowAnimator(TesLight::RainbowAnimator::RainbowMode::RAINBOW_LINEAR);
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Animator type for animator ") + String(i) + F(" is unknown. Invalid value ") + String(ledConfig.type) + F("."));
+			return false;
 		}
 
-		// Rainbow middle type
-		else if (ledConfig.type == 2)
-		{
-			ledAnimator[i] = new TesLight::RainbowAnimator(TesLight::RainbowAnimator::RainbowMode::RAINBOW_CENTER);
-		}
+		ledAnimator[i]->setPixels(this->ledData[i]);
+		ledAnimator[i]->setPixelCount(ledConfig.ledCount);
+		this->applyAnimatorSettings(i, ledConfig);
+		ledAnimator[i]->init();
+	}
 
-		// Gradient linear type
-		else if (ledConfig.type == 3)
-		{
-			ledAnimator[i] = new TesLight::GradientAnimator(TesLight::GradientAnimator::GradientMode::GRADIENT_LINEAR, CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]), CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]));
-		}
+	return true;
+}
 
-		// Gradient center type
-		else if (ledConfig.type == 4)
-		{
-			ledAnimator[i] = new TesLight::GradientAnimator(TesLight::GradientAnimator::GradientMode::GRADIENT_CENTER, CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]), CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]));
-		}
+/**
+ * @brief Create a new animator for a calculated animation.
+ * @param ledConfig LED configuration of the zone
+ * @return pointer to the new animator or nullptr when the type is unknown
+ */
+TesLight::LedAnimator *TesLight::LedManager::createCalculatedAnimator(const TesLight::Configuration::LedConfig &ledConfig)
+{
+	// Rainbow solid type
+	if (ledConfig.type == 0)
+	{
+		return new TesLight::RainbowAnimator(TesLight::RainbowAnimator::RainbowMode::RAINBOW_SOLID);
+	}
 
-		// Static color type
-		else if (ledConfig.type == 5)
-		{
-			ledAnimator[i] = new TesLight::StaticColorAnimator(CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]));
-		}
+	// Rainbow linear type
+	else if (ledConfig.type == 1)
+	{
+		return new TesLight::RainbowAnimator(TesLight::RainbowAnimator::RainbowMode::RAINBOW_LINEAR);
+	}
 
-		// Color bar linear hard type
-		else if (ledConfig.type == 6)
-		{
-			ledAnimator[i] = new TesLight::ColorBarAnimator(TesLight::ColorBarAnimator::ColorBarMode::COLOR_BAR_LINEAR_HARD, CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]), CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]));
-		}
+	// Rainbow middle type
+	else if (ledConfig.type == 2)
+	{
+		return new TesLight::RainbowAnimator(TesLight::RainbowAnimator::RainbowMode::RAINBOW_CENTER);
+	}
 
-		// Color bar linear smooth type
-		else if (ledConfig.type == 7)
-		{
-			ledAnimator[i] = new TesLight::ColorBarAnimator(TesLight::ColorBarAnimator::ColorBarMode::COLOR_BAR_LINEAR_SMOOTH, CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]), CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]));
-		}
+	// Gradient linear type
+	else if (ledConfig.type == 3)
+	{
+		return new TesLight::GradientAnimator(TesLight::GradientAnimator::GradientMode::GRADIENT_LINEAR, CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]), CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]));
+	}
 
-		// Color bar center hard type
-		else if (ledConfig.type == 8)
-		{
-			ledAnimator[i] = new TesLight::ColorBarAnimator(TesLight::ColorBarAnimator::ColorBarMode::COLOR_BAR_CENTER_HARD, CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]), CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]));
-		}
+	// Gradient center type
+	else if (ledConfig.type == 4)
+	{
+		return new TesLight::GradientAnimator(TesLight::GradientAnimator::GradientMode::GRADIENT_CENTER, CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]), CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]));
+	}
 
-		// Color bar center smooth type
-		else if (ledConfig.type == 9)
-		{
-			ledAnimator[i] = new TesLight::ColorBarAnimator(TesLight::ColorBarAnimator::ColorBarMode::COLOR_BAR_CENTER_SMOOTH, CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]), CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]));
-		}
+	// Static color type
+	else if (ledConfig.type == 5)
+	{
+		return new TesLight::StaticColorAnimator(CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]));
+	}
 
-		// Rainbow linear motion acc x type
-		else if (ledConfig.type == 10)
-		{
-			ledAnimator[i] = new TesLight::RainbowAnimatorMotion(TesLight::RainbowAnimatorMotion::RainbowMode::RAINBOW_LINEAR, TesLight::MotionSensor::MotionSensorValue::ACC_X_G);
-		}
+	// Color bar linear hard type
+	else if (ledConfig.type == 6)
+	{
+		return new TesLight::ColorBarAnimator(TesLight::ColorBarAnimator::ColorBarMode::COLOR_BAR_LINEAR_HARD, CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]), CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]));
+	}
 
-		// Rainbow linear motion acc y type
-		else if (ledConfig.type == 11)
-		{
-			ledAnimator[i] = new TesLight::RainbowAnimatorMotion(TesLight::RainbowAnimatorMotion::RainbowMode::RAINBOW_LINEAR, TesLight::MotionSensor::MotionSensorValue::ACC_Y_G);
-		}
+	// Color bar linear smooth type
+	else if (ledConfig.type == 7)
+	{
+		return new TesLight::ColorBarAnimator(TesLight::ColorBarAnimator::ColorBarMode::COLOR_BAR_LINEAR_SMOOTH, CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]), CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]));
+	}
 
-		// Rainbow linear motion acc x type
-		else if (ledConfig.type == 10)
-		{
-			ledAnimator[i] = new TesLight::RainbowAnimatorMotion(TesLight::RainbowAnimatorMotion::RainbowMode::RAINBOW_LINEAR, TesLight::MotionSensor::MotionSensorValue::ACC_X_G);
-		}
+	// Color bar center hard type
+	else if (ledConfig.type == 8)
+	{
+		return new TesLight::ColorBarAnimator(TesLight::ColorBarAnimator::ColorBarMode::COLOR_BAR_CENTER_HARD, CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]), CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]));
+	}
 
-		// Rainbow linear motion acc y type
-		else if (ledConfig.type == 11)
-		{
-			ledAnimator[i] = new TesLight::RainbowAnimatorMotion(TesLight::RainbowAnimatorMotion::RainbowMode::RAINBOW_LINEAR, TesLight::MotionSensor::MotionSensorValue::ACC_Y_G);
-		}
+	// Color bar center smooth type
+	else if (ledConfig.type == 9)
+	{
+		return new TesLight::ColorBarAnimator(TesLight::ColorBarAnimator::ColorBarMode::COLOR_BAR_CENTER_SMOOTH, CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]), CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]));
+	}
 
-		// Rainbow center motion acc x type
-		else if (ledConfig.type == 12)
-		{
-			ledAnimator[i] = new TesLight::RainbowAnimatorMotion(TesLight::RainbowAnimatorMotion::RainbowMode::RAINBOW_CENTER, TesLight::MotionSensor::MotionSensorValue::ACC_X_G);
-		}
+	// Rainbow linear motion acc x type
+	else if (ledConfig.type == 10)
+	{
+		return new TesLight::RainbowAnimatorMotion(TesLight::RainbowAnimatorMotion::RainbowMode::RAINBOW_LINEAR, TesLight::MotionSensor::MotionSensorValue::ACC_X_G);
+	}
 
-		// Rainbow center motion acc y type
-		else if (ledConfig.type == 13)
-		{
-			ledAnimator[i] = new TesLight::RainbowAnimatorMotion(TesLight::RainbowAnimatorMotion::RainbowMode::RAINBOW_CENTER, TesLight::MotionSensor::MotionSensorValue::ACC_Y_G);
-		}
+	// Rainbow linear motion acc y type
+	else if (ledConfig.type == 11)
+	{
+		return new TesLight::RainbowAnimatorMotion(TesLight::RainbowAnimatorMotion::RainbowMode::RAINBOW_LINEAR, TesLight::MotionSensor::MotionSensorValue::ACC_Y_G);
+	}
 
-		// Gradient linear motion acc x type
-		else if (ledConfig.type == 14)
-		{
-			ledAnimator[i] = new TesLight::GradientAnimatorMotion(TesLight::GradientAnimatorMotion::GradientMode::GRADIENT_LINEAR, TesLight::MotionSensor::MotionSensorValue::ACC_X_G, CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]), CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]));
-		}
+	// Rainbow center motion acc x type
+	else if (ledConfig.type == 12)
+	{
+		return new TesLight::RainbowAnimatorMotion(TesLight::RainbowAnimatorMotion::RainbowMode::RAINBOW_CENTER, TesLight::MotionSensor::MotionSensorValue::ACC_X_G);
+	}
 
-		// Gradient linear motion acc y type
-		else if (ledConfig.type == 15)
-		{
-			ledAnimator[i] = new TesLight::GradientAnimatorMotion(TesLight::GradientAnimatorMotion::GradientMode::GRADIENT_LINEAR, TesLight::MotionSensor::MotionSensorValue::ACC_Y_G, CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]), CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]));
-		}
+	// Rainbow center motion acc y type
+	else if (ledConfig.type == 13)
+	{
+		return new TesLight::RainbowAnimatorMotion(TesLight::RainbowAnimatorMotion::RainbowMode::RAINBOW_CENTER, TesLight::MotionSensor::MotionSensorValue::ACC_Y_G);
+	}
 
-		// Gradient center motion acc x type
-		else if (ledConfig.type == 16)
-		{
-			ledAnimator[i] = new TesLight::GradientAnimatorMotion(TesLight::GradientAnimatorMotion::GradientMode::GRADIENT_CENTER, TesLight::MotionSensor::MotionSensorValue::ACC_X_G, CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]), CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]));
-		}
+	// Gradient linear motion acc x type
+	else if (ledConfig.type == 14)
+	{
+		return new TesLight::GradientAnimatorMotion(TesLight::GradientAnimatorMotion::GradientMode::GRADIENT_LINEAR, TesLight::MotionSensor::MotionSensorValue::ACC_X_G, CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]), CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]));
+	}
 
-		// Gradient center motion acc y type
-		else if (ledConfig.type == 17)
-		{
-			ledAnimator[i] = new TesLight::GradientAnimatorMotion(TesLight::GradientAnimatorMotion::GradientMode::GRADIENT_CENTER, TesLight::MotionSensor::MotionSensorValue::ACC_Y_G, CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]), CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]));
-		}
+	// Gradient linear motion acc y type
+	else if (ledConfig.type == 15)
+	{
+		return new TesLight::GradientAnimatorMotion(TesLight::GradientAnimatorMotion::GradientMode::GRADIENT_LINEAR, TesLight::MotionSensor::MotionSensorValue::ACC_Y_G, CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]), CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]));
+	}
 
-		// Unknown type
-		else
-		{
-			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Animator type for animator ") + String(i) + F(" is unknown. Invalid value ") + String(ledConfig.type) + F("."));
-			return false;
-		}
+	// Gradient center motion acc x type
+	else if (ledConfig.type == 16)
+	{
+		return new TesLight::GradientAnimatorMotion(TesLight::GradientAnimatorMotion::GradientMode::GRADIENT_CENTER, TesLight::MotionSensor::MotionSensorValue::ACC_X_G, CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]), CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]));
+	}
 
-		ledAnimator[i]->setPixels(this->ledData[i]);
-		ledAnimator[i]->setPixelCount(ledConfig.ledCount);
-		ledAnimator[i]->setSpeed(ledConfig.speed);
-		ledAnimator[i]->setOffset(ledConfig.offset);
-		ledAnimator[i]->setAnimationBrightness(ledConfig.brightness / 255.0f);
-		ledAnimator[i]->setFadeSpeed(ledConfig.fadeSpeed / 4096.0f);
-		ledAnimator[i]->setReverse(ledConfig.reverse);
-		ledAnimator[i]->init();
+	// Gradient center motion acc y type
+	else if (ledConfig.type == 17)
+	{
+		return new TesLight::GradientAnimatorMotion(TesLight::GradientAnimatorMotion::GradientMode::GRADIENT_CENTER, TesLight::MotionSensor::MotionSensorValue::ACC_Y_G, CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]), CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]));
 	}
 
-	return true;
+	// Unknown type
+	return nullptr;
 }
 
 /**
@@ -531,11 +698,7 @@ bool TesLight::LedManager::loadCustomAnimation()
 		ledAnimator[i] = new TesLight::FseqAnimator(this->fseqLoader, true);
 		ledAnimator[i]->setPixels(this->ledData[i]);
 		ledAnimator[i]->setPixelCount(ledConfig.ledCount);
-		ledAnimator[i]->setSpeed(ledConfig.speed);
-		ledAnimator[i]->setOffset(ledConfig.offset);
-		ledAnimator[i]->setAnimationBrightness(ledConfig.brightness / 255.0f);
-		ledAnimator[i]->setFadeSpeed(ledConfig.fadeSpeed / 4096.0f);
-		ledAnimator[i]->setReverse(ledConfig.reverse);
+		this->applyAnimatorSettings(i, ledConfig);
 		ledAnimator[i]->init();
 	}
 
@@ -543,124 +706,353 @@ bool TesLight::LedManager::loadCustomAnimation()
 }
 
 /**
- * @brief Calculate the total power draw from each regulator using the current frame.
- * @param regulatorPower array containing the power draw per regulator after the call
+ * @brief Load the stream animators and start receiving realtime data over the network.
+ * The received channels are mapped to the zones in order, 3 channels per LED.
  * @return true when successful
  * @return false when there was an error
  */
-bool TesLight::LedManager::calculateRegulatorPowerDraw(float regulatorPower[REGULATOR_COUNT])
+bool TesLight::LedManager::loadStreamAnimation()
 {
-	for (uint8_t i = 0; i < REGULATOR_COUNT; i++)
+	uint32_t totalLedCount = 0;
+	for (uint8_t i = 0; i < LED_NUM_ZONES; i++)
 	{
-		regulatorPower[i] = 0.0f;
+		totalLedCount += this->config->getLedConfig(i).ledCount;
+	}
+
+	this->streamReceiver = new TesLight::StreamReceiver(totalLedCount * 3);
+	if (!this->streamReceiver->begin())
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to start the stream receiver."));
+		delete this->streamReceiver;
+		this->streamReceiver = nullptr;
+		return false;
 	}
 
+	uint32_t channelOffset = 0;
+	for (uint8_t i = 0; i < LED_NUM_ZONES; i++)
+	{
+		const TesLight::Configuration::LedConfig ledConfig = this->config->getLedConfig(i);
+		ledAnimator[i] = new TesLight::StreamAnimator(this->streamReceiver, channelOffset);
+		ledAnimator[i]->setPixels(this->ledData[i]);
+		ledAnimator[i]->setPixelCount(ledConfig.ledCount);
+		this->applyAnimatorSettings(i, ledConfig);
+		ledAnimator[i]->init();
+		channelOffset += ledConfig.ledCount * 3;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Move the current animators into the transition stage and keep the LED data.
+ * The fseq loader or stream receiver is kept alive until the transition is finished.
+ */
+void TesLight::LedManager::beginTransition()
+{
+	this->finishTransitions();
 	for (uint8_t i = 0; i < LED_NUM_ZONES; i++)
 	{
-		TesLight::Configuration::LedConfig ledConfig = this->config->getLedConfig(i);
-		float zoneCurrent = 0.0f;
 		if (this->ledAnimator[i] != nullptr)
 		{
-			for (uint16_t j = 0; j < this->ledAnimator[i]->getPixelCount(); j++)
-			{
-				zoneCurrent += ledConfig.ledChannelCurrent[0] * this->ledData[i][j].r / 255.0f;
-				zoneCurrent += ledConfig.ledChannelCurrent[1] * this->ledData[i][j].g / 255.0f;
-				zoneCurrent += ledConfig.ledChannelCurrent[2] * this->ledData[i][j].b / 255.0f;
-			}
+			this->startZoneTransition(i);
 		}
-		else
+	}
+
+	this->previousFseqLoader = this->fseqLoader;
+	this->fseqLoader = nullptr;
+	this->previousStreamReceiver = this->streamReceiver;
+	this->streamReceiver = nullptr;
+	this->appliedLedConfigValid = false;
+}
+
+/**
+ * @brief Move the animator of a zone into the transition stage. It will render into its own buffer until the transition is finished.
+ * @param index index of the zone
+ */
+void TesLight::LedManager::startZoneTransition(const uint8_t index)
+{
+	this->endZoneTransition(index);
+
+	const uint16_t pixelCount = this->ledAnimator[index]->getPixelCount();
+	this->transitionData[index] = new CRGB[pixelCount];
+	memcpy(this->transitionData[index], this->ledData[index], pixelCount * sizeof(CRGB));
+
+	this->previousAnimator[index] = this->ledAnimator[index];
+	this->previousAnimator[index]->setPixels(this->transitionData[index]);
+	this->ledAnimator[index] = nullptr;
+	this->transitionStart[index] = micros();
+}
+
+/**
+ * @brief Render the outgoing animator of a zone and blend it with the already rendered frame of the new animator.
+ * @param index index of the zone
+ */
+void TesLight::LedManager::renderZoneTransition(const uint8_t index)
+{
+	const unsigned long elapsed = micros() - this->transitionStart[index];
+	if (elapsed >= this->transitionTime)
+	{
+		this->endZoneTransition(index);
+		return;
+	}
+
+	this->previousAnimator[index]->render();
+
+	const uint8_t amount = (uint64_t)elapsed * 255 / this->transitionTime;
+	const uint16_t pixelCount = this->ledAnimator[index]->getPixelCount();
+	for (uint16_t i = 0; i < pixelCount; i++)
+	{
+		this->ledData[index][i].r = lerp8by8(this->transitionData[index][i].r, this->ledData[index][i].r, amount);
+		this->ledData[index][i].g = lerp8by8(this->transitionData[index][i].g, this->ledData[index][i].g, amount);
+		this->ledData[index][i].b = lerp8by8(this->transitionData[index][i].b, this->ledData[index][i].b, amount);
+	}
+}
+
+/**
+ * @brief End the transition of a zone and free the outgoing animator and its buffer.
+ * @param index index of the zone
+ */
+void TesLight::LedManager::endZoneTransition(const uint8_t index)
+{
+	if (this->previousAnimator[index] != nullptr)
+	{
+		delete this->previousAnimator[index];
+		this->previousAnimator[index] = nullptr;
+	}
+	if (this->transitionData[index] != nullptr)
+	{
+		delete[] this->transitionData[index];
+		this->transitionData[index] = nullptr;
+	}
+}
+
+/**
+ * @brief End all transitions and free the outgoing fseq loader or stream receiver.
+ */
+void TesLight::LedManager::finishTransitions()
+{
+	for (uint8_t i = 0; i < LED_NUM_ZONES; i++)
+	{
+		this->endZoneTransition(i);
+	}
+
+	if (this->previousFseqLoader != nullptr)
+	{
+		delete this->previousFseqLoader;
+		this->previousFseqLoader = nullptr;
+	}
+
+	if (this->previousStreamReceiver != nullptr)
+	{
+		delete this->previousStreamReceiver;
+		this->previousStreamReceiver = nullptr;
+	}
+}
+
+/**
+ * @brief Check if the current LED configuration can only be applied by a full reload.
+ * This is the case when the LED pin, LED count or the source of the animation has changed.
+ * @return true when a full reload is required
+ * @return false when the changes can be applied to the running animators
+ */
+bool TesLight::LedManager::isReloadRequired()
+{
+	if (!this->appliedLedConfigValid || this->isLayoutChanged())
+	{
+		return true;
+	}
+
+	// Switching between calculated, custom and streamed animations or changing the custom animation file
+	const TesLight::Configuration::LedConfig ledConfig = this->config->getLedConfig(0);
+	const uint8_t type = ledConfig.type;
+	const uint8_t appliedType = this->appliedLedConfig[0].type;
+	if ((type >= 254 || appliedType >= 254) && type != appliedType)
+	{
+		return true;
+	}
+	if (type == 255 && memcmp(&ledConfig.customField[10], &this->appliedLedConfig[0].customField[10], 4) != 0)
+	{
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Check if the LED pin or the LED count of any zone has changed.
+ * @return true when the LED data must be reallocated
+ * @return false when the LED data can be kept
+ */
+bool TesLight::LedManager::isLayoutChanged()
+{
+	for (uint8_t i = 0; i < LED_NUM_ZONES; i++)
+	{
+		const TesLight::Configuration::LedConfig ledConfig = this->config->getLedConfig(i);
+		if (ledConfig.ledPin != this->appliedLedConfig[i].ledPin || ledConfig.ledCount != this->appliedLedConfig[i].ledCount)
 		{
-			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to calculate power consumption for animator ") + String(i) + F(" because the animator is null."));
-			return false;
+			return true;
 		}
+	}
 
-		const uint8_t regulatorIndex = this->getRegulatorIndexFromPin(ledConfig.ledPin);
-		regulatorPower[regulatorIndex] += zoneCurrent * (ledConfig.ledVoltage / 10.0f) / 1000.0f;
+	return false;
+}
+
+/**
+ * @brief Push the general animator settings from the LED configuration into the animator.
+ * @param index index of the zone
+ * @param ledConfig LED configuration of the zone
+ */
+void TesLight::LedManager::applyAnimatorSettings(const uint8_t index, const TesLight::Configuration::LedConfig &ledConfig)
+{
+	this->ledAnimator[index]->setSpeed(ledConfig.speed);
+	this->ledAnimator[index]->setOffset(ledConfig.offset);
+	this->ledAnimator[index]->setAnimationBrightness(ledConfig.brightness / 255.0f);
+	this->ledAnimator[index]->setFadeSpeed(ledConfig.fadeSpeed / 4096.0f);
+	this->ledAnimator[index]->setReverse(ledConfig.reverse);
+	this->ledAnimator[index]->setMotionSensorData(&this->motionSensorData);
+}
+
+/**
+ * @brief Push the colors from the custom fields of the LED configuration into a calculated animator.
+ * The animator must match the type from the configuration.
+ * @param index index of the zone
+ * @param ledConfig LED configuration of the zone
+ */
+void TesLight::LedManager::applyAnimatorColor(const uint8_t index, const TesLight::Configuration::LedConfig &ledConfig)
+{
+	const CRGB color1 = CRGB(ledConfig.customField[0], ledConfig.customField[1], ledConfig.customField[2]);
+	const CRGB color2 = CRGB(ledConfig.customField[3], ledConfig.customField[4], ledConfig.customField[5]);
+
+	// Gradient types
+	if (ledConfig.type == 3 || ledConfig.type == 4)
+	{
+		static_cast<TesLight::GradientAnimator *>(this->ledAnimator[index])->setColor(color1, color2);
 	}
 
-	return true;
+	// Static color type
+	else if (ledConfig.type == 5)
+	{
+		static_cast<TesLight::StaticColorAnimator *>(this->ledAnimator[index])->setColor(color1);
+	}
+
+	// Color bar types
+	else if (ledConfig.type >= 6 && ledConfig.type <= 9)
+	{
+		static_cast<TesLight::ColorBarAnimator *>(this->ledAnimator[index])->setColor(color1, color2);
+	}
+
+	// Gradient motion types
+	else if (ledConfig.type >= 14 && ledConfig.type <= 17)
+	{
+		static_cast<TesLight::GradientAnimatorMotion *>(this->ledAnimator[index])->setColor(color1, color2);
+	}
+}
+
+/**
+ * @brief Update the power coefficients of a zone. They are the product of the channel current and the LED voltage,
+ * so that the power draw of a zone is the dot product of the coefficients and the channel sums of the pixels.
+ * @param index index of the zone
+ * @param ledConfig LED configuration of the zone
+ */
+void TesLight::LedManager::updatePowerCoefficients(const uint8_t index, const TesLight::Configuration::LedConfig &ledConfig)
+{
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		this->zonePowerCoefficient[index][i] = ledConfig.ledChannelCurrent[i] * ledConfig.ledVoltage;
+	}
+	this->zoneRegulator[index] = this->getRegulatorIndexFromPin(ledConfig.ledPin);
 }
 
 /**
- * @brief Limit the power consumption of the current frame to the maxumim system power.
+ * @brief Calculate the total power draw from each regulator using the current frame.
+ * Per zone only the channel values are summed up, the power is then calculated with the precomputed coefficients.
+ * @param regulatorPower array containing the power draw per regulator after the call
  * @return true when successful
  * @return false when there was an error
  */
-bool TesLight::LedManager::limitPowerConsumption()
+bool TesLight::LedManager::calculateRegulatorPowerDraw(float regulatorPower[REGULATOR_COUNT])
 {
-	float regulatorPower[REGULATOR_COUNT];
-	if (!this->calculateRegulatorPowerDraw(regulatorPower))
+	for (uint8_t i = 0; i < REGULATOR_COUNT; i++)
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to get regulator power draw."));
-		return false;
+		regulatorPower[i] = 0.0f;
 	}
 
-	TesLight::Configuration::SystemConfig systemConfig = this->config->getSystemConfig();
 	for (uint8_t i = 0; i < LED_NUM_ZONES; i++)
 	{
-		TesLight::Configuration::LedConfig ledConfig = this->config->getLedConfig(i);
-		if (this->ledAnimator[i] != nullptr)
+		if (this->ledAnimator[i] == nullptr)
 		{
-			const uint8_t regulatorIndex = this->getRegulatorIndexFromPin(ledConfig.ledPin);
-			float multiplicator = ((float)systemConfig.regulatorPowerLimit / REGULATOR_COUNT) / regulatorPower[regulatorIndex];
-			if (multiplicator < 0.0f)
-			{
-				multiplicator = 0.0f;
-			}
-			else if (multiplicator > 1.0f)
-			{
-				multiplicator = 1.0f;
-			}
-
-			for (uint16_t j = 0; j < this->ledAnimator[i]->getPixelCount(); j++)
-			{
-				this->ledData[i][j].r *= multiplicator;
-				this->ledData[i][j].g *= multiplicator;
-				this->ledData[i][j].b *= multiplicator;
-			}
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to calculate power consumption for animator ") + String(i) + F(" because the animator is null."));
+			return false;
 		}
-		else
+
+		uint32_t sumR = 0;
+		uint32_t sumG = 0;
+		uint32_t sumB = 0;
+		const CRGB *pixels = this->ledData[i];
+		const uint16_t pixelCount = this->ledAnimator[i]->getPixelCount();
+		for (uint16_t j = 0; j < pixelCount; j++)
 		{
-			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to limit power consumption for animator ") + String(i) + F(" because the animator is null."));
-			return false;
+			sumR += pixels[j].r;
+			sumG += pixels[j].g;
+			sumB += pixels[j].b;
 		}
+
+		// Coefficients are mA * V * 10 for a channel value of 255, the result is in W
+		const uint16_t *coefficient = this->zonePowerCoefficient[i];
+		regulatorPower[this->zoneRegulator[i]] += ((float)coefficient[0] * sumR + (float)coefficient[1] * sumG + (float)coefficient[2] * sumB) / 2550000.0f;
 	}
 
 	return true;
 }
 
 /**
- * @brief Limit the regulator temperature by reducing the LED brightness once the high temperature is reached.
- * @return true when successul
+ * @brief Limit the power draw of each regulator to its thermal budget. The budget is the power limit of the regulator,
+ * which is reduced linearly once the regulator reaches the high temperature and is 0 at the cutoff temperature.
+ * The multiplier is calculated once per regulator, so only the zones fed by a hot or overloaded regulator are dimmed.
+ * @return true when successful
  * @return false when there was an error
  */
-bool TesLight::LedManager::limitRegulatorTemperature()
+bool TesLight::LedManager::limitRegulatorPower()
 {
-	float multiplicator = 1.0f - (this->regulatorTemperature - this->config->getSystemConfig().regulatorHighTemperature) / (this->config->getSystemConfig().regulatorCutoffTemperature - this->config->getSystemConfig().regulatorHighTemperature);
-	if (multiplicator < 0.0f)
+	float regulatorPower[REGULATOR_COUNT];
+	if (!this->calculateRegulatorPowerDraw(regulatorPower))
 	{
-		multiplicator = 0.0f;
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to get regulator power draw."));
+		return false;
 	}
-	else if (multiplicator > 1.0f)
+
+	const TesLight::Configuration::SystemConfig systemConfig = this->config->getSystemConfig();
+	uint8_t scale[REGULATOR_COUNT];
+	for (uint8_t i = 0; i < REGULATOR_COUNT; i++)
 	{
-		multiplicator = 1.0f;
+		float budget = 1.0f - (this->regulatorTemperature[i] - systemConfig.regulatorHighTemperature) / (systemConfig.regulatorCutoffTemperature - systemConfig.regulatorHighTemperature);
+		if (budget < 0.0f)
+		{
+			budget = 0.0f;
+		}
+		else if (budget > 1.0f)
+		{
+			budget = 1.0f;
+		}
+		budget *= (float)systemConfig.regulatorPowerLimit / REGULATOR_COUNT;
+
+		const float multiplicator = regulatorPower[i] > budget ? budget / regulatorPower[i] : 1.0f;
+		scale[i] = multiplicator * 255.0f;
+		this->framePower[i] = regulatorPower[i] * multiplicator;
+		this->frameLimited[i] = multiplicator < 1.0f;
 	}
 
 	for (uint8_t i = 0; i < LED_NUM_ZONES; i++)
 	{
-		if (this->ledAnimator[i] != nullptr)
+		if (this->ledAnimator[i] == nullptr)
 		{
-			for (uint16_t j = 0; j < this->ledAnimator[i]->getPixelCount(); j++)
-			{
-				this->ledData[i][j].r *= multiplicator;
-				this->ledData[i][j].g *= multiplicator;
-				this->ledData[i][j].b *= multiplicator;
-			}
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to limit regulator power for animator ") + String(i) + F(" because the animator is null."));
+			return false;
 		}
-		else
+
+		if (scale[this->zoneRegulator[i]] < 255)
 		{
-			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to limit regulator temperature because animator with index ") + String(i) + F(" is null."));
-			return false;
+			nscale8(this->ledData[i], this->ledAnimator[i]->getPixelCount(), scale[this->zoneRegulator[i]]);
 		}
 	}
 
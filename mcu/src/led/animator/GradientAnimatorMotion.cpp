@@ -162,27 +162,27 @@ float TesLight::GradientAnimatorMotion::getMotionOffset()
 	float motionValue = 0.0f;
 	if (this->motionSensorValue == TesLight::MotionSensor::MotionSensorValue::ACC_X_G)
 	{
-		motionValue = this->motionSensorData.accXG;
+		motionValue = this->motionSensorData->accXG;
 	}
 	else if (this->motionSensorValue == TesLight::MotionSensor::MotionSensorValue::ACC_Y_G)
 	{
-		motionValue = this->motionSensorData.accYG;
+		motionValue = this->motionSensorData->accYG;
 	}
 	else if (this->motionSensorValue == TesLight::MotionSensor::MotionSensorValue::ACC_Z_G)
 	{
-		motionValue = this->motionSensorData.accZG;
+		motionValue = this->motionSensorData->accZG;
 	}
 	else if (this->motionSensorValue == TesLight::MotionSensor::MotionSensorValue::GY_X_DEG)
 	{
-		motionValue = this->motionSensorData.gyroXDeg / 30.0f;
+		motionValue = this->motionSensorData->gyroXDeg / 30.0f;
 	}
 	else if (this->motionSensorValue == TesLight::MotionSensor::MotionSensorValue::GY_Y_DEG)
 	{
-		motionValue = this->motionSensorData.gyroYDeg / 30.0f;
+		motionValue = this->motionSensorData->gyroYDeg / 30.0f;
 	}
 	else if (this->motionSensorValue == TesLight::MotionSensor::MotionSensorValue::GY_Z_DEG)
 	{
-		motionValue = this->motionSensorData.gyroZDeg / 30.0f;
+		motionValue = this->motionSensorData->gyroZDeg / 30.0f;
 	}
 
 	motionValue *= this->speed / 127.0f;
@@ -24,18 +24,7 @@ TesLight::LedAnimator::LedAnimator()
 	this->fadeSpeed = 1.0f;
 	this->reverse = false;
 
-	this->motionSensorData.accXRaw = 0;
-	this->motionSensorData.accYRaw = 0;
-	this->motionSensorData.accZRaw = 0;
-	this->motionSensorData.gyroXRaw = 0;
-	this->motionSensorData.gyroYRaw = 0;
-	this->motionSensorData.gyroZRaw = 0;
-	this->motionSensorData.accXG = 0;
-	this->motionSensorData.accYG = 0;
-	this->motionSensorData.accZG = 0;
-	this->motionSensorData.gyroXDeg = 0;
-	this->motionSensorData.gyroYDeg = 0;
-	this->motionSensorData.gyroZDeg = 0;
+	this->motionSensorData = nullptr;
 }
 
 /**
@@ -215,19 +204,20 @@ bool TesLight::LedAnimator::getReverse()
 }
 
 /**
- * @brief Set the motion sensor data.
- * @param motionSensorData instance of {@link TesLight::MotionSensor::MotionSensorData}
+ * @brief Set the reference to the motion sensor data. The data is shared by all animators and updated once per frame.
+ * It must be set before the animator is rendered.
+ * @param motionSensorData reference to the {@link TesLight::MotionSensor::MotionSensorData}
  */
-void TesLight::LedAnimator::setMotionSensorData(const TesLight::MotionSensor::MotionSensorData motionSensorData)
+void TesLight::LedAnimator::setMotionSensorData(const TesLight::MotionSensor::MotionSensorData *motionSensorData)
 {
 	this->motionSensorData = motionSensorData;
 }
 
 /**
- * @brief Get the currently set and used motion sensor data.
- * @return currently set and used motion sensor data
+ * @brief Get the reference to the currently used motion sensor data.
+ * @return reference to the currently used motion sensor data
  */
-TesLight::MotionSensor::MotionSensorData TesLight::LedAnimator::getMotionSensorData()
+const TesLight::MotionSensor::MotionSensorData *TesLight::LedAnimator::getMotionSensorData()
 {
 	return this->motionSensorData;
 }
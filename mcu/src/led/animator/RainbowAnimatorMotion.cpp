@@ -134,27 +134,27 @@ float TesLight::RainbowAnimatorMotion::getMotionSpeed()
 	float speed = this->speed / 15.0f;
 	if (this->motionSensorValue == TesLight::MotionSensor::MotionSensorValue::ACC_X_G)
 	{
-		speed *= this->motionSensorData.accXG;
+		speed *= this->motionSensorData->accXG;
 	}
 	else if (this->motionSensorValue == TesLight::MotionSensor::MotionSensorValue::ACC_Y_G)
 	{
-		speed *= this->motionSensorData.accYG;
+		speed *= this->motionSensorData->accYG;
 	}
 	else if (this->motionSensorValue == TesLight::MotionSensor::MotionSensorValue::ACC_Z_G)
 	{
-		speed *= this->motionSensorData.accZG;
+		speed *= this->motionSensorData->accZG;
 	}
 	else if (this->motionSensorValue == TesLight::MotionSensor::MotionSensorValue::GY_X_DEG)
 	{
-		speed *= this->motionSensorData.gyroXDeg / 10.0f;
+		speed *= this->motionSensorData->gyroXDeg / 10.0f;
 	}
 	else if (this->motionSensorValue == TesLight::MotionSensor::MotionSensorValue::GY_Y_DEG)
 	{
-		speed *= this->motionSensorData.gyroYDeg / 10.0f;
+		speed *= this->motionSensorData->gyroYDeg / 10.0f;
 	}
 	else if (this->motionSensorValue == TesLight::MotionSensor::MotionSensorValue::GY_Z_DEG)
 	{
-		speed *= this->motionSensorData.gyroZDeg / 10.0f;
+		speed *= this->motionSensorData->gyroZDeg / 10.0f;
 	}
 
 	if (speed > 20)
@@ -0,0 +1,96 @@
+/**
+ * @file StreamAnimator.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the {@link TesLight::StreamAnimator}.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "led/animator/StreamAnimator.h"
+
+/**
+ * @brief Create a new instance of {@link TesLight::StreamAnimator}.
+ */
+TesLight::StreamAnimator::StreamAnimator()
+{
+	this->streamReceiver = nullptr;
+	this->channelOffset = 0;
+}
+
+/**
+ * @brief Create a new instance of {@link TesLight::StreamAnimator}.
+ * @param streamReceiver reference to a {@link TesLight::StreamReceiver} instance
+ * @param channelOffset offset of the first channel of this zone in the received frame
+ */
+TesLight::StreamAnimator::StreamAnimator(TesLight::StreamReceiver *streamReceiver, const uint32_t channelOffset)
+{
+	this->streamReceiver = streamReceiver;
+	this->channelOffset = channelOffset;
+}
+
+/**
+ * @brief Destroy the {@link TesLight::StreamAnimator}.
+ */
+TesLight::StreamAnimator::~StreamAnimator()
+{
+}
+
+/**
+ * @brief Set the reference to a {@link TesLight::StreamReceiver} instance.
+ * @param streamReceiver reference to the {@link TesLight::StreamReceiver} instance
+ */
+void TesLight::StreamAnimator::setStreamReceiver(TesLight::StreamReceiver *streamReceiver)
+{
+	this->streamReceiver = streamReceiver;
+}
+
+/**
+ * @brief Set the offset of the first channel of this zone in the received frame.
+ * @param channelOffset channel offset
+ */
+void TesLight::StreamAnimator::setChannelOffset(const uint32_t channelOffset)
+{
+	this->channelOffset = channelOffset;
+}
+
+/**
+ * @brief Initialize the {@link StreamAnimator}.
+ */
+void TesLight::StreamAnimator::init()
+{
+	for (uint16_t i = 0; i < this->pixelCount; i++)
+	{
+		this->pixels[i] = CRGB::Black;
+	}
+}
+
+/**
+ * @brief Render the current frame of the {@link TesLight::StreamReceiver} to the pixel array.
+ */
+void TesLight::StreamAnimator::render()
+{
+	if (this->streamReceiver == nullptr)
+	{
+		return;
+	}
+
+	if (!this->streamReceiver->readPixelbuffer(this->pixels, this->channelOffset, this->pixelCount))
+	{
+		for (uint16_t i = 0; i < this->pixelCount; i++)
+		{
+			this->pixels[i] = CRGB::Black;
+		}
+	}
+
+	if (this->reverse)
+	{
+		for (uint16_t i = 0, j = this->pixelCount - 1; i < j; i++, j--)
+		{
+			CRGB temp = this->pixels[i];
+			this->pixels[i] = this->pixels[j];
+			this->pixels[j] = temp;
+		}
+	}
+
+	this->applyBrightness();
+}
@@ -14,6 +14,7 @@ bool TesLight::Logger::logToFile = false;
 FS *TesLight::Logger::fileSystem = nullptr;
 String TesLight::Logger::fileName = F("");
 TesLight::Logger::LogLevel TesLight::Logger::minLogLevel = TesLight::Logger::LogLevel::DEBUG;
+SemaphoreHandle_t TesLight::Logger::mutex = nullptr;
 
 /**
  * @brief Initialiize the {@link TesLight::Logger}.
@@ -31,13 +32,17 @@ bool TesLight::Logger::begin()
  */
 bool TesLight::Logger::begin(const uint32_t baudRate)
 {
-	Serial.begin(baudRate);
-	logToSerial = true;
+	if (!logToSerial)
+	{
+		Serial.begin(baudRate);
+		logToSerial = true;
+	}
 	return true;
 }
 
 /**
  * @brief Initialiize the {@link TesLight::Logger}.
+ * This can be called while other tasks are logging, so the file is only used after it was fully set.
  * @param fs instance of the {@link FS} containing the file
  * @param fn full name of the file
  * @return true when successful
@@ -45,9 +50,13 @@ bool TesLight::Logger::begin(const uint32_t baudRate)
  */
 bool TesLight::Logger::begin(FS *fs, const String fn)
 {
-	logToFile = testOpenFile(fs, fn);
+	createMutex();
+	xSemaphoreTake(mutex, portMAX_DELAY);
+	logToFile = false;
 	fileSystem = fs;
 	fileName = fn;
+	logToFile = testOpenFile(fs, fn);
+	xSemaphoreGive(mutex);
 	return true;
 }
 
@@ -61,12 +70,8 @@ bool TesLight::Logger::begin(FS *fs, const String fn)
  */
 bool TesLight::Logger::begin(uint32_t baudRate, FS *fs, const String fn)
 {
-	Serial.begin(baudRate);
-	logToSerial = true;
-	logToFile = testOpenFile(fs, fn);
-	fileSystem = fs;
-	fileName = fn;
-	return true;
+	begin(baudRate);
+	return begin(fs, fn);
 }
 
 /**
@@ -95,6 +100,9 @@ void TesLight::Logger::log(const TesLight::Logger::LogLevel logLevel, const char
 
 	const String logString = getTimeString() + F(" [") + getLogLevelString(logLevel) + F("] (") + String(file) + F(") (") + String(function) + F(") (") + String(line) + F("): ") + message + F("\r\n");
 
+	createMutex();
+	xSemaphoreTake(mutex, portMAX_DELAY);
+
 	if (logToSerial)
 	{
 		Serial.print(logString);
@@ -102,15 +110,18 @@ void TesLight::Logger::log(const TesLight::Logger::LogLevel logLevel, const char
 
 	if (logToFile)
 	{
-
 		File logFile = fileSystem->open(fileName, FILE_APPEND);
-		if (!logFile || logFile.isDirectory())
+		if (logFile && !logFile.isDirectory())
+		{
+			logFile.write((uint8_t *)logString.c_str(), logString.length());
+		}
+		if (logFile)
 		{
-			return;
+			logFile.close();
 		}
-		logFile.write((uint8_t *)logString.c_str(), logString.length());
-		logFile.close();
 	}
+
+	xSemaphoreGive(mutex);
 }
 
 /**
@@ -273,4 +284,16 @@ String TesLight::Logger::getTimeString()
 	}
 
 	return timeString;
+}
+
+/**
+ * @brief Create the mutex to synchronize the logging between multiple tasks.
+ * The logger is always initialized or used during setup, before other tasks are started.
+ */
+void TesLight::Logger::createMutex()
+{
+	if (mutex == nullptr)
+	{
+		mutex = xSemaphoreCreateMutex();
+	}
 }
\ No newline at end of file
@@ -0,0 +1,155 @@
+/**
+ * @file Telemetry.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the {@link TesLight::Telemetry}.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "logging/Telemetry.h"
+
+// Initialize
+TesLight::Telemetry::Sample TesLight::Telemetry::secondSamples[TELEMETRY_SECOND_SAMPLES];
+TesLight::Telemetry::Sample TesLight::Telemetry::minuteSamples[TELEMETRY_MINUTE_SAMPLES];
+TesLight::Telemetry::Sample TesLight::Telemetry::hourSamples[TELEMETRY_HOUR_SAMPLES];
+TesLight::Telemetry::Ring TesLight::Telemetry::rings[3] = {
+	{TesLight::Telemetry::secondSamples, TELEMETRY_SECOND_SAMPLES, 0, 0},
+	{TesLight::Telemetry::minuteSamples, TELEMETRY_MINUTE_SAMPLES, 0, 0},
+	{TesLight::Telemetry::hourSamples, TELEMETRY_HOUR_SAMPLES, 0, 0}};
+TesLight::Telemetry::Accumulator TesLight::Telemetry::accumulators[2];
+float TesLight::Telemetry::framePower[REGULATOR_COUNT];
+uint16_t TesLight::Telemetry::frameLimited[REGULATOR_COUNT];
+uint16_t TesLight::Telemetry::frameCount = 0;
+
+/**
+ * @brief Add the values of a rendered frame. They are collected until the next call to {@link TesLight::Telemetry::update}.
+ * @param power power draw per regulator in W
+ * @param limited true for each regulator that had to limit the brightness of the frame
+ */
+void TesLight::Telemetry::addFrame(const float power[REGULATOR_COUNT], const bool limited[REGULATOR_COUNT])
+{
+	for (uint8_t i = 0; i < REGULATOR_COUNT; i++)
+	{
+		TesLight::Telemetry::framePower[i] += power[i];
+		TesLight::Telemetry::frameLimited[i] += limited[i] ? 1 : 0;
+	}
+	TesLight::Telemetry::frameCount++;
+}
+
+/**
+ * @brief Create a new sample from the collected frames. This must be called once per second.
+ * Every 60 samples are combined into a sample of the next lower resolution.
+ * @param temperature current temperature per regulator in °C
+ * @param fanPwm current pwm value of the fan
+ */
+void TesLight::Telemetry::update(const float temperature[REGULATOR_COUNT], const uint8_t fanPwm)
+{
+	const uint16_t frameCount = TesLight::Telemetry::frameCount > 0 ? TesLight::Telemetry::frameCount : 1;
+	TesLight::Telemetry::Sample sample;
+	for (uint8_t i = 0; i < REGULATOR_COUNT; i++)
+	{
+		sample.power[i] = TesLight::Telemetry::framePower[i] * 100.0f / frameCount;
+		sample.temperature[i] = temperature[i] * 10.0f;
+		sample.limited[i] = TesLight::Telemetry::frameLimited[i] * 100 / frameCount;
+		TesLight::Telemetry::framePower[i] = 0.0f;
+		TesLight::Telemetry::frameLimited[i] = 0;
+	}
+	sample.fanPwm = fanPwm;
+	sample.fps = TesLight::Telemetry::frameCount > 255 ? 255 : TesLight::Telemetry::frameCount;
+	TesLight::Telemetry::frameCount = 0;
+
+	TesLight::Telemetry::addSample(TesLight::Telemetry::Resolution::SECOND, sample);
+}
+
+/**
+ * @brief Get the number of samples that are available for a resolution.
+ * @param resolution resolution of the samples
+ * @return number of samples
+ */
+uint16_t TesLight::Telemetry::getSampleCount(const TesLight::Telemetry::Resolution resolution)
+{
+	return TesLight::Telemetry::rings[resolution].count;
+}
+
+/**
+ * @brief Get a sample from the history.
+ * @param resolution resolution of the sample
+ * @param index index of the sample, starting with the oldest one
+ * @param sample variable to hold the sample
+ * @return true when successful
+ * @return false when the index is out of range
+ */
+bool TesLight::Telemetry::getSample(const TesLight::Telemetry::Resolution resolution, const uint16_t index, TesLight::Telemetry::Sample &sample)
+{
+	const TesLight::Telemetry::Ring &ring = TesLight::Telemetry::rings[resolution];
+	if (index >= ring.count)
+	{
+		return false;
+	}
+
+	sample = ring.samples[(ring.newest + ring.size - ring.count + 1 + index) % ring.size];
+	return true;
+}
+
+/**
+ * @brief Add a sample to the ring buffer of a resolution and to the accumulator of the next lower resolution.
+ * Power, fan speed, frame rate and limiter engagement are averaged, the temperature is the maximum.
+ * @param resolution resolution of the sample
+ * @param sample sample to add
+ */
+void TesLight::Telemetry::addSample(const TesLight::Telemetry::Resolution resolution, const TesLight::Telemetry::Sample &sample)
+{
+	TesLight::Telemetry::Ring &ring = TesLight::Telemetry::rings[resolution];
+	ring.newest = ring.count == 0 ? 0 : (ring.newest + 1) % ring.size;
+	ring.samples[ring.newest] = sample;
+	if (ring.count < ring.size)
+	{
+		ring.count++;
+	}
+
+	if (resolution == TesLight::Telemetry::Resolution::HOUR)
+	{
+		return;
+	}
+
+	TesLight::Telemetry::Accumulator &accumulator = TesLight::Telemetry::accumulators[resolution];
+	if (accumulator.count == 0)
+	{
+		memset(&accumulator, 0, sizeof(accumulator));
+		for (uint8_t i = 0; i < REGULATOR_COUNT; i++)
+		{
+			accumulator.temperature[i] = -1000.0f;
+		}
+	}
+
+	for (uint8_t i = 0; i < REGULATOR_COUNT; i++)
+	{
+		accumulator.power[i] += sample.power[i];
+		accumulator.limited[i] += sample.limited[i];
+		if (sample.temperature[i] > accumulator.temperature[i])
+		{
+			accumulator.temperature[i] = sample.temperature[i];
+		}
+	}
+	accumulator.fanPwm += sample.fanPwm;
+	accumulator.fps += sample.fps;
+	accumulator.count++;
+
+	if (accumulator.count < 60)
+	{
+		return;
+	}
+
+	TesLight::Telemetry::Sample combined;
+	for (uint8_t i = 0; i < REGULATOR_COUNT; i++)
+	{
+		combined.power[i] = accumulator.power[i] / accumulator.count + 0.5f;
+		combined.temperature[i] = accumulator.temperature[i];
+		combined.limited[i] = accumulator.limited[i] / accumulator.count + 0.5f;
+	}
+	combined.fanPwm = accumulator.fanPwm / accumulator.count + 0.5f;
+	combined.fps = accumulator.fps / accumulator.count + 0.5f;
+	accumulator.count = 0;
+
+	TesLight::Telemetry::addSample((TesLight::Telemetry::Resolution)(resolution + 1), combined);
+}
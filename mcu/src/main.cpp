@@ -11,12 +11,14 @@
 #include <esp_task_wdt.h>
 #include "configuration/SystemConfiguration.h"
 #include "logging/Logger.h"
+#include "logging/Telemetry.h"
 #include "configuration/Configuration.h"
 #include "hardware/FanController.h"
 #include "led/LedManager.h"
 #include "sensor/TemperatureSensor.h"
 #include "sensor/LightSensor.h"
 #include "sensor/MotionSensor.h"
+#include "sensor/I2CBusManager.h"
 #include "wifi/WiFiManager.h"
 #include "server/WebServerManager.h"
 #include "server/ConnectionTestEndpoint.h"
@@ -28,26 +30,37 @@
 #include "server/UpdateEndpoint.h"
 #include "server/ResetEndpoint.h"
 #include "server/MotionSensorEndpoint.h"
+#include "server/UploadSessionEndpoint.h"
+#include "server/SensorRecorderEndpoint.h"
+#include "server/TelemetryEndpoint.h"
 #include "util/FileUtil.h"
+#include "util/BootProfiler.h"
+#include "util/FseqIndex.h"
 #include "update/Updater.h"
 
 TesLight::Configuration *configuration = nullptr;
+TesLight::FseqIndex *fseqIndex = nullptr;
 TesLight::FanController *fanController = nullptr;
 TesLight::LedManager *ledManager = nullptr;
 TesLight::TemperatureSensor *temperatureSensor = nullptr;
 TesLight::LightSensor *lightSensor = nullptr;
 TesLight::MotionSensor *motionSensor = nullptr;
+TesLight::I2CBusManager *i2cBusManager = nullptr;
 TesLight::WiFiManager *wifiManager = nullptr;
 TesLight::WebServerManager *webServerManager = nullptr;
 
 // Timer
 unsigned long ledTimer = 0;
 unsigned long lightSensorTimer = 0;
-unsigned long motionSensorTimer = 0;
 unsigned long webServerTimer = 0;
 unsigned long statusTimer = 0;
 unsigned long temperatureTimer = 0;
+unsigned long sensorRecorderTimer = 0;
+unsigned long telemetryTimer = 0;
 uint16_t ledFrameCounter = 0;
+bool sdCardAvailable = false;
+volatile bool sensorsReady = false;
+volatile bool networkReady = false;
 float ledPowerCounter = 0.0f;
 
 // Initialization functions
@@ -55,16 +68,21 @@ void printLogo();
 bool initializeLogger(bool sdLogging);
 bool initializeSdCard();
 bool initializeConfiguration();
+bool importConfiguration();
+void initializeFseqIndex();
 void intializeI2C();
 void initializeFanController();
 void initializeLedManager();
 void initializeTemperatureSensor();
 void initializeLightSensor();
 bool initializeMotionSensor();
+bool initializeI2CBusManager();
 void initializeWiFiManager();
 void initializeWebServerManager();
 void initializeRestApi();
 void initializeTimers();
+void initializeSensorsAndNetwork();
+void backgroundInitializationTask(void *parameter);
 bool checkTimer(unsigned long &timer, unsigned long cycleTime);
 
 // System update
@@ -125,26 +143,63 @@ bool initializeSdCard()
 }
 
 /**
- * @brief Initialize the configuration and load it from the SD card or default.
+ * @brief Initialize the configuration and load it from the non volatile storage.
  * @return true when the configuration was loaded
  * @return false when there was an error
  */
 bool initializeConfiguration()
 {
-	TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, F("Initialize runtime configuration from MicroSD card."));
-	configuration = new TesLight::Configuration(&SD, CONFIGURATION_FILE_NAME);
-	if (configuration->load() && configuration->save())
+	TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, F("Initialize runtime configuration from non volatile storage."));
+	configuration = new TesLight::Configuration(CONFIGURATION_NVS_NAMESPACE);
+	if (configuration->load())
 	{
 		TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, F("Runtime configuration initialized."));
 		return true;
 	}
 	else
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to initialize runtime configuration from MicroSD card."));
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Failed to initialize runtime configuration from non volatile storage."));
 		return false;
 	}
 }
 
+/**
+ * @brief Import the configuration from the backup or legacy file on the SD card.
+ * @return true when the configuration was imported
+ * @return false when there was no valid file
+ */
+bool importConfiguration()
+{
+	TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, F("Import runtime configuration from MicroSD card."));
+	if (configuration->importFromFile(&SD, CONFIGURATION_BACKUP_FILE_NAME) || configuration->importFromFile(&SD, CONFIGURATION_FILE_NAME))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, F("Runtime configuration imported."));
+		return true;
+	}
+	else
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, F("No runtime configuration found on the MicroSD card."));
+		return false;
+	}
+}
+
+/**
+ * @brief Initialize the {@link TesLight::FseqIndex} and load it from the SD card.
+ */
+void initializeFseqIndex()
+{
+	TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, F("Initialize fseq index."));
+	fseqIndex = new TesLight::FseqIndex(&SD, FSEQ_DIRECTORY, FSEQ_INDEX_FILE_NAME);
+	if (sdCardAvailable && fseqIndex->load())
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, (String)F("Fseq index initialized with ") + String(fseqIndex->getEntryCount()) + F(" files."));
+	}
+	else
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Failed to load the fseq index. Continue without fseq files."));
+	}
+}
+
 /**
  * @brief Initialize the I²C bus.
  */
@@ -170,7 +225,7 @@ void initializeFanController()
 void initializeLedManager()
 {
 	TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, F("Initialize LED manager."));
-	ledManager = new TesLight::LedManager(configuration);
+	ledManager = new TesLight::LedManager(configuration, fseqIndex);
 	TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, F("LED manager initialized."));
 }
 
@@ -216,6 +271,27 @@ bool initializeMotionSensor()
 	}
 }
 
+/**
+ * @brief Initialize the I²C bus manager, which reads all I²C sensors in its own task.
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool initializeI2CBusManager()
+{
+	TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, F("Initialize I²C bus manager."));
+	i2cBusManager = new TesLight::I2CBusManager(motionSensor, lightSensor);
+	if (i2cBusManager->begin())
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, F("I²C bus manager initialized."));
+		return true;
+	}
+	else
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to initialize I²C bus manager."));
+		return false;
+	}
+}
+
 /**
  * @brief Initialize the wifi manager.
  */
@@ -251,15 +327,21 @@ void initializeRestApi()
 	TesLight::WiFiConfigurationEndpoint::init(webServerManager, F("/api/"));
 	TesLight::WiFiConfigurationEndpoint::begin(configuration, applyWifiConfig);
 	TesLight::FseqEndpoint::init(webServerManager, F("/api/"));
-	TesLight::FseqEndpoint::begin(&SD, configuration);
+	TesLight::FseqEndpoint::begin(&SD, configuration, fseqIndex);
 	TesLight::LogEndpoint::init(webServerManager, F("/api/"));
 	TesLight::LogEndpoint::begin(&SD);
 	TesLight::UpdateEndpoint::init(webServerManager, F("/api/"));
-	TesLight::UpdateEndpoint::begin(&SD);
+	TesLight::UpdateEndpoint::begin(&SD, configuration);
+	TesLight::UploadSessionEndpoint::init(webServerManager, F("/api/"));
+	TesLight::UploadSessionEndpoint::begin(&SD, configuration, fseqIndex);
 	TesLight::ResetEndpoint::init(webServerManager, F("/api/"));
-	TesLight::ResetEndpoint::begin(&SD);
+	TesLight::ResetEndpoint::begin(configuration);
 	TesLight::MotionSensorEndpoint::init(webServerManager, F("/api/"));
 	TesLight::MotionSensorEndpoint::begin(configuration, motionSensor);
+	TesLight::SensorRecorderEndpoint::init(webServerManager, F("/api/"));
+	TesLight::SensorRecorderEndpoint::begin();
+	TesLight::TelemetryEndpoint::init(webServerManager, F("/api/"));
+	TesLight::TelemetryEndpoint::begin();
 	TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, F("REST API initialized."));
 
 	TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, F("Starting web server."));
@@ -275,10 +357,11 @@ void initializeTimers()
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Initialize timers."));
 	ledTimer = micros();
 	lightSensorTimer = micros();
-	motionSensorTimer = micros();
 	webServerTimer = micros();
 	statusTimer = micros();
 	temperatureTimer = micros();
+	sensorRecorderTimer = micros();
+	telemetryTimer = micros();
 	ledFrameCounter = 0;
 	TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, F("Timers initialized."));
 }
@@ -334,7 +417,7 @@ void handleUpdate()
 	if (TesLight::Updater::install(&SD, (String)UPDATE_DIRECTORY + F("/") + UPDATE_FILE_NAME))
 	{
 		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Update installed successfully. Rebooting. Good luck ;) !"));
-		TesLight::Updater::reboot(F("Update Success"));
+		TesLight::Updater::reboot(F("Update Success"), configuration);
 	}
 	else
 	{
@@ -366,84 +449,36 @@ bool createtWiFiNetwork()
 }
 
 /**
- * @brief Initialize the software and hardware.
+ * @brief Initialize the sensors, the network and the web server while the LEDs are already running.
+ * The main loop will start using each subsystem as soon as its ready flag is set.
  */
-void setup()
+void initializeSensorsAndNetwork()
 {
-	initializeLogger(false);
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("TesLight booting up."));
-	printLogo();
-
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Initialize SD card."));
-	if (initializeSdCard())
-	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("SD card initialized."));
-	}
-	else
-	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to initialize SD card. Try reboot."));
-		TesLight::Updater::reboot("SD mount failure.");
-	}
-
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Switching to SD card logger."));
-	delay(500);
-	if (initializeLogger(true))
-	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Switched to SD card logger."));
-	}
-	else
-	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to switch to SD card logger. Try reboot."));
-		TesLight::Updater::reboot("SD logger failure.");
-	}
-
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Check if system update is available."));
-	if (updateAvilable())
-	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("System update package was found. Installing..."));
-		handleUpdate();
-	}
-	else
-	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("No available system update found."));
-	}
-
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Initialize, load and save configuration."));
-	if (initializeConfiguration())
-	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Runtime configuration loaded."));
-	}
-	else
-	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Failed to load configuration. Loading defaults and continue."));
-		configuration->loadDefaults();
-	}
-
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Updating log level from configuration."));
-	const TesLight::Configuration::SystemConfig systemConfig = configuration->getSystemConfig();
-	TesLight::Logger::setMinLogLevel((TesLight::Logger::LogLevel)systemConfig.logLevel);
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Log level updated from configuration."));
-
+	unsigned long stageStart = micros();
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Initialize I²C bus."));
 	intializeI2C();
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("I²C bus initialized."));
+	TesLight::BootProfiler::record(F("I²C bus"), stageStart);
 
+	stageStart = micros();
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Initialize Fan Controller."));
 	initializeFanController();
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Fan Controller initialized."));
+	TesLight::BootProfiler::record(F("Fan controller"), stageStart);
 
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Initialize LED Manager."));
-	initializeLedManager();
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("LED Manager initialized."));
-
+	stageStart = micros();
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Initialize temperature sensor."));
 	initializeTemperatureSensor();
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Temperature sensor initialized."));
+	TesLight::BootProfiler::record(F("Temperature sensor"), stageStart);
 
+	stageStart = micros();
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Initialize light sensor."));
 	initializeLightSensor();
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Light sensor initialized."));
+	TesLight::BootProfiler::record(F("Light sensor"), stageStart);
 
+	stageStart = micros();
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Initialize motion sensor."));
 	if (initializeMotionSensor())
 	{
@@ -453,11 +488,41 @@ void setup()
 	{
 		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to initialize motion sensor. Continue without motion sensor data."));
 	}
+	TesLight::BootProfiler::record(F("Motion sensor"), stageStart);
 
+	stageStart = micros();
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Initialize I²C bus manager."));
+	if (initializeI2CBusManager())
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("I²C bus manager initialized."));
+	}
+	else
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to initialize I²C bus manager. Continue without I²C sensor data."));
+	}
+	TesLight::BootProfiler::record(F("I²C bus manager"), stageStart);
+
+	lightSensorTimer = micros();
+	temperatureTimer = micros();
+	sensorsReady = true;
+
+	stageStart = micros();
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Initialize WiFiManager."));
 	initializeWiFiManager();
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("WiFi manager initialized."));
 
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Creating to WiFi network."));
+	if (createtWiFiNetwork())
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("WiFi Network created."));
+	}
+	else
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to create WiFi network. Continuing without WiFi network. The REST API might be inaccessible."));
+	}
+	TesLight::BootProfiler::record(F("WiFi network"), stageStart);
+
+	stageStart = micros();
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Starting Webserver."));
 	initializeWebServerManager();
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("Webserver started on port ") + WEB_SERVER_PORT + F("."));
@@ -465,27 +530,128 @@ void setup()
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Initialize REST api."));
 	initializeRestApi();
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("REST api initialized."));
+	TesLight::BootProfiler::record(F("Web server and REST api"), stageStart);
 
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Load LEDs and animators from configuration using the LED Manager."));
-	if (ledManager->reloadAnimations())
+	webServerTimer = micros();
+	networkReady = true;
+
+	if (sdCardAvailable)
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("LEDs and animators loaded."));
+		stageStart = micros();
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Switching to SD card logger."));
+		delay(500);
+		if (initializeLogger(true))
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Switched to SD card logger."));
+		}
+		else
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to switch to SD card logger. Continue with serial logger."));
+			initializeLogger(false);
+		}
+		TesLight::BootProfiler::record(F("SD card logger"), stageStart);
+	}
+
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("TesLight initialized successfully."));
+	TesLight::BootProfiler::printSummary();
+}
+
+/**
+ * @brief Background task running {@link initializeSensorsAndNetwork} once.
+ * @param parameter unused
+ */
+void backgroundInitializationTask(void *parameter)
+{
+	initializeSensorsAndNetwork();
+	vTaskDelete(NULL);
+}
+
+/**
+ * @brief Initialize the software and hardware. Only the parts required to render the LEDs are initialized here,
+ * everything else is initialized in a background task to show the first frame as early as possible.
+ */
+void setup()
+{
+	unsigned long stageStart = micros();
+	initializeLogger(false);
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("TesLight booting up."));
+	printLogo();
+	TesLight::BootProfiler::record(F("Serial logger"), stageStart);
+
+	stageStart = micros();
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Initialize and load configuration."));
+	const bool configurationLoaded = initializeConfiguration();
+	if (configurationLoaded)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Runtime configuration loaded."));
 	}
 	else
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to load LEDs and animators. Continue without rendering LEDs."));
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Failed to load configuration. Loading defaults and continue."));
+		configuration->loadDefaults();
 	}
+	TesLight::BootProfiler::record(F("Configuration"), stageStart);
 
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Creating to WiFi network."));
-	if (createtWiFiNetwork())
+	stageStart = micros();
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Initialize SD card."));
+	sdCardAvailable = initializeSdCard();
+	if (sdCardAvailable)
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("WiFi Network created."));
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("SD card initialized."));
 	}
 	else
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to create WiFi network. Continuing without WiFi network. The REST API might be inaccessible."));
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to initialize SD card. Continue without SD card."));
 	}
 
+	if (sdCardAvailable)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Check if system update is available."));
+		if (updateAvilable())
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("System update package was found. Installing..."));
+			handleUpdate();
+		}
+		else
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("No available system update found."));
+		}
+
+		if (!configurationLoaded && importConfiguration())
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Runtime configuration imported from SD card."));
+		}
+		configuration->setBackupFile(&SD, CONFIGURATION_BACKUP_FILE_NAME);
+		TesLight::SensorRecorder::begin(&SD);
+		TesLight::SensorReplay::begin(&SD);
+	}
+	TesLight::BootProfiler::record(F("SD card"), stageStart);
+
+	stageStart = micros();
+	initializeFseqIndex();
+	TesLight::BootProfiler::record(F("Fseq index"), stageStart);
+
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Updating log level from configuration."));
+	const TesLight::Configuration::SystemConfig systemConfig = configuration->getSystemConfig();
+	TesLight::Logger::setMinLogLevel((TesLight::Logger::LogLevel)systemConfig.logLevel);
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Log level updated from configuration."));
+
+	stageStart = micros();
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Initialize LED Manager."));
+	initializeLedManager();
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("LED Manager initialized."));
+
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Load LEDs and animators from configuration using the LED Manager."));
+	if (ledManager->reloadAnimations())
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("LEDs and animators loaded."));
+	}
+	else
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to load LEDs and animators. Continue without rendering LEDs."));
+	}
+	TesLight::BootProfiler::record(F("LEDs and animators"), stageStart);
+
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Initialize timers."));
 	initializeTimers();
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Timers initialized."));
@@ -495,7 +661,14 @@ void setup()
 	esp_task_wdt_add(NULL);
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Watchdog initialized."));
 
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("TesLight initialized successfully, going into work mode."));
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Start background initialization of sensors and network."));
+	if (xTaskCreatePinnedToCore(backgroundInitializationTask, "boot", BOOT_TASK_STACK_SIZE, nullptr, BOOT_TASK_PRIORITY, nullptr, BOOT_TASK_CORE) != pdPASS)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to start background task. Initializing in foreground."));
+		initializeSensorsAndNetwork();
+	}
+
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("LEDs are running, going into work mode."));
 }
 
 /**
@@ -503,17 +676,41 @@ void setup()
  */
 void loop()
 {
+	// Receive realtime LED data
+	ledManager->receiveStream();
+
 	// Handle the LEDs
 	if (checkTimer(ledTimer, ledManager->getTargetFrameTime()))
 	{
+		// Interpolate the motion sensor data to the frame time, the sensor is read by the I²C bus task
+		if (sensorsReady)
+		{
+			ledManager->updateMotionSensorData(motionSensor);
+		}
 		ledManager->render();
 		ledManager->show();
+
+		// Use the OneWire bus right after the frame was shown, so that it can't delay the next frame
+		if (sensorsReady)
+		{
+			temperatureSensor->run();
+		}
+		TesLight::BootProfiler::markFirstFrame();
 		ledFrameCounter++;
 		ledPowerCounter += ledManager->getLedPowerDraw();
+
+		float regulatorPower[REGULATOR_COUNT];
+		bool regulatorLimited[REGULATOR_COUNT];
+		for (uint8_t i = 0; i < REGULATOR_COUNT; i++)
+		{
+			regulatorPower[i] = ledManager->getRegulatorPowerDraw(i);
+			regulatorLimited[i] = ledManager->isRegulatorLimited(i);
+		}
+		TesLight::Telemetry::addFrame(regulatorPower, regulatorLimited);
 	}
 
 	// Handle the light sensor
-	if (checkTimer(lightSensorTimer, LIGHT_SENSOR_CYCLE_TIME))
+	if (sensorsReady && checkTimer(lightSensorTimer, LIGHT_SENSOR_CYCLE_TIME))
 	{
 		float brightness;
 		if (ledManager->getAmbientBrightness(brightness) && lightSensor->getBrightness(brightness, motionSensor))
@@ -527,22 +724,8 @@ void loop()
 		}
 	}
 
-	// Handle the motion sensor
-	if (checkTimer(motionSensorTimer, MOTION_SENSOR_CYCLE_TIME))
-	{
-		if (motionSensor->run())
-		{
-			ledManager->setMotionSensorData(motionSensor->getMotion());
-		}
-		else
-		{
-			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to read motion sensor data. Delaying next read by 10s"));
-			motionSensorTimer += 10000000;
-		}
-	}
-
 	// Handle web server requests
-	if (checkTimer(webServerTimer, WEB_SERVER_CYCLE_TIME))
+	if (networkReady && checkTimer(webServerTimer, WEB_SERVER_CYCLE_TIME))
 	{
 		esp_task_wdt_delete(NULL);
 		webServerManager->handleRequest();
@@ -556,7 +739,7 @@ void loop()
 		const float fps = (float)ledFrameCounter / (STATUS_CYCLE_TIME / 1000000);
 		const float powerDraw = ledPowerCounter / ledFrameCounter;
 		float temperature;
-		if (!temperatureSensor->getMaxTemperature(temperature))
+		if (!sensorsReady || !temperatureSensor->getMaxTemperature(temperature))
 		{
 			temperature = 0.0f;
 		}
@@ -566,13 +749,23 @@ void loop()
 	}
 
 	// Handle the temperature measurement and fan controller
-	if (checkTimer(temperatureTimer, TEMP_CYCLE_TIME))
+	if (sensorsReady && checkTimer(temperatureTimer, TEMP_CYCLE_TIME))
 	{
 		float temp;
-		if (temperatureSensor->getMaxTemperature(temp))
+		bool success = temperatureSensor->getMaxTemperature(temp);
+		for (uint8_t i = 0; i < REGULATOR_COUNT && success; i++)
+		{
+			float regulatorTemp;
+			success = temperatureSensor->getRegulatorTemperature(i, regulatorTemp);
+			if (success)
+			{
+				ledManager->setRegulatorTemperature(i, regulatorTemp);
+			}
+		}
+
+		if (success)
 		{
-			ledManager->setRegulatorTemperature(temp);
-			fanController->setTemperature(temp > -75.0f ? temp : configuration->getSystemConfig().fanMaxTemperature);
+			fanController->update(temp > -75.0f ? temp : configuration->getSystemConfig().fanMaxTemperature, ledManager->getLedPowerDraw());
 		}
 		else
 		{
@@ -581,6 +774,36 @@ void loop()
 		}
 	}
 
+	// Collect the telemetry history, the fan controller is created by the background initialization
+	if (checkTimer(telemetryTimer, TELEMETRY_CYCLE_TIME))
+	{
+		float regulatorTemperature[REGULATOR_COUNT];
+		for (uint8_t i = 0; i < REGULATOR_COUNT; i++)
+		{
+			regulatorTemperature[i] = ledManager->getRegulatorTemperature(i);
+		}
+		TesLight::Telemetry::update(regulatorTemperature, sensorsReady ? fanController->getPwm() : 0);
+	}
+
+	// Write the sensor recording and read the sensor replay
+	if (checkTimer(sensorRecorderTimer, SENSOR_RECORDER_CYCLE_TIME))
+	{
+		TesLight::SensorRecorder::flush();
+		TesLight::SensorReplay::update();
+	}
+
+	// Apply and save the motion sensor calibration once the I²C bus task has finished it
+	TesLight::Configuration::MotionSensorCalibration motionSensorCalibration;
+	if (sensorsReady && motionSensor->getFinishedCalibration(motionSensorCalibration))
+	{
+		configuration->setMotionSensorCalibration(motionSensorCalibration);
+		motionSensor->setCalibration(motionSensorCalibration);
+		configuration->save();
+	}
+
+	// Write pending configuration changes
+	configuration->flush();
+
 	// Reset the watchdog timer
 	esp_task_wdt_reset();
 }
@@ -607,16 +830,16 @@ bool applySystemConfig()
  */
 bool applyLedConfig()
 {
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("LED configuration has changed. Reload LEDs and animators using the LED Manager."));
-	if (ledManager->reloadAnimations())
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("LED configuration has changed. Update LEDs and animators using the LED Manager."));
+	if (ledManager->updateAnimations())
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("LEDs and animators reloaded."));
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("LEDs and animators updated."));
 		initializeTimers();
 		return true;
 	}
 	else
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to reload LEDs and animators. Continue without rendering LEDs."));
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to update LEDs and animators. Continue without rendering LEDs."));
 		initializeTimers();
 		return false;
 	}
@@ -0,0 +1,136 @@
+/**
+ * @file I2CBusManager.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the {@link TesLight::I2CBusManager}.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "sensor/I2CBusManager.h"
+
+/**
+ * @brief Create a new instance of {@link TesLight::I2CBusManager}.
+ * @param motionSensor motion sensor to read, can be a nullptr
+ * @param lightSensor light sensor to read, can be a nullptr
+ */
+TesLight::I2CBusManager::I2CBusManager(TesLight::MotionSensor *motionSensor, TesLight::LightSensor *lightSensor)
+{
+	this->motionSensor = motionSensor;
+	this->lightSensor = lightSensor;
+	this->taskHandle = nullptr;
+	this->running = false;
+	this->motionSensorTimer = 0;
+	this->lightSensorTimer = 0;
+}
+
+/**
+ * @brief Delete the {@link TesLight::I2CBusManager} instance and stop the task.
+ */
+TesLight::I2CBusManager::~I2CBusManager()
+{
+	this->end();
+}
+
+/**
+ * @brief Start the task reading the I²C sensors.
+ * @return true when successful
+ * @return false when the task could not be created
+ */
+bool TesLight::I2CBusManager::begin()
+{
+	if (this->running)
+	{
+		return true;
+	}
+
+	Wire.setTimeOut(IIC_TIMEOUT);
+	this->motionSensorTimer = micros();
+	this->lightSensorTimer = micros();
+	this->running = true;
+	if (xTaskCreatePinnedToCore(TesLight::I2CBusManager::task, "i2c", IIC_BUS_TASK_STACK_SIZE, this, IIC_BUS_TASK_PRIORITY, &this->taskHandle, IIC_BUS_TASK_CORE) != pdPASS)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to create the I²C bus task."));
+		this->running = false;
+		this->taskHandle = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Stop the task reading the I²C sensors and wait until it has finished.
+ */
+void TesLight::I2CBusManager::end()
+{
+	this->running = false;
+	while (this->taskHandle != nullptr)
+	{
+		vTaskDelay(pdMS_TO_TICKS(1));
+	}
+}
+
+/**
+ * @brief Entry point of the I²C bus task.
+ * @param parameter pointer to the {@link TesLight::I2CBusManager} instance
+ */
+void TesLight::I2CBusManager::task(void *parameter)
+{
+	TesLight::I2CBusManager *busManager = (TesLight::I2CBusManager *)parameter;
+	busManager->run();
+	busManager->taskHandle = nullptr;
+	vTaskDelete(NULL);
+}
+
+/**
+ * @brief Main loop of the I²C bus task. Each device is read at its own rate.
+ * When a device can not be read, it is not read again for {@link IIC_BUS_ERROR_DELAY} µs.
+ */
+void TesLight::I2CBusManager::run()
+{
+	while (this->running)
+	{
+		if (this->motionSensor != nullptr && this->checkTimer(this->motionSensorTimer, MOTION_SENSOR_CYCLE_TIME))
+		{
+			if (!this->motionSensor->run())
+			{
+				TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to read motion sensor data. Delaying next read by 10s"));
+				this->motionSensorTimer += IIC_BUS_ERROR_DELAY;
+			}
+		}
+
+		if (this->lightSensor != nullptr && this->checkTimer(this->lightSensorTimer, LIGHT_SENSOR_CYCLE_TIME))
+		{
+			if (!this->lightSensor->updateBh1750())
+			{
+				TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to read BH1750 light sensor data. Delaying next read by 10s"));
+				this->lightSensorTimer += IIC_BUS_ERROR_DELAY;
+			}
+		}
+
+		vTaskDelay(pdMS_TO_TICKS(1));
+	}
+}
+
+/**
+ * @brief Check if a timer has expired and advance it by the cycle time.
+ * @param timer timer to check
+ * @param cycleTime cycle time of the timer in µs
+ * @return true when the timer expired
+ * @return false when the timer did not expire yet
+ */
+bool TesLight::I2CBusManager::checkTimer(unsigned long &timer, const unsigned long cycleTime)
+{
+	const unsigned long time = micros();
+	if ((long)(time - timer) < (long)cycleTime)
+	{
+		return false;
+	}
+
+	timer += cycleTime;
+	if ((long)(time - timer) > (long)cycleTime)
+	{
+		timer = time;
+	}
+	return true;
+}
@@ -16,6 +16,8 @@ TesLight::LightSensor::LightSensor(TesLight::Configuration *configuration)
 {
 	this->configuration = configuration;
 	this->esp32adc = new TesLight::ESP32ADC(LIGHT_SENSOR_ADC_PIN, INPUT, 3.3f);
+	this->adcMode = false;
+	this->updateAdcMode((TesLight::LightSensor::LightSensorMode)this->configuration->getSystemConfig().lightSensorMode);
 	this->bh1750 = new TesLight::BH1750(IIC_ADDRESS_BH1750);
 	if (!this->bh1750->begin())
 	{
@@ -43,6 +45,7 @@ TesLight::LightSensor::LightSensor(TesLight::Configuration *configuration)
 	this->motionData.temperatureRaw = 0;
 	this->motionData.temperatureDeg = 0;
 	this->motionSensorTriggerTime = millis();
+	this->bh1750Sample.write({0.0f, false});
 }
 
 /**
@@ -59,8 +62,42 @@ TesLight::LightSensor::~LightSensor()
 	}
 }
 
+/**
+ * @brief Read the BH1750 sensor and publish the value for {@link TesLight::LightSensor::getBrightness}.
+ * The sensor is only read when one of the BH1750 modes is active. While a replay is running, the recorded value is used instead.
+ * This must only be called from the task owning the I²C bus.
+ * @return true when successful or the sensor is not used
+ * @return false when there was an error reading the sensor
+ */
+bool TesLight::LightSensor::updateBh1750()
+{
+	const TesLight::LightSensor::LightSensorMode lightSensorMode = (TesLight::LightSensor::LightSensorMode)this->configuration->getSystemConfig().lightSensorMode;
+	if (!this->bh1750 || (lightSensorMode != TesLight::LightSensor::LightSensorMode::AUTO_ON_OFF_BH1750 && lightSensorMode != TesLight::LightSensor::LightSensorMode::AUTO_BRIGHTNESS_BH1750))
+	{
+		return true;
+	}
+
+	TesLight::LightSensor::Bh1750Sample sample;
+	sample.lux = 0.0f;
+	if (TesLight::SensorReplay::isActive())
+	{
+		sample.valid = TesLight::SensorReplay::getLight(sample.lux);
+		this->bh1750Sample.write(sample);
+		return true;
+	}
+
+	sample.valid = this->bh1750->getLux(sample.lux);
+	this->bh1750Sample.write(sample);
+	if (sample.valid)
+	{
+		TesLight::SensorRecorder::recordLight(sample.lux);
+	}
+	return sample.valid;
+}
+
 /**
  * @brief Return the brightness of the lights based on the sensors mode.
+ * The BH1750 and motion sensor values are taken from the latest snapshots, so this never waits for the I²C bus.
  * @param brightness 0.0 for minimum brightness up to 1.0 for maximum brightness
  * @param motionSensor reference to a {@link TesLight::MotionSensor} instance
  * @return true when successful
@@ -77,6 +114,7 @@ bool TesLight::LightSensor::getBrightness(float &brightness, TesLight::MotionSen
 	const float minLedBrightness = systemConfig.lightSensorMinLedBrightness / 255.0f;
 	const float maxLedBrightness = systemConfig.lightSensorMaxLedBrightness / 255.0f;
 	const uint8_t duration = systemConfig.lightSensorDuration;
+	this->updateAdcMode(lightSensorMode);
 
 	// Always off
 	if (lightSensorMode == TesLight::LightSensor::LightSensorMode::ALWAYS_OFF)
@@ -95,12 +133,7 @@ bool TesLight::LightSensor::getBrightness(float &brightness, TesLight::MotionSen
 	// Auto on/off using ADC
 	else if (lightSensorMode == TesLight::LightSensor::LightSensorMode::AUTO_ON_OFF_ADC)
 	{
-		float value = 0.0f;
-		for (uint8_t i = 0; i < 10; i++)
-		{
-			value += this->esp32adc->getAnalogVoltage() / 3.3f;
-		}
-		value /= 10.0f;
+		const float value = this->esp32adc->getAnalogVoltage() / 3.3f;
 
 		if (value > threshold + antiFlickerThreshold)
 		{
@@ -117,12 +150,7 @@ bool TesLight::LightSensor::getBrightness(float &brightness, TesLight::MotionSen
 	// Auto brightness using ADC
 	else if (lightSensorMode == TesLight::LightSensor::LightSensorMode::AUTO_BRIGHTNESS_ADC)
 	{
-		float value = 0.0f;
-		for (uint8_t i = 0; i < 10; i++)
-		{
-			value += this->esp32adc->getAnalogVoltage(false);
-		}
-		value /= 33.0f; // 3.3V * 10
+		float value = this->esp32adc->getAnalogVoltage(false) / 3.3f;
 
 		if (value < threshold - antiFlickerThreshold)
 		{
@@ -158,10 +186,11 @@ bool TesLight::LightSensor::getBrightness(float &brightness, TesLight::MotionSen
 	// Auto on/off using BH1750
 	else if (lightSensorMode == TesLight::LightSensor::LightSensorMode::AUTO_ON_OFF_BH1750 && this->bh1750)
 	{
-		float lux = 0.0f;
-		if (!this->bh1750->getLux(lux))
+		const TesLight::LightSensor::Bh1750Sample sample = this->bh1750Sample.read();
+		float lux = sample.lux;
+		if (!sample.valid)
 		{
-			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Light sensor mode is AUTO_ON_OFF_BH1750 but the BH1750 sensor was not found on the I²C bus."));
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Light sensor mode is AUTO_ON_OFF_BH1750 but the BH1750 sensor could not be read."));
 			brightness = 1.0f;
 			return false;
 		}
@@ -182,10 +211,11 @@ bool TesLight::LightSensor::getBrightness(float &brightness, TesLight::MotionSen
 	// Auto brightness using BH1750
 	else if (lightSensorMode == TesLight::LightSensor::LightSensorMode::AUTO_BRIGHTNESS_BH1750 && this->bh1750)
 	{
-		float lux = 0.0f;
-		if (!this->bh1750->getLux(lux))
+		const TesLight::LightSensor::Bh1750Sample sample = this->bh1750Sample.read();
+		float lux = sample.lux;
+		if (!sample.valid)
 		{
-			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Light sensor mode is AUTO_BRIGHTNESS_BH1750 but the BH1750 sensor was not found on the I²C bus."));
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Light sensor mode is AUTO_BRIGHTNESS_BH1750 but the BH1750 sensor could not be read."));
 			brightness = 1.0f;
 			return false;
 		}
@@ -247,3 +277,27 @@ bool TesLight::LightSensor::getBrightness(float &brightness, TesLight::MotionSen
 	brightness = 0.0f;
 	return false;
 }
+
+/**
+ * @brief Start the continuous sampling of the ADC when one of the ADC modes is selected and stop it otherwise.
+ * This keeps the I2S peripheral and ADC1 free and avoids the DMA interrupts while the ADC is not used.
+ * @param lightSensorMode currently selected mode of the light sensor
+ */
+void TesLight::LightSensor::updateAdcMode(const TesLight::LightSensor::LightSensorMode lightSensorMode)
+{
+	const bool adcMode = lightSensorMode == TesLight::LightSensor::LightSensorMode::AUTO_ON_OFF_ADC || lightSensorMode == TesLight::LightSensor::LightSensorMode::AUTO_BRIGHTNESS_ADC;
+	if (adcMode == this->adcMode)
+	{
+		return;
+	}
+
+	this->adcMode = adcMode;
+	if (!adcMode)
+	{
+		this->esp32adc->stopContinuous();
+	}
+	else if (!this->esp32adc->startContinuous())
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Failed to start the continuous sampling of the ADC. The ADC will be read on request."));
+	}
+}
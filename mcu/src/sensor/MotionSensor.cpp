@@ -8,15 +8,16 @@
  */
 #include "sensor/MotionSensor.h"
 
+volatile bool TesLight::MotionSensor::dataReady = false;
+
 /**
  * @brief Create a new instance of {@link TesLight::MotionSensor}.
  * @param sensorAddress address of the sensor on the I²C bus
- * @param configuration configuration of TesLight
+ * @param configuration configuration of TesLight, holding the initial calibration
  */
 TesLight::MotionSensor::MotionSensor(const uint8_t sensorAddress, TesLight::Configuration *configuration)
 {
 	this->mpu6050 = new TesLight::MPU6050(sensorAddress);
-	this->configuration = configuration;
 	this->motionData.accXRaw = 0;
 	this->motionData.accYRaw = 0;
 	this->motionData.accZRaw = 0;
@@ -36,6 +37,18 @@ TesLight::MotionSensor::MotionSensor(const uint8_t sensorAddress, TesLight::Conf
 	this->motionData.pitchCompensatedAccYG = 0.0f;
 	this->motionData.temperatureRaw = 0;
 	this->motionData.temperatureDeg = 0;
+	this->history.data[0] = this->motionData;
+	this->history.timestamp[0] = 0;
+	this->history.newest = 0;
+	this->history.count = 0;
+	this->motionHistory.write(this->history);
+	this->calibrationRequested = false;
+	this->calibrationFailOnTemperature = false;
+	this->calibrationState = 5;
+	this->calibrationFinished = false;
+	this->calibration.write(configuration->getMotionSensorCalibration());
+	this->fifoBuffer = nullptr;
+	this->filter = new TesLight::MadgwickFilter(MOTION_SENSOR_FILTER_BETA, MOTION_SENSOR_GYRO_BIAS_RATE);
 	this->lastMeasure = 0;
 }
 
@@ -46,6 +59,13 @@ TesLight::MotionSensor::~MotionSensor()
 {
 	delete this->mpu6050;
 	this->mpu6050 = nullptr;
+	delete this->filter;
+	this->filter = nullptr;
+	if (this->fifoBuffer != nullptr)
+	{
+		delete[] this->fifoBuffer;
+		this->fifoBuffer = nullptr;
+	}
 }
 
 /**
@@ -72,17 +92,115 @@ bool TesLight::MotionSensor::begin()
 		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to set gyro scale of MPU6050 sensor."));
 		return false;
 	}
+	TesLight::SensorRecorder::setMotionScale(this->mpu6050->getAccScale(), this->mpu6050->getGyScale());
+
+	if (MOTION_SENSOR_FIFO_MODE)
+	{
+		if (!this->mpu6050->enableFifo(MOTION_SENSOR_SAMPLE_RATE_DIVIDER))
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to enable FIFO of MPU6050 sensor."));
+			return false;
+		}
+
+		if (MOTION_SENSOR_INT_PIN >= 0)
+		{
+			if (!this->mpu6050->setDataReadyInterrupt(true))
+			{
+				TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to enable data ready interrupt of MPU6050 sensor."));
+				return false;
+			}
+			pinMode(MOTION_SENSOR_INT_PIN, INPUT);
+			attachInterrupt(digitalPinToInterrupt(MOTION_SENSOR_INT_PIN), TesLight::MotionSensor::dataReadyIsr, RISING);
+		}
+
+		if (this->fifoBuffer == nullptr)
+		{
+			this->fifoBuffer = new TesLight::MPU6050::MPU6050MotionData[MOTION_SENSOR_FIFO_BATCH_SIZE];
+		}
+	}
 
 	return true;
 }
 
 /**
- * @brief Run the measurement and calculation cycle.
+ * @brief Run the measurement and calculation cycle and publish the new motion data.
+ * In FIFO mode all samples collected by the sensor are processed with the fixed sample rate.
+ * When the data ready interrupt is connected, the I²C bus is only used when new samples are available.
+ * A requested calibration is run instead of the measurement.
+ * This must only be called from the task owning the I²C bus.
  * @return true when successful
  * @return false when there was an error
  */
 bool TesLight::MotionSensor::run()
 {
+	if (this->calibrationRequested)
+	{
+		const uint8_t result = this->runCalibration(this->calibrationFailOnTemperature);
+		this->calibrationFinished = result == 0;
+		this->calibrationState = result;
+		this->calibrationRequested = false;
+		return result != 1;
+	}
+
+	return this->measure();
+}
+
+/**
+ * @brief Read the sensor and publish the new motion data. While a replay is running, the recorded samples are used instead.
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::MotionSensor::measure()
+{
+	if (TesLight::SensorReplay::isActive())
+	{
+		TesLight::MPU6050::MPU6050MotionData sensorData;
+		float timeScale;
+		unsigned long timestamp;
+		bool updated = false;
+		while (TesLight::SensorReplay::getMotionData(sensorData, timeScale, timestamp))
+		{
+			this->processSample(sensorData, timeScale, timestamp);
+			updated = true;
+		}
+		if (updated)
+		{
+			this->motionHistory.write(this->history);
+		}
+		this->lastMeasure = 0;
+		return true;
+	}
+
+	if (this->fifoBuffer != nullptr)
+	{
+		if (MOTION_SENSOR_INT_PIN >= 0 && !TesLight::MotionSensor::dataReady)
+		{
+			return true;
+		}
+		TesLight::MotionSensor::dataReady = false;
+
+		uint16_t count = 0;
+		if (!this->mpu6050->getFifoData(this->fifoBuffer, MOTION_SENSOR_FIFO_BATCH_SIZE, count))
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to read sensor data from the FIFO of the MPU6050."));
+			return false;
+		}
+
+		const float timeScale = (1.0f + MOTION_SENSOR_SAMPLE_RATE_DIVIDER) / 1000.0f;
+		const unsigned long readTime = micros();
+		for (uint16_t i = 0; i < count; i++)
+		{
+			const unsigned long timestamp = readTime - (count - 1 - i) * (1 + MOTION_SENSOR_SAMPLE_RATE_DIVIDER) * 1000;
+			TesLight::SensorRecorder::recordMotion(this->fifoBuffer[i], timestamp);
+			this->processSample(this->fifoBuffer[i], timeScale, timestamp);
+		}
+		if (count > 0)
+		{
+			this->motionHistory.write(this->history);
+		}
+		return true;
+	}
+
 	TesLight::MPU6050::MPU6050MotionData sensorData;
 	if (!this->mpu6050->getData(sensorData))
 	{
@@ -90,51 +208,90 @@ bool TesLight::MotionSensor::run()
 		return false;
 	}
 
-	const TesLight::Configuration::MotionSensorCalibration calibrationData = this->configuration->getMotionSensorCalibration();
 	const unsigned long timeStep = this->lastMeasure == 0 ? 0.0f : (micros() - this->lastMeasure);
 	const float timeScale = timeStep / 1000000.0f;
 	this->lastMeasure = micros();
+	TesLight::SensorRecorder::recordMotion(sensorData, this->lastMeasure);
+	this->processSample(sensorData, timeScale, this->lastMeasure);
+	this->motionHistory.write(this->history);
 
-	this->motionData.accXRaw = sensorData.accXRaw - calibrationData.accXRaw;
-	this->motionData.accYRaw = sensorData.accYRaw - calibrationData.accYRaw;
-	this->motionData.accZRaw = sensorData.accZRaw - calibrationData.accZRaw;
-	this->motionData.gyroXRaw = sensorData.gyroXRaw - calibrationData.gyroXRaw;
-	this->motionData.gyroYRaw = sensorData.gyroYRaw - calibrationData.gyroYRaw;
-	this->motionData.gyroZRaw = sensorData.gyroZRaw - calibrationData.gyroZRaw;
-	this->motionData.accXG = sensorData.accXG - calibrationData.accXG;
-	this->motionData.accYG = sensorData.accYG - calibrationData.accYG;
-	this->motionData.accZG = sensorData.accZG - calibrationData.accZG;
-	this->motionData.gyroXDeg = sensorData.gyroXDeg - calibrationData.gyroXDeg;
-	this->motionData.gyroYDeg = sensorData.gyroYDeg - calibrationData.gyroYDeg;
-	this->motionData.gyroZDeg = sensorData.gyroZDeg - calibrationData.gyroZDeg;
-	this->motionData.temperatureRaw = sensorData.temperatureRaw;
-	this->motionData.temperatureDeg = sensorData.temperatureDeg;
+	return true;
+}
 
-	this->motionData.pitch += this->motionData.gyroXDeg * timeScale;
-	this->motionData.roll += this->motionData.gyroYDeg * timeScale;
-	this->motionData.yaw += this->motionData.gyroZDeg * timeScale;
+/**
+ * @brief Request a calibration of the motion sensor. The calibration is run by the task owning the I²C bus,
+ * so this returns immediately. The result can be checked with {@link TesLight::MotionSensor::getCalibrationState}.
+ * @param failOnTemperature if set to true, the calibration will fail when the sensor is too cold or warm
+ * @return true when the calibration was requested
+ * @return false when a calibration is already running
+ */
+bool TesLight::MotionSensor::startCalibration(const bool failOnTemperature)
+{
+	if (this->calibrationRequested)
+	{
+		return false;
+	}
 
-	const float accPitch = atan(this->motionData.accYG / this->motionData.accZG) * 180.0f / PI;
-	this->motionData.pitch += (accPitch - this->motionData.pitch) / 500.0f;
+	this->calibrationFailOnTemperature = failOnTemperature;
+	this->calibrationState = 4;
+	this->calibrationRequested = true;
+	return true;
+}
 
-	const float accRoll = -atan(this->motionData.accXG / this->motionData.accZG) * 180.0f / PI;
-	this->motionData.roll += (accRoll - this->motionData.roll) / 500.0f;
+/**
+ * @brief Get the state of the last calibration.
+ * @return 0 when successful
+ * @return 1 when there is a communication error
+ * @return 2 when the motion sensor is too cold
+ * @return 3 when the motion sensor is too warm
+ * @return 4 when the calibration is running
+ * @return 5 when no calibration was started
+ */
+uint8_t TesLight::MotionSensor::getCalibrationState()
+{
+	return this->calibrationState;
+}
 
-	this->motionData.rollCompensatedAccXG = this->motionData.accXG + sin(this->motionData.roll / 180.0f * PI);
-	this->motionData.pitchCompensatedAccYG = this->motionData.accYG - sin(this->motionData.pitch / 180.0f * PI);
+/**
+ * @brief Get the result of a successfully finished calibration, so that it can be applied and saved.
+ * The result is not used by the motion sensor before it was applied with {@link TesLight::MotionSensor::setCalibration}.
+ * This only returns true once per calibration.
+ * @param calibration reference variable holding the new calibration
+ * @return true when a calibration was finished since the last call
+ * @return false when there is no new calibration
+ */
+bool TesLight::MotionSensor::getFinishedCalibration(TesLight::Configuration::MotionSensorCalibration &calibration)
+{
+	if (!this->calibrationFinished)
+	{
+		return false;
+	}
 
+	calibration = this->calibrationResult.read();
+	this->calibrationFinished = false;
 	return true;
 }
 
 /**
- * @brief Calibrate the motion sensor.
+ * @brief Set the calibration that is applied to the samples of the motion sensor.
+ * This must only be called from a single task, usually the main loop which also owns the configuration.
+ * @param calibration calibration of the motion sensor
+ */
+void TesLight::MotionSensor::setCalibration(const TesLight::Configuration::MotionSensorCalibration calibration)
+{
+	this->calibration.write(calibration);
+}
+
+/**
+ * @brief Run the calibration. This must only be called from the task owning the I²C bus.
+ * The result is kept until it is requested by {@link TesLight::MotionSensor::getFinishedCalibration}.
  * @param failOnTemperature if set to true, the calibration will fail when the sensor is too cold or warm
  * @return 0 when successful
  * @return 1 when there is a communication error
  * @return 2 when the motion sensor is too cold
  * @return 3 when the motion sensor is too warm
  */
-uint8_t TesLight::MotionSensor::calibrate(const bool failOnTemperature)
+uint8_t TesLight::MotionSensor::runCalibration(const bool failOnTemperature)
 {
 	if (failOnTemperature)
 	{
@@ -181,7 +338,7 @@ uint8_t TesLight::MotionSensor::calibrate(const bool failOnTemperature)
 		calibrationData[11] += sensorData.gyroZDeg / 1000.0f;
 	}
 
-	TesLight::Configuration::MotionSensorCalibration calibration = this->configuration->getMotionSensorCalibration();
+	TesLight::Configuration::MotionSensorCalibration calibration = this->calibration.read();
 	calibration.accXRaw = calibrationData[0];
 	calibration.accYRaw = calibrationData[1];
 	// calibration.accZRaw = calibrationData[2];
@@ -194,16 +351,188 @@ uint8_t TesLight::MotionSensor::calibrate(const bool failOnTemperature)
 	calibration.gyroXDeg = calibrationData[9];
 	calibration.gyroYDeg = calibrationData[10];
 	calibration.gyroZDeg = calibrationData[11];
-	this->configuration->setMotionSensorCalibration(calibration);
+	this->calibrationResult.write(calibration);
+	this->filter->reset();
 
 	return 0;
 }
 
 /**
- * @brief Get the current motion data.
+ * @brief Get a snapshot of the latest motion data. This never waits for the I²C bus.
  * @return full set of motion data
  */
 TesLight::MotionSensor::MotionSensorData TesLight::MotionSensor::getMotion()
 {
-	return this->motionData;
+	const TesLight::MotionSensor::MotionHistory history = this->motionHistory.read();
+	return history.data[history.newest];
+}
+
+/**
+ * @brief Get the motion data at a given time. The time is delayed by {@link MOTION_SENSOR_INTERPOLATION_DELAY}
+ * and the motion data is interpolated between the two samples around it. When the time is newer than the latest sample,
+ * the motion data is extrapolated by at most one sample interval. This never waits for the I²C bus.
+ * @param time time in µs for which the motion data is requested, usually the presentation time of a LED frame
+ * @param motionData variable to hold the motion data
+ */
+void TesLight::MotionSensor::getMotion(const unsigned long time, TesLight::MotionSensor::MotionSensorData &motionData)
+{
+	const TesLight::MotionSensor::MotionHistory history = this->motionHistory.read();
+	if (history.count < 2)
+	{
+		motionData = history.data[history.newest];
+		return;
+	}
+
+	// Search for the latest sample that is older than the requested time, starting with the newest pair
+	const unsigned long targetTime = time - MOTION_SENSOR_INTERPOLATION_DELAY;
+	uint8_t newer = history.newest;
+	for (uint8_t i = 1; i < history.count; i++)
+	{
+		const uint8_t older = (newer + MOTION_SENSOR_HISTORY_SIZE - 1) % MOTION_SENSOR_HISTORY_SIZE;
+		if ((long)(targetTime - history.timestamp[older]) >= 0 || i == history.count - 1)
+		{
+			const unsigned long interval = history.timestamp[newer] - history.timestamp[older];
+			float factor = interval > 0 ? (long)(targetTime - history.timestamp[older]) / (float)interval : 1.0f;
+			if (factor < 0.0f)
+			{
+				factor = 0.0f;
+			}
+			else if (factor > 2.0f)
+			{
+				factor = 2.0f;
+			}
+
+			TesLight::MotionSensor::interpolate(history.data[older], history.data[newer], factor, motionData);
+			return;
+		}
+		newer = older;
+	}
+}
+
+/**
+ * @brief Interrupt handler for the data ready interrupt of the MPU6050.
+ */
+void IRAM_ATTR TesLight::MotionSensor::dataReadyIsr()
+{
+	TesLight::MotionSensor::dataReady = true;
+}
+
+/**
+ * @brief Apply the calibration to a sample and update the motion data.
+ * @param sensorData sample of the MPU6050
+ * @param timeScale time since the previous sample in seconds
+ * @param timestamp time in µs when the sample was taken
+ */
+void TesLight::MotionSensor::processSample(const TesLight::MPU6050::MPU6050MotionData &sensorData, const float timeScale, const unsigned long timestamp)
+{
+	const TesLight::Configuration::MotionSensorCalibration calibrationData = this->calibration.read();
+	this->motionData.accXRaw = sensorData.accXRaw - calibrationData.accXRaw;
+	this->motionData.accYRaw = sensorData.accYRaw - calibrationData.accYRaw;
+	this->motionData.accZRaw = sensorData.accZRaw - calibrationData.accZRaw;
+	this->motionData.gyroXRaw = sensorData.gyroXRaw - calibrationData.gyroXRaw;
+	this->motionData.gyroYRaw = sensorData.gyroYRaw - calibrationData.gyroYRaw;
+	this->motionData.gyroZRaw = sensorData.gyroZRaw - calibrationData.gyroZRaw;
+	this->motionData.accXG = sensorData.accXG - calibrationData.accXG;
+	this->motionData.accYG = sensorData.accYG - calibrationData.accYG;
+	this->motionData.accZG = sensorData.accZG - calibrationData.accZG;
+	this->motionData.gyroXDeg = sensorData.gyroXDeg - calibrationData.gyroXDeg;
+	this->motionData.gyroYDeg = sensorData.gyroYDeg - calibrationData.gyroYDeg;
+	this->motionData.gyroZDeg = sensorData.gyroZDeg - calibrationData.gyroZDeg;
+	this->motionData.temperatureRaw = sensorData.temperatureRaw;
+	this->motionData.temperatureDeg = sensorData.temperatureDeg;
+
+	TesLight::MotionSensor::rotateToVehicle(this->motionData.accXG, this->motionData.accYG, this->motionData.accZG);
+	TesLight::MotionSensor::rotateToVehicle(this->motionData.gyroXDeg, this->motionData.gyroYDeg, this->motionData.gyroZDeg);
+
+	this->filter->update(this->motionData.gyroXDeg * DEG_TO_RAD, this->motionData.gyroYDeg * DEG_TO_RAD, this->motionData.gyroZDeg * DEG_TO_RAD,
+						 this->motionData.accXG, this->motionData.accYG, this->motionData.accZG, timeScale);
+	this->motionData.pitch = this->filter->getRotationX();
+	this->motionData.roll = this->filter->getRotationY();
+	this->motionData.yaw = this->filter->getRotationZ();
+
+	// Remove the gravity to get the linear acceleration of the car
+	float gravityX, gravityY, gravityZ;
+	this->filter->getGravity(gravityX, gravityY, gravityZ);
+	this->motionData.rollCompensatedAccXG = this->motionData.accXG - gravityX;
+	this->motionData.pitchCompensatedAccYG = this->motionData.accYG - gravityY;
+
+	// Add the sample to the history, it is published after all samples of a batch were processed
+	this->history.newest = (this->history.newest + 1) % MOTION_SENSOR_HISTORY_SIZE;
+	this->history.data[this->history.newest] = this->motionData;
+	this->history.timestamp[this->history.newest] = timestamp;
+	if (this->history.count < MOTION_SENSOR_HISTORY_SIZE)
+	{
+		this->history.count++;
+	}
+}
+
+/**
+ * @brief Interpolate between two motion samples. Raw values are taken from the closer sample.
+ * @param older older sample
+ * @param newer newer sample
+ * @param factor 0.0 for the older sample, 1.0 for the newer sample, values above 1.0 extrapolate
+ * @param motionData variable to hold the interpolated motion data
+ */
+void TesLight::MotionSensor::interpolate(const TesLight::MotionSensor::MotionSensorData &older, const TesLight::MotionSensor::MotionSensorData &newer, const float factor, TesLight::MotionSensor::MotionSensorData &motionData)
+{
+	motionData = factor < 0.5f ? older : newer;
+	motionData.accXG = older.accXG + (newer.accXG - older.accXG) * factor;
+	motionData.accYG = older.accYG + (newer.accYG - older.accYG) * factor;
+	motionData.accZG = older.accZG + (newer.accZG - older.accZG) * factor;
+	motionData.gyroXDeg = older.gyroXDeg + (newer.gyroXDeg - older.gyroXDeg) * factor;
+	motionData.gyroYDeg = older.gyroYDeg + (newer.gyroYDeg - older.gyroYDeg) * factor;
+	motionData.gyroZDeg = older.gyroZDeg + (newer.gyroZDeg - older.gyroZDeg) * factor;
+	motionData.pitch = TesLight::MotionSensor::interpolateAngle(older.pitch, newer.pitch, factor);
+	motionData.roll = older.roll + (newer.roll - older.roll) * factor;
+	motionData.yaw = TesLight::MotionSensor::interpolateAngle(older.yaw, newer.yaw, factor);
+	motionData.rollCompensatedAccXG = older.rollCompensatedAccXG + (newer.rollCompensatedAccXG - older.rollCompensatedAccXG) * factor;
+	motionData.pitchCompensatedAccYG = older.pitchCompensatedAccYG + (newer.pitchCompensatedAccYG - older.pitchCompensatedAccYG) * factor;
+}
+
+/**
+ * @brief Interpolate between two angles in the range of -180° to 180° along the shorter direction.
+ * @param older older angle in degree
+ * @param newer newer angle in degree
+ * @param factor 0.0 for the older angle, 1.0 for the newer angle
+ * @return float interpolated angle in degree
+ */
+float TesLight::MotionSensor::interpolateAngle(const float older, const float newer, const float factor)
+{
+	float difference = newer - older;
+	if (difference > 180.0f)
+	{
+		difference -= 360.0f;
+	}
+	else if (difference < -180.0f)
+	{
+		difference += 360.0f;
+	}
+
+	float angle = older + difference * factor;
+	if (angle > 180.0f)
+	{
+		angle -= 360.0f;
+	}
+	else if (angle < -180.0f)
+	{
+		angle += 360.0f;
+	}
+	return angle;
+}
+
+/**
+ * @brief Rotate a vector from the sensor frame into the vehicle frame using the mounting rotation.
+ * @param x x component of the vector
+ * @param y y component of the vector
+ * @param z z component of the vector
+ */
+void TesLight::MotionSensor::rotateToVehicle(float &x, float &y, float &z)
+{
+	static const float rotation[9] = MOTION_SENSOR_MOUNTING_ROTATION;
+	const float sensorX = x;
+	const float sensorY = y;
+	const float sensorZ = z;
+	x = rotation[0] * sensorX + rotation[1] * sensorY + rotation[2] * sensorZ;
+	y = rotation[3] * sensorX + rotation[4] * sensorY + rotation[5] * sensorZ;
+	z = rotation[6] * sensorX + rotation[7] * sensorY + rotation[8] * sensorZ;
 }
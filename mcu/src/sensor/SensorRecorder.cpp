@@ -0,0 +1,285 @@
+/**
+ * @file SensorRecorder.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the {@link TesLight::SensorRecorder}.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "sensor/SensorRecorder.h"
+
+// Initialize
+FS *TesLight::SensorRecorder::fileSystem = nullptr;
+File TesLight::SensorRecorder::file;
+volatile bool TesLight::SensorRecorder::recording = false;
+unsigned long TesLight::SensorRecorder::startTime = 0;
+uint8_t TesLight::SensorRecorder::accScale = 0;
+uint8_t TesLight::SensorRecorder::gyScale = 0;
+TesLight::SensorRecording::Record *TesLight::SensorRecorder::buffer = nullptr;
+TesLight::SensorRecording::Record *TesLight::SensorRecorder::writeBuffer = nullptr;
+uint16_t TesLight::SensorRecorder::bufferCount = 0;
+uint32_t TesLight::SensorRecorder::recordCount = 0;
+uint32_t TesLight::SensorRecorder::droppedCount = 0;
+portMUX_TYPE TesLight::SensorRecorder::lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Initialize the sensor recorder.
+ * @param _fileSystem file system for the recordings
+ */
+void TesLight::SensorRecorder::begin(FS *_fileSystem)
+{
+	TesLight::SensorRecorder::fileSystem = _fileSystem;
+}
+
+/**
+ * @brief Set the scales of the MPU6050. They are stored in the header of new recordings to convert the raw values.
+ * @param accScale scale of the acc
+ * @param gyScale scale of the gyro
+ */
+void TesLight::SensorRecorder::setMotionScale(const TesLight::MPU6050::MPU6050AccScale accScale, const TesLight::MPU6050::MPU6050GyScale gyScale)
+{
+	TesLight::SensorRecorder::accScale = accScale;
+	TesLight::SensorRecorder::gyScale = gyScale;
+}
+
+/**
+ * @brief Start a new recording. An existing recording with the same name is overwritten.
+ * @param fileName name of the recording, it is stored in the recording directory
+ * @return true when the recording was started
+ * @return false when there was an error creating the recording
+ */
+bool TesLight::SensorRecorder::start(const String fileName)
+{
+	if (TesLight::SensorRecorder::fileSystem == nullptr)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Can not start sensor recording because there is no file system."));
+		return false;
+	}
+
+	TesLight::SensorRecorder::stop();
+	if (!TesLight::SensorRecorder::fileSystem->exists(SENSOR_RECORDING_DIRECTORY) && !TesLight::SensorRecorder::fileSystem->mkdir(SENSOR_RECORDING_DIRECTORY))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to create recording directory."));
+		return false;
+	}
+
+	TesLight::SensorRecorder::file = TesLight::SensorRecorder::fileSystem->open((String)SENSOR_RECORDING_DIRECTORY + F("/") + fileName, FILE_WRITE);
+	if (!TesLight::SensorRecorder::file)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to create recording file."));
+		return false;
+	}
+
+	TesLight::SensorRecording::FileHeader header;
+	header.magic[0] = 'T';
+	header.magic[1] = 'L';
+	header.magic[2] = 'S';
+	header.magic[3] = 'R';
+	header.version = SENSOR_RECORDING_VERSION;
+	header.accScale = TesLight::SensorRecorder::accScale;
+	header.gyScale = TesLight::SensorRecorder::gyScale;
+	if (TesLight::SensorRecorder::file.write((uint8_t *)&header, sizeof(header)) != sizeof(header))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to write recording header."));
+		TesLight::SensorRecorder::file.close();
+		return false;
+	}
+
+	TesLight::SensorRecorder::buffer = new TesLight::SensorRecording::Record[SENSOR_RECORDER_BUFFER_SIZE];
+	TesLight::SensorRecorder::writeBuffer = new TesLight::SensorRecording::Record[SENSOR_RECORDER_BUFFER_SIZE];
+	TesLight::SensorRecorder::bufferCount = 0;
+	TesLight::SensorRecorder::recordCount = 0;
+	TesLight::SensorRecorder::droppedCount = 0;
+	TesLight::SensorRecorder::startTime = micros();
+	TesLight::SensorRecorder::recording = true;
+
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("Sensor recording '") + fileName + F("' started."));
+	return true;
+}
+
+/**
+ * @brief Stop the current recording and write the remaining records.
+ */
+void TesLight::SensorRecorder::stop()
+{
+	if (!TesLight::SensorRecorder::recording)
+	{
+		return;
+	}
+
+	portENTER_CRITICAL(&TesLight::SensorRecorder::lock);
+	TesLight::SensorRecorder::recording = false;
+	portEXIT_CRITICAL(&TesLight::SensorRecorder::lock);
+
+	if (!TesLight::SensorRecorder::writeRecords())
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to write the remaining sensor records."));
+	}
+	TesLight::SensorRecorder::file.close();
+	TesLight::SensorRecorder::freeBuffers();
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("Sensor recording stopped with ") + TesLight::SensorRecorder::recordCount + F(" records, ") + TesLight::SensorRecorder::droppedCount + F(" records were dropped."));
+}
+
+/**
+ * @brief Check if a recording is running.
+ * @return true when recording
+ * @return false when not recording
+ */
+bool TesLight::SensorRecorder::isRecording()
+{
+	return TesLight::SensorRecorder::recording;
+}
+
+/**
+ * @brief Get the number of records written to the current or last recording.
+ * @return number of records
+ */
+uint32_t TesLight::SensorRecorder::getRecordCount()
+{
+	return TesLight::SensorRecorder::recordCount;
+}
+
+/**
+ * @brief Get the number of records that were dropped because the buffer was full.
+ * @return number of dropped records
+ */
+uint32_t TesLight::SensorRecorder::getDroppedCount()
+{
+	return TesLight::SensorRecorder::droppedCount;
+}
+
+/**
+ * @brief Record a raw sample of the MPU6050.
+ * @param motionData sample of the MPU6050
+ * @param timestamp time in µs when the sample was taken
+ */
+void TesLight::SensorRecorder::recordMotion(const TesLight::MPU6050::MPU6050MotionData &motionData, const unsigned long timestamp)
+{
+	if (!TesLight::SensorRecorder::recording)
+	{
+		return;
+	}
+
+	const int16_t data[7] = {motionData.accXRaw, motionData.accYRaw, motionData.accZRaw, motionData.gyroXRaw, motionData.gyroYRaw, motionData.gyroZRaw, motionData.temperatureRaw};
+	TesLight::SensorRecorder::addRecord(TesLight::SensorRecording::RecordType::MOTION, 0, timestamp, data, sizeof(data));
+}
+
+/**
+ * @brief Record the brightness of the BH1750.
+ * @param lux brightness in lux
+ */
+void TesLight::SensorRecorder::recordLight(const float lux)
+{
+	if (!TesLight::SensorRecorder::recording)
+	{
+		return;
+	}
+
+	TesLight::SensorRecorder::addRecord(TesLight::SensorRecording::RecordType::LIGHT, 0, micros(), &lux, sizeof(lux));
+}
+
+/**
+ * @brief Record the temperature of a DS18B20.
+ * @param sensorIndex index of the sensor
+ * @param temperature temperature in °C
+ */
+void TesLight::SensorRecorder::recordTemperature(const uint8_t sensorIndex, const float temperature)
+{
+	if (!TesLight::SensorRecorder::recording)
+	{
+		return;
+	}
+
+	TesLight::SensorRecorder::addRecord(TesLight::SensorRecording::RecordType::TEMPERATURE, sensorIndex, micros(), &temperature, sizeof(temperature));
+}
+
+/**
+ * @brief Write the buffered records to the MicroSD card. This must be called regularly from the main loop.
+ * The recording is stopped when it reached the maximum duration.
+ * @return true when successful or not recording
+ * @return false when the records could not be written, the recording is stopped in this case
+ */
+bool TesLight::SensorRecorder::flush()
+{
+	if (!TesLight::SensorRecorder::recording)
+	{
+		return true;
+	}
+
+	if (!TesLight::SensorRecorder::writeRecords())
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to write sensor records. Stopping the recording."));
+		TesLight::SensorRecorder::stop();
+		return false;
+	}
+
+	if (micros() - TesLight::SensorRecorder::startTime > SENSOR_RECORDER_MAX_DURATION)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Sensor recording reached the maximum duration."));
+		TesLight::SensorRecorder::stop();
+	}
+	return true;
+}
+
+/**
+ * @brief Add a record to the buffer. This can be called from any task.
+ * @param type type of the record
+ * @param index index of the sensor
+ * @param timestamp time in µs when the value was measured
+ * @param data data of the record
+ * @param length length of the data, at most the size of the data field
+ */
+void TesLight::SensorRecorder::addRecord(const uint8_t type, const uint8_t index, const unsigned long timestamp, const void *data, const uint8_t length)
+{
+	portENTER_CRITICAL(&TesLight::SensorRecorder::lock);
+	if (TesLight::SensorRecorder::recording && TesLight::SensorRecorder::bufferCount < SENSOR_RECORDER_BUFFER_SIZE)
+	{
+		TesLight::SensorRecording::Record &record = TesLight::SensorRecorder::buffer[TesLight::SensorRecorder::bufferCount++];
+		record.type = type;
+		record.index = index;
+		record.timestamp = (long)(timestamp - TesLight::SensorRecorder::startTime) > 0 ? timestamp - TesLight::SensorRecorder::startTime : 0;
+		memset(record.data, 0, sizeof(record.data));
+		memcpy(record.data, data, length);
+	}
+	else if (TesLight::SensorRecorder::recording)
+	{
+		TesLight::SensorRecorder::droppedCount++;
+	}
+	portEXIT_CRITICAL(&TesLight::SensorRecorder::lock);
+}
+
+/**
+ * @brief Swap the record buffers and write the buffered records to the file.
+ * The sensors can continue recording into the other buffer while the data is written.
+ * @return true when successful
+ * @return false when the records could not be written
+ */
+bool TesLight::SensorRecorder::writeRecords()
+{
+	portENTER_CRITICAL(&TesLight::SensorRecorder::lock);
+	TesLight::SensorRecording::Record *records = TesLight::SensorRecorder::buffer;
+	const uint16_t count = TesLight::SensorRecorder::bufferCount;
+	TesLight::SensorRecorder::buffer = TesLight::SensorRecorder::writeBuffer;
+	TesLight::SensorRecorder::writeBuffer = records;
+	TesLight::SensorRecorder::bufferCount = 0;
+	portEXIT_CRITICAL(&TesLight::SensorRecorder::lock);
+
+	const size_t size = count * sizeof(TesLight::SensorRecording::Record);
+	if (count > 0 && TesLight::SensorRecorder::file.write((uint8_t *)records, size) != size)
+	{
+		return false;
+	}
+	TesLight::SensorRecorder::recordCount += count;
+	return true;
+}
+
+/**
+ * @brief Free the record buffers.
+ */
+void TesLight::SensorRecorder::freeBuffers()
+{
+	delete[] TesLight::SensorRecorder::buffer;
+	TesLight::SensorRecorder::buffer = nullptr;
+	delete[] TesLight::SensorRecorder::writeBuffer;
+	TesLight::SensorRecorder::writeBuffer = nullptr;
+}
@@ -0,0 +1,285 @@
+/**
+ * @file SensorReplay.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the {@link TesLight::SensorReplay}.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "sensor/SensorReplay.h"
+
+// Initialize
+FS *TesLight::SensorReplay::fileSystem = nullptr;
+File TesLight::SensorReplay::file;
+volatile bool TesLight::SensorReplay::active = false;
+unsigned long TesLight::SensorReplay::startTime = 0;
+float TesLight::SensorReplay::accScaleInv = 1.0f;
+float TesLight::SensorReplay::gyScaleInv = 1.0f;
+TesLight::SensorRecording::Record TesLight::SensorReplay::pendingRecord;
+bool TesLight::SensorReplay::hasPendingRecord = false;
+TesLight::SensorRecording::Record *TesLight::SensorReplay::motionBuffer = nullptr;
+uint16_t TesLight::SensorReplay::motionHead = 0;
+uint16_t TesLight::SensorReplay::motionCount = 0;
+uint32_t TesLight::SensorReplay::lastMotionTimestamp = 0;
+bool TesLight::SensorReplay::hasMotionTimestamp = false;
+float TesLight::SensorReplay::lux = 0.0f;
+bool TesLight::SensorReplay::luxValid = false;
+float TesLight::SensorReplay::temperature[SENSOR_REPLAY_MAX_TEMPERATURES];
+bool TesLight::SensorReplay::temperatureValid[SENSOR_REPLAY_MAX_TEMPERATURES];
+portMUX_TYPE TesLight::SensorReplay::lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Initialize the sensor replay.
+ * @param _fileSystem file system with the recordings
+ */
+void TesLight::SensorReplay::begin(FS *_fileSystem)
+{
+	TesLight::SensorReplay::fileSystem = _fileSystem;
+}
+
+/**
+ * @brief Start to replay a recording. The recording is replayed in real time from now on.
+ * @param fileName name of the recording in the recording directory
+ * @return true when the replay was started
+ * @return false when the recording could not be opened or is invalid
+ */
+bool TesLight::SensorReplay::start(const String fileName)
+{
+	if (TesLight::SensorReplay::fileSystem == nullptr)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Can not start sensor replay because there is no file system."));
+		return false;
+	}
+
+	TesLight::SensorReplay::stop();
+	TesLight::SensorReplay::file = TesLight::SensorReplay::fileSystem->open((String)SENSOR_RECORDING_DIRECTORY + F("/") + fileName, FILE_READ);
+	if (!TesLight::SensorReplay::file || TesLight::SensorReplay::file.isDirectory())
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to open recording file."));
+		return false;
+	}
+
+	TesLight::SensorRecording::FileHeader header;
+	if (TesLight::SensorReplay::file.read((uint8_t *)&header, sizeof(header)) != sizeof(header))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to read recording header."));
+		TesLight::SensorReplay::file.close();
+		return false;
+	}
+
+	if (header.magic[0] != 'T' || header.magic[1] != 'L' || header.magic[2] != 'S' || header.magic[3] != 'R' || header.version != SENSOR_RECORDING_VERSION)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("The recording file is invalid or has an unsupported version."));
+		TesLight::SensorReplay::file.close();
+		return false;
+	}
+
+	TesLight::SensorReplay::accScaleInv = 1.0f / TesLight::MPU6050::getScaleDiv((TesLight::MPU6050::MPU6050AccScale)header.accScale);
+	TesLight::SensorReplay::gyScaleInv = 1.0f / TesLight::MPU6050::getScaleDiv((TesLight::MPU6050::MPU6050GyScale)header.gyScale);
+	TesLight::SensorReplay::motionBuffer = new TesLight::SensorRecording::Record[SENSOR_REPLAY_MOTION_BUFFER_SIZE];
+	TesLight::SensorReplay::motionHead = 0;
+	TesLight::SensorReplay::motionCount = 0;
+	TesLight::SensorReplay::hasMotionTimestamp = false;
+	TesLight::SensorReplay::hasPendingRecord = false;
+	TesLight::SensorReplay::luxValid = false;
+	for (uint8_t i = 0; i < SENSOR_REPLAY_MAX_TEMPERATURES; i++)
+	{
+		TesLight::SensorReplay::temperatureValid[i] = false;
+	}
+	TesLight::SensorReplay::startTime = micros();
+	TesLight::SensorReplay::active = true;
+
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("Sensor replay of '") + fileName + F("' started."));
+	return true;
+}
+
+/**
+ * @brief Stop the replay. The sensors are read again.
+ */
+void TesLight::SensorReplay::stop()
+{
+	if (!TesLight::SensorReplay::active)
+	{
+		return;
+	}
+
+	portENTER_CRITICAL(&TesLight::SensorReplay::lock);
+	TesLight::SensorReplay::active = false;
+	TesLight::SensorRecording::Record *buffer = TesLight::SensorReplay::motionBuffer;
+	TesLight::SensorReplay::motionBuffer = nullptr;
+	TesLight::SensorReplay::motionCount = 0;
+	portEXIT_CRITICAL(&TesLight::SensorReplay::lock);
+
+	delete[] buffer;
+	TesLight::SensorReplay::file.close();
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Sensor replay stopped."));
+}
+
+/**
+ * @brief Check if a replay is running.
+ * @return true when the recorded values replace the sensor values
+ * @return false when the sensors are read
+ */
+bool TesLight::SensorReplay::isActive()
+{
+	return TesLight::SensorReplay::active;
+}
+
+/**
+ * @brief Read all records that are due from the recording. This must be called regularly from the main loop.
+ * The replay is stopped at the end of the recording.
+ * @return true when successful or not replaying
+ * @return false when there was an error reading the recording, the replay is stopped in this case
+ */
+bool TesLight::SensorReplay::update()
+{
+	if (!TesLight::SensorReplay::active)
+	{
+		return true;
+	}
+
+	const unsigned long elapsed = micros() - TesLight::SensorReplay::startTime;
+	while (true)
+	{
+		if (!TesLight::SensorReplay::hasPendingRecord)
+		{
+			const size_t bytesRead = TesLight::SensorReplay::file.read((uint8_t *)&TesLight::SensorReplay::pendingRecord, sizeof(TesLight::SensorRecording::Record));
+			if (bytesRead == 0)
+			{
+				TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Reached the end of the sensor recording."));
+				TesLight::SensorReplay::stop();
+				return true;
+			}
+			else if (bytesRead != sizeof(TesLight::SensorRecording::Record))
+			{
+				TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to read record from the sensor recording."));
+				TesLight::SensorReplay::stop();
+				return false;
+			}
+			TesLight::SensorReplay::hasPendingRecord = true;
+		}
+
+		// Stop when the record is not due yet or the motion sensor did not take the buffered records
+		if (TesLight::SensorReplay::pendingRecord.timestamp > elapsed || !TesLight::SensorReplay::applyRecord(TesLight::SensorReplay::pendingRecord))
+		{
+			return true;
+		}
+		TesLight::SensorReplay::hasPendingRecord = false;
+	}
+}
+
+/**
+ * @brief Get the next replayed sample of the MPU6050.
+ * @param motionData sample with the same content as if it was read from the MPU6050
+ * @param timeStep time since the previous sample in seconds
+ * @param timestamp time in µs when the sample is replayed
+ * @return true when a sample was returned
+ * @return false when there is no sample available or no replay is running
+ */
+bool TesLight::SensorReplay::getMotionData(TesLight::MPU6050::MPU6050MotionData &motionData, float &timeStep, unsigned long &timestamp)
+{
+	TesLight::SensorRecording::Record record;
+	portENTER_CRITICAL(&TesLight::SensorReplay::lock);
+	if (!TesLight::SensorReplay::active || TesLight::SensorReplay::motionCount == 0)
+	{
+		portEXIT_CRITICAL(&TesLight::SensorReplay::lock);
+		return false;
+	}
+	record = TesLight::SensorReplay::motionBuffer[TesLight::SensorReplay::motionHead];
+	TesLight::SensorReplay::motionHead = (TesLight::SensorReplay::motionHead + 1) % SENSOR_REPLAY_MOTION_BUFFER_SIZE;
+	TesLight::SensorReplay::motionCount--;
+	portEXIT_CRITICAL(&TesLight::SensorReplay::lock);
+
+	motionData.accXRaw = record.data[0];
+	motionData.accYRaw = record.data[1];
+	motionData.accZRaw = record.data[2];
+	motionData.gyroXRaw = record.data[3];
+	motionData.gyroYRaw = record.data[4];
+	motionData.gyroZRaw = record.data[5];
+	motionData.temperatureRaw = record.data[6];
+	motionData.accXG = motionData.accXRaw * TesLight::SensorReplay::accScaleInv;
+	motionData.accYG = motionData.accYRaw * TesLight::SensorReplay::accScaleInv;
+	motionData.accZG = motionData.accZRaw * TesLight::SensorReplay::accScaleInv;
+	motionData.gyroXDeg = motionData.gyroXRaw * TesLight::SensorReplay::gyScaleInv;
+	motionData.gyroYDeg = motionData.gyroYRaw * TesLight::SensorReplay::gyScaleInv;
+	motionData.gyroZDeg = motionData.gyroZRaw * TesLight::SensorReplay::gyScaleInv;
+	motionData.temperatureDeg = motionData.temperatureRaw / 340.0f + 36.53f;
+
+	timeStep = TesLight::SensorReplay::hasMotionTimestamp ? (record.timestamp - TesLight::SensorReplay::lastMotionTimestamp) / 1000000.0f : 0.0f;
+	TesLight::SensorReplay::lastMotionTimestamp = record.timestamp;
+	timestamp = TesLight::SensorReplay::startTime + record.timestamp;
+	TesLight::SensorReplay::hasMotionTimestamp = true;
+	return true;
+}
+
+/**
+ * @brief Get the replayed brightness of the BH1750.
+ * @param lux brightness in lux
+ * @return true when a value was returned
+ * @return false when there is no value available or no replay is running
+ */
+bool TesLight::SensorReplay::getLight(float &lux)
+{
+	portENTER_CRITICAL(&TesLight::SensorReplay::lock);
+	const bool valid = TesLight::SensorReplay::active && TesLight::SensorReplay::luxValid;
+	lux = TesLight::SensorReplay::lux;
+	portEXIT_CRITICAL(&TesLight::SensorReplay::lock);
+	return valid;
+}
+
+/**
+ * @brief Get the replayed temperature of a DS18B20.
+ * @param sensorIndex index of the sensor
+ * @param temperature temperature in °C
+ * @return true when a value was returned
+ * @return false when there is no value available or no replay is running
+ */
+bool TesLight::SensorReplay::getTemperature(const uint8_t sensorIndex, float &temperature)
+{
+	if (sensorIndex >= SENSOR_REPLAY_MAX_TEMPERATURES)
+	{
+		return false;
+	}
+
+	portENTER_CRITICAL(&TesLight::SensorReplay::lock);
+	const bool valid = TesLight::SensorReplay::active && TesLight::SensorReplay::temperatureValid[sensorIndex];
+	temperature = TesLight::SensorReplay::temperature[sensorIndex];
+	portEXIT_CRITICAL(&TesLight::SensorReplay::lock);
+	return valid;
+}
+
+/**
+ * @brief Make the value of a record available to the sensors.
+ * @param record record from the recording
+ * @return true when the record was applied
+ * @return false when the motion buffer is full and the record must be applied later
+ */
+bool TesLight::SensorReplay::applyRecord(const TesLight::SensorRecording::Record &record)
+{
+	bool applied = true;
+	portENTER_CRITICAL(&TesLight::SensorReplay::lock);
+	if (record.type == TesLight::SensorRecording::RecordType::MOTION)
+	{
+		if (TesLight::SensorReplay::motionCount < SENSOR_REPLAY_MOTION_BUFFER_SIZE)
+		{
+			TesLight::SensorReplay::motionBuffer[(TesLight::SensorReplay::motionHead + TesLight::SensorReplay::motionCount) % SENSOR_REPLAY_MOTION_BUFFER_SIZE] = record;
+			TesLight::SensorReplay::motionCount++;
+		}
+		else
+		{
+			applied = false;
+		}
+	}
+	else if (record.type == TesLight::SensorRecording::RecordType::LIGHT)
+	{
+		memcpy(&TesLight::SensorReplay::lux, record.data, sizeof(float));
+		TesLight::SensorReplay::luxValid = true;
+	}
+	else if (record.type == TesLight::SensorRecording::RecordType::TEMPERATURE && record.index < SENSOR_REPLAY_MAX_TEMPERATURES)
+	{
+		memcpy(&TesLight::SensorReplay::temperature[record.index], record.data, sizeof(float));
+		TesLight::SensorReplay::temperatureValid[record.index] = true;
+	}
+	portEXIT_CRITICAL(&TesLight::SensorReplay::lock);
+	return applied;
+}
@@ -14,22 +14,27 @@
 TesLight::TemperatureSensor::TemperatureSensor()
 {
 	this->ds18b20 = new TesLight::DS18B20(ONE_WIRE_PIN);
+	this->busState = TesLight::TemperatureSensor::BusState::START_CONVERSION;
+	this->sensorIndex = 0;
+	this->nextStepTime = micros();
+	this->temperature = nullptr;
+	this->temperatureValid = nullptr;
 	if (!this->ds18b20->begin())
 	{
 		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to initialize temperature sensor."));
 		return;
 	}
 
+	this->temperature = new float[this->ds18b20->getNumSensors()];
+	this->temperatureValid = new bool[this->ds18b20->getNumSensors()];
 	for (uint8_t i = 0; i < this->ds18b20->getNumSensors(); i++)
 	{
+		this->temperature[i] = 0.0f;
+		this->temperatureValid[i] = true;
 		if (!this->ds18b20->setResolution(i, (TesLight::DS18B20::DS18B20Res)TEMP_SENSOR_RESOLUTION))
 		{
 			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to set temperature sensor resolution."));
 		}
-		if (!this->ds18b20->startMeasurement(i))
-		{
-			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to start the temperature measurement."));
-		}
 	}
 }
 
@@ -43,6 +48,16 @@ TesLight::TemperatureSensor::~TemperatureSensor()
 		delete this->ds18b20;
 		this->ds18b20 = nullptr;
 	}
+	if (this->temperature)
+	{
+		delete[] this->temperature;
+		this->temperature = nullptr;
+	}
+	if (this->temperatureValid)
+	{
+		delete[] this->temperatureValid;
+		this->temperatureValid = nullptr;
+	}
 }
 
 /**
@@ -55,7 +70,7 @@ uint8_t TesLight::TemperatureSensor::getNumSensors()
 }
 
 /**
- * @brief Get the minimum temperature from all sensors.
+ * @brief Get the minimum temperature from all sensors. The latest values are used, so this never uses the OneWire bus.
  * @param temp variable to hold the temperature value, will be 0.0 if no sensor is present
  * @return true when successful
  * @return false when there was an error
@@ -72,21 +87,11 @@ bool TesLight::TemperatureSensor::getMinTemperature(float &temp)
 	for (uint8_t i = 0; i < this->ds18b20->getNumSensors(); i++)
 	{
 		float currentTemp;
-		if (!this->ds18b20->getTemperature(i, currentTemp))
+		if (!this->readTemperature(i, currentTemp))
 		{
-			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to get temperature from sensor ") + i + F("."));
 			return false;
 		}
 
-		if (this->ds18b20->isMeasurementReady(i))
-		{
-			if (!this->ds18b20->startMeasurement(i))
-			{
-				TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to start temperature measurement on sensor ") + i + F("."));
-				return false;
-			}
-		}
-
 		if (currentTemp < temp)
 		{
 			temp = currentTemp;
@@ -96,7 +101,7 @@ bool TesLight::TemperatureSensor::getMinTemperature(float &temp)
 }
 
 /**
- * @brief Get the maximum temperature of all sensors.
+ * @brief Get the maximum temperature of all sensors. The latest values are used, so this never uses the OneWire bus.
  * @param temp variable to hold the temperature value, will be 0.0 if no sensor is present
  * @return true when successful
  * @return false when there was an error
@@ -113,21 +118,11 @@ bool TesLight::TemperatureSensor::getMaxTemperature(float &temp)
 	for (uint8_t i = 0; i < this->ds18b20->getNumSensors(); i++)
 	{
 		float currentTemp = 0.0f;
-		if (!this->ds18b20->getTemperature(i, currentTemp))
+		if (!this->readTemperature(i, currentTemp))
 		{
-			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to get temperature from sensor ") + i + F("."));
 			return false;
 		}
 
-		if (this->ds18b20->isMeasurementReady(i))
-		{
-			if (!this->ds18b20->startMeasurement(i))
-			{
-				TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to start temperature measurement on sensor ") + i + F("."));
-				return false;
-			}
-		}
-
 		if (currentTemp > temp)
 		{
 			temp = currentTemp;
@@ -137,7 +132,7 @@ bool TesLight::TemperatureSensor::getMaxTemperature(float &temp)
 }
 
 /**
- * @brief Get the average temperature from all sensors.
+ * @brief Get the average temperature from all sensors. The latest values are used, so this never uses the OneWire bus.
  * @param temp variable to hold the temperature value, will be 0.0 if no sensor is present
  * @return true when successful
  * @return false when there was an error
@@ -154,23 +149,141 @@ bool TesLight::TemperatureSensor::getAverageTemperature(float &temp)
 	for (uint8_t i = 0; i < this->ds18b20->getNumSensors(); i++)
 	{
 		float currentTemp = 0.0f;
-		if (!this->ds18b20->getTemperature(i, currentTemp))
+		if (!this->readTemperature(i, currentTemp))
 		{
-			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to get temperature from sensor ") + i + F("."));
 			return false;
 		}
 
-		if (this->ds18b20->isMeasurementReady(i))
+		temp += currentTemp;
+	}
+	temp /= this->ds18b20->getNumSensors();
+	return true;
+}
+
+/**
+ * @brief Get the maximum temperature of all sensors that are mapped to a regulator.
+ * When no sensor is mapped to the regulator, the maximum temperature of all sensors is used.
+ * @param regulatorIndex index of the regulator
+ * @param temp variable to hold the temperature value, will be 0.0 if no sensor is present
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::TemperatureSensor::getRegulatorTemperature(const uint8_t regulatorIndex, float &temp)
+{
+	bool found = false;
+	temp = -1000.0f;
+	for (uint8_t i = 0; i < this->ds18b20->getNumSensors(); i++)
+	{
+		if (!TesLight::TemperatureSensor::isSensorOfRegulator(i, regulatorIndex))
 		{
-			if (!this->ds18b20->startMeasurement(i))
-			{
-				TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to start temperature measurement on sensor ") + i + F("."));
-				return false;
-			}
+			continue;
 		}
 
-		temp += currentTemp;
+		float currentTemp = 0.0f;
+		if (!this->readTemperature(i, currentTemp))
+		{
+			return false;
+		}
+
+		if (currentTemp > temp)
+		{
+			temp = currentTemp;
+		}
+		found = true;
 	}
-	temp / this->ds18b20->getNumSensors();
-	return true;
+
+	return found || this->getMaxTemperature(temp);
+}
+
+/**
+ * @brief Run the next step of the OneWire bus state machine. A single conversion is started on all sensors at once.
+ * When it is finished, the sensors are read one by one, one sensor per call. This keeps the OneWire traffic short,
+ * so it should be called right after the LEDs were shown to not delay the next frame.
+ * @return true when successful or nothing to do
+ * @return false when there was an error on the OneWire bus
+ */
+bool TesLight::TemperatureSensor::run()
+{
+	if (this->ds18b20->getNumSensors() == 0 || (long)(micros() - this->nextStepTime) < 0)
+	{
+		return true;
+	}
+
+	if (this->busState == TesLight::TemperatureSensor::BusState::START_CONVERSION)
+	{
+		if (!this->ds18b20->startMeasurement())
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to start the temperature measurement."));
+			this->nextStepTime = micros() + TEMP_SENSOR_ERROR_DELAY;
+			return false;
+		}
+		this->sensorIndex = 0;
+		this->busState = TesLight::TemperatureSensor::BusState::READ_SENSOR;
+		return true;
+	}
+
+	if (!this->ds18b20->isMeasurementReady(this->sensorIndex))
+	{
+		return true;
+	}
+
+	float temp = 0.0f;
+	if (this->ds18b20->getTemperature(this->sensorIndex, temp))
+	{
+		this->temperature[this->sensorIndex] = temp;
+		this->temperatureValid[this->sensorIndex] = true;
+		TesLight::SensorRecorder::recordTemperature(this->sensorIndex, temp);
+	}
+	else
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to get temperature from sensor ") + this->sensorIndex + F("."));
+		this->temperatureValid[this->sensorIndex] = false;
+	}
+
+	this->sensorIndex++;
+	if (this->sensorIndex >= this->ds18b20->getNumSensors())
+	{
+		this->busState = TesLight::TemperatureSensor::BusState::START_CONVERSION;
+		this->nextStepTime = micros() + TEMP_SENSOR_CONVERSION_INTERVAL;
+	}
+	return this->temperatureValid[this->sensorIndex - 1];
+}
+
+/**
+ * @brief Get the latest temperature of a single sensor. This never uses the OneWire bus.
+ * While a replay is running, the recorded temperature is only used when it is higher than the measured one.
+ * The values are used for the thermal throttling and the fan, so a cool recording must not hide a hot regulator.
+ * @param sensorIndex index of the sensor
+ * @param temp variable to hold the temperature value
+ * @return true when successful
+ * @return false when the last read of the sensor failed
+ */
+bool TesLight::TemperatureSensor::readTemperature(const uint8_t sensorIndex, float &temp)
+{
+	temp = this->temperature[sensorIndex];
+
+	float replayedTemp;
+	if (TesLight::SensorReplay::getTemperature(sensorIndex, replayedTemp) && replayedTemp > temp)
+	{
+		temp = replayedTemp;
+	}
+
+	return this->temperatureValid[sensorIndex];
+}
+
+/**
+ * @brief Check if a sensor is mapped to a regulator. Sensors without a mapping belong to all regulators.
+ * @param sensorIndex index of the sensor
+ * @param regulatorIndex index of the regulator
+ * @return true when the sensor measures the temperature of the regulator
+ * @return false when the sensor belongs to another regulator
+ */
+bool TesLight::TemperatureSensor::isSensorOfRegulator(const uint8_t sensorIndex, const uint8_t regulatorIndex)
+{
+	const uint8_t regulatorMap[] = TEMP_SENSOR_REGULATOR_MAPPING;
+	if (sensorIndex >= sizeof(regulatorMap))
+	{
+		return true;
+	}
+	return regulatorMap[sensorIndex] == regulatorIndex;
 }
@@ -11,15 +11,23 @@
 // Initialize
 FS *TesLight::FseqEndpoint::fileSystem = nullptr;
 TesLight::Configuration *TesLight::FseqEndpoint::configuration = nullptr;
+TesLight::FseqIndex *TesLight::FseqEndpoint::fseqIndex = nullptr;
 File TesLight::FseqEndpoint::uploadFile = File();
+uint8_t *TesLight::FseqEndpoint::uploadBuffer = nullptr;
+size_t TesLight::FseqEndpoint::uploadBufferFill = 0;
+uint32_t TesLight::FseqEndpoint::uploadBytesReceived = 0;
+uint32_t TesLight::FseqEndpoint::uploadExpectedSize = 0;
+bool TesLight::FseqEndpoint::uploadHeaderVerified = false;
+bool TesLight::FseqEndpoint::uploadFailed = false;
 
 /**
  * @brief Add all request handler for this {@link TesLight::RestEndpoint} to the {@link TesLight::WebServerManager}.
  */
-void TesLight::FseqEndpoint::begin(FS *_fileSystem, TesLight::Configuration *_configuration)
+void TesLight::FseqEndpoint::begin(FS *_fileSystem, TesLight::Configuration *_configuration, TesLight::FseqIndex *_fseqIndex)
 {
 	TesLight::FseqEndpoint::fileSystem = _fileSystem;
 	TesLight::FseqEndpoint::configuration = _configuration;
+	TesLight::FseqEndpoint::fseqIndex = _fseqIndex;
 	TesLight::FseqEndpoint::fileSystem->mkdir(FSEQ_DIRECTORY);
 
 	webServerManager->addRequestHandler((getBaseUri() + F("fseq")).c_str(), http_method::HTTP_GET, TesLight::FseqEndpoint::getFseqList);
@@ -33,11 +41,7 @@ void TesLight::FseqEndpoint::begin(FS *_fileSystem, TesLight::Configuration *_co
 void TesLight::FseqEndpoint::getFseqList()
 {
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Received request to get the fseq list."));
-	String fileList;
-	if (!TesLight::FileUtil::getFileList(fileSystem, FSEQ_DIRECTORY, fileList, false))
-	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Failed to list files."));
-	}
+	const String fileList = TesLight::FseqEndpoint::fseqIndex->getFileList();
 
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Sending the response."));
 	webServer->send(200, F("text/plain"), fileList);
@@ -48,12 +52,19 @@ void TesLight::FseqEndpoint::getFseqList()
  */
 void TesLight::FseqEndpoint::postFseq()
 {
+	// The error response was already sent while receiving the upload
+	if (TesLight::FseqEndpoint::uploadFailed)
+	{
+		return;
+	}
+
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Upload of fseq file completed."));
 	webServer->send(200, F("text/plain"), F("File upload successful."));
 }
 
 /**
- * @brief Upload a new fseq files to the controller.
+ * @brief Upload a new fseq files to the controller. The header is verified as soon as it was received, so that invalid
+ * files are rejected before they are written. The data is collected and written in large blocks to the preallocated file.
  */
 void TesLight::FseqEndpoint::fseqUpload()
 {
@@ -62,60 +73,123 @@ void TesLight::FseqEndpoint::fseqUpload()
 	if (upload.status == UPLOAD_FILE_START)
 	{
 		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Received request to upload a new fseq file."));
+		TesLight::FseqEndpoint::uploadFailed = false;
+		TesLight::FseqEndpoint::uploadHeaderVerified = false;
+		TesLight::FseqEndpoint::uploadBufferFill = 0;
+		TesLight::FseqEndpoint::uploadBytesReceived = 0;
+		TesLight::FseqEndpoint::uploadExpectedSize = 0;
+
 		if (fileName.length() == 0)
 		{
-			TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The fileName parameter must not be empty. Can not upload file."));
-			webServer->send(400, F("text/plain"), F("The fileName parameter must not be empty. Can not upload file."));
+			TesLight::FseqEndpoint::failUpload(400, F("The fileName parameter must not be empty. Can not upload file."), false);
 			return;
 		}
 		else if (!TesLight::FseqEndpoint::verifyFileName(fileName))
 		{
-			TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The received file name is invalid."));
-			webServer->send(400, F("text/plain"), F("The received file name is invalid."));
+			TesLight::FseqEndpoint::failUpload(400, F("The received file name is invalid."), false);
 			return;
 		}
 
 		if (TesLight::FileUtil::fileExists(TesLight::FseqEndpoint::fileSystem, (String)FSEQ_DIRECTORY + F("/") + fileName))
 		{
-			TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, (String)F("A file with name \"") + fileName + F("\" already exists."));
-			webServer->send(409, F("text/plain"), (String)F("A file with name \"") + fileName + F("\" already exists."));
+			TesLight::FseqEndpoint::failUpload(409, (String)F("A file with name \"") + fileName + F("\" already exists."), false);
 			return;
 		}
 
 		TesLight::FseqEndpoint::uploadFile = TesLight::FseqEndpoint::fileSystem->open((String)FSEQ_DIRECTORY + F("/") + fileName, FILE_WRITE);
 		if (!uploadFile)
 		{
-			TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Failed to write to file for upload."));
-			webServer->send(500, F("text/plain"), F("Failed to write to file for upload."));
+			TesLight::FseqEndpoint::failUpload(500, F("Failed to write to file for upload."), false);
 			return;
 		}
+
+		if (TesLight::FseqEndpoint::uploadBuffer == nullptr)
+		{
+			TesLight::FseqEndpoint::uploadBuffer = new uint8_t[FSEQ_UPLOAD_BUFFER_SIZE];
+		}
 	}
 	else if (upload.status == UPLOAD_FILE_WRITE)
 	{
-		if (TesLight::FseqEndpoint::uploadFile.write(upload.buf, upload.currentSize) != upload.currentSize)
+		if (TesLight::FseqEndpoint::uploadFailed)
 		{
-			TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Failed to write chunk to file. Not all bytes were written."));
-			webServer->send(500, F("text/plain"), F("Failed to write chunk to file. Not all bytes were written."));
 			return;
 		}
+
+		size_t index = 0;
+		while (index < upload.currentSize)
+		{
+			size_t length = FSEQ_UPLOAD_BUFFER_SIZE - TesLight::FseqEndpoint::uploadBufferFill;
+			if (length > upload.currentSize - index)
+			{
+				length = upload.currentSize - index;
+			}
+			memcpy(TesLight::FseqEndpoint::uploadBuffer + TesLight::FseqEndpoint::uploadBufferFill, upload.buf + index, length);
+			TesLight::FseqEndpoint::uploadBufferFill += length;
+			TesLight::FseqEndpoint::uploadBytesReceived += length;
+			index += length;
+
+			// The header is always completely in the buffer before the first block is written
+			if (!TesLight::FseqEndpoint::uploadHeaderVerified && TesLight::FseqEndpoint::uploadBytesReceived >= 28)
+			{
+				if (!TesLight::FseqEndpoint::verifyFseqHeader(TesLight::FseqEndpoint::uploadBuffer, TesLight::FseqEndpoint::uploadExpectedSize))
+				{
+					TesLight::FseqEndpoint::failUpload(400, F("The uploaded fseq file is invalid and will be deleted."), true);
+					return;
+				}
+				TesLight::FseqEndpoint::uploadHeaderVerified = true;
+
+				// Allocate the whole file at once instead of growing it cluster by cluster
+				if (!TesLight::FseqEndpoint::uploadFile.seek(TesLight::FseqEndpoint::uploadExpectedSize - 1) || TesLight::FseqEndpoint::uploadFile.write((uint8_t)0) != 1 || !TesLight::FseqEndpoint::uploadFile.seek(0))
+				{
+					TesLight::FseqEndpoint::failUpload(507, F("Failed to allocate the file. The SD card might be full."), true);
+					return;
+				}
+			}
+
+			if (TesLight::FseqEndpoint::uploadHeaderVerified && TesLight::FseqEndpoint::uploadBytesReceived > TesLight::FseqEndpoint::uploadExpectedSize)
+			{
+				TesLight::FseqEndpoint::failUpload(400, F("The uploaded fseq file is larger than defined in the header and will be deleted."), true);
+				return;
+			}
+
+			if (TesLight::FseqEndpoint::uploadBufferFill == FSEQ_UPLOAD_BUFFER_SIZE && !TesLight::FseqEndpoint::flushUploadBuffer())
+			{
+				TesLight::FseqEndpoint::failUpload(500, F("Failed to write chunk to file. Not all bytes were written."), true);
+				return;
+			}
+		}
 	}
 	else if (upload.status == UPLOAD_FILE_END)
 	{
-		TesLight::FseqEndpoint::uploadFile.close();
-		if (!TesLight::FseqEndpoint::verifyFseqFile((String)FSEQ_DIRECTORY + F("/") + fileName))
+		if (TesLight::FseqEndpoint::uploadFailed)
 		{
-			TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The uploaded fseq file is invalid and will not be deleted."));
-			TesLight::FseqEndpoint::fileSystem->remove((String)FSEQ_DIRECTORY + F("/") + fileName);
-			webServer->send(400, F("text/plain"), F("The uploaded fseq file is invalid and will be deleted."));
 			return;
 		}
+
+		if (!TesLight::FseqEndpoint::uploadHeaderVerified || TesLight::FseqEndpoint::uploadBytesReceived != TesLight::FseqEndpoint::uploadExpectedSize)
+		{
+			TesLight::FseqEndpoint::failUpload(400, F("The uploaded fseq file is incomplete and will be deleted."), true);
+			return;
+		}
+
+		if (!TesLight::FseqEndpoint::flushUploadBuffer())
+		{
+			TesLight::FseqEndpoint::failUpload(500, F("Failed to write chunk to file. Not all bytes were written."), true);
+			return;
+		}
+
+		TesLight::FseqEndpoint::uploadFile.close();
+		delete[] TesLight::FseqEndpoint::uploadBuffer;
+		TesLight::FseqEndpoint::uploadBuffer = nullptr;
+
+		if (!TesLight::FseqEndpoint::fseqIndex->add(fileName))
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Failed to add the uploaded fseq file to the index."));
+		}
 	}
-	else if (upload.status == UPLOAD_FILE_ABORTED)
+	else if (upload.status == UPLOAD_FILE_ABORTED && !TesLight::FseqEndpoint::uploadFailed)
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Upload was aborted, file will be deleted."));
-		TesLight::FseqEndpoint::uploadFile.close();
-		TesLight::FseqEndpoint::fileSystem->remove((String)FSEQ_DIRECTORY + F("/") + fileName);
-		webServer->send(400, F("text/plain"), F("Upload was aborted by the client. The data was dropped."));
+		TesLight::FseqEndpoint::failUpload(400, F("Upload was aborted by the client. The data was dropped."), true);
 	}
 }
 
@@ -165,6 +239,7 @@ void TesLight::FseqEndpoint::deleteFseq()
 		webServer->send(500, F("text/plain"), F("Failed to delete file."));
 		return;
 	}
+	TesLight::FseqEndpoint::fseqIndex->remove(fileName);
 
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Sending the response."));
 	webServer->send(200, F("text/plain"), F("File deleted."));
@@ -199,15 +274,92 @@ bool TesLight::FseqEndpoint::verifyFileName(const String fileName)
 }
 
 /**
- * @brief Verify a fseq file by using the {@link TesLight::FseqLoader}.
- * @param fileName full path and name of the file to check
+ * @brief Verify the header of a fseq file and calculate the expected file size.
+ * @param header buffer containing the first 28 bytes of the file
+ * @param expectedSize reference variable holding the expected size of the file
  * @return true when valid
  * @return false when invalid
  */
-bool TesLight::FseqEndpoint::verifyFseqFile(const String fileName)
+bool TesLight::FseqEndpoint::verifyFseqHeader(const uint8_t *header, uint32_t &expectedSize)
 {
-	TesLight::FseqLoader fseqLoader(TesLight::FseqEndpoint::fileSystem);
-	const bool valid = fseqLoader.loadFromFile(fileName);
-	fseqLoader.close();
-	return valid;
-}
\ No newline at end of file
+	TesLight::FseqLoader::FseqHeader fseqHeader;
+	memcpy(&fseqHeader.identifier[0], &header[0], 4);
+	memcpy(&fseqHeader.channelDataOffset, &header[4], 2);
+	fseqHeader.minorVersion = header[6];
+	fseqHeader.majorVersion = header[7];
+	memcpy(&fseqHeader.headerLength, &header[8], 2);
+	memcpy(&fseqHeader.channelCount, &header[10], 4);
+	memcpy(&fseqHeader.frameCount, &header[14], 4);
+
+	if (memcmp(fseqHeader.identifier, "PSEQ", 4) != 0)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The uploaded fseq file is invalid because the identifier doesn't match. It must be PSEQ."));
+		return false;
+	}
+	else if (fseqHeader.minorVersion != 0 || fseqHeader.majorVersion != 1)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The uploaded fseq file is invalid because the version does not match. It must be 1.0."));
+		return false;
+	}
+	else if (fseqHeader.headerLength != 28 || fseqHeader.channelDataOffset < 28)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The uploaded fseq file is invalid because the header length is not valid."));
+		return false;
+	}
+	else if (fseqHeader.channelCount == 0 || fseqHeader.frameCount == 0 || fseqHeader.channelCount % 3 != 0)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The uploaded fseq file is invalid because the channel count is not a multiple of 3. This is a requirement by TesLight."));
+		return false;
+	}
+
+	const uint64_t size = (uint64_t)fseqHeader.channelDataOffset + (uint64_t)fseqHeader.channelCount * fseqHeader.frameCount;
+	if (size > UINT32_MAX)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The uploaded fseq file is invalid because it is too large."));
+		return false;
+	}
+
+	expectedSize = size;
+	return true;
+}
+
+/**
+ * @brief Write the collected upload data to the file.
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::FseqEndpoint::flushUploadBuffer()
+{
+	const size_t bytesWritten = TesLight::FseqEndpoint::uploadFile.write(TesLight::FseqEndpoint::uploadBuffer, TesLight::FseqEndpoint::uploadBufferFill);
+	const bool success = bytesWritten == TesLight::FseqEndpoint::uploadBufferFill;
+	TesLight::FseqEndpoint::uploadBufferFill = 0;
+	return success;
+}
+
+/**
+ * @brief Cancel the current upload, send the error response and drop the remaining data.
+ * @param code HTTP status code
+ * @param message error message
+ * @param removeFile true to close and delete the uploaded file
+ */
+void TesLight::FseqEndpoint::failUpload(const int code, const String message, const bool removeFile)
+{
+	TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, message);
+	if (removeFile)
+	{
+		TesLight::FseqEndpoint::uploadFile.close();
+		TesLight::FseqEndpoint::fileSystem->remove((String)FSEQ_DIRECTORY + F("/") + webServer->arg(F("fileName")));
+	}
+
+	if (TesLight::FseqEndpoint::uploadBuffer != nullptr)
+	{
+		delete[] TesLight::FseqEndpoint::uploadBuffer;
+		TesLight::FseqEndpoint::uploadBuffer = nullptr;
+	}
+
+	if (!TesLight::FseqEndpoint::uploadFailed)
+	{
+		webServer->send(code, F("text/plain"), message);
+	}
+	TesLight::FseqEndpoint::uploadFailed = true;
+}
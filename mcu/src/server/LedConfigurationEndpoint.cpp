@@ -21,6 +21,7 @@ void TesLight::LedConfigurationEndpoint::begin(TesLight::Configuration *_configu
 	TesLight::LedConfigurationEndpoint::configChangedCallback = _configChangedCallback;
 	webServerManager->addRequestHandler((getBaseUri() + F("config/led")).c_str(), http_method::HTTP_GET, TesLight::LedConfigurationEndpoint::getLedConfig);
 	webServerManager->addRequestHandler((getBaseUri() + F("config/led")).c_str(), http_method::HTTP_POST, TesLight::LedConfigurationEndpoint::postLedConfig);
+	webServerManager->addRequestHandler((getBaseUri() + F("config/led")).c_str(), http_method::HTTP_PATCH, TesLight::LedConfigurationEndpoint::patchLedConfig);
 }
 
 /**
@@ -101,22 +102,7 @@ void TesLight::LedConfigurationEndpoint::postLedConfig()
 	TesLight::Configuration::LedConfig config[LED_NUM_ZONES];
 	for (uint8_t i = 0; i < LED_NUM_ZONES; i++)
 	{
-		binary.read(config[i].ledPin);
-		binary.read(config[i].ledCount);
-		binary.read(config[i].type);
-		binary.read(config[i].speed);
-		binary.read(config[i].offset);
-		binary.read(config[i].brightness);
-		binary.read(config[i].reverse);
-		binary.read(config[i].fadeSpeed);
-		for (uint8_t j = 0; j < ANIMATOR_NUM_CUSTOM_FIELDS; j++)
-		{
-			binary.read(config[i].customField[j]);
-		}
-		binary.read(config[i].ledVoltage);
-		binary.read(config[i].ledChannelCurrent[0]);
-		binary.read(config[i].ledChannelCurrent[1]);
-		binary.read(config[i].ledChannelCurrent[2]);
+		TesLight::LedConfigurationEndpoint::readLedConfig(binary, config[i]);
 
 		if (!validateLedPin(config[i].ledPin) || !validateLedCount(config[i].ledCount) || !validateAnimatorType(config[i].type))
 		{
@@ -131,29 +117,150 @@ void TesLight::LedConfigurationEndpoint::postLedConfig()
 		TesLight::LedConfigurationEndpoint::configuration->setLedConfig(config[i], i);
 	}
 
-	if (TesLight::LedConfigurationEndpoint::configuration->save())
+	if (!TesLight::LedConfigurationEndpoint::saveAndApply())
 	{
-		if (TesLight::LedConfigurationEndpoint::configChangedCallback)
+		return;
+	}
+
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("LED configuration saved. Sending the response."));
+	webServer->send(200);
+}
+
+/**
+ * @brief Receive the configuration of a single LED zone sent by the client.
+ * Unchanged zones and the running animations are not touched.
+ */
+void TesLight::LedConfigurationEndpoint::patchLedConfig()
+{
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Received request to update the configuration of a single LED zone."));
+
+	if (!webServer->hasArg(F("index")) || webServer->arg(F("index")).length() == 0)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("There must be a x-www-form-urlencoded body parameter \"index\" with the index of the LED zone."));
+		webServer->send(400, F("text/plain"), F("There must be a body parameter \"index\" with the index of the LED zone."));
+		return;
+	}
+
+	if (!webServer->hasArg(F("data")) || webServer->arg(F("data")).length() == 0)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("There must be a x-www-form-urlencoded body parameter \"data\" with the base64 encoded LED data."));
+		webServer->send(400, F("text/plain"), F("There must be a body parameter \"data\" with the base64 encoded LED data."));
+		return;
+	}
+
+	const String indexArg = webServer->arg(F("index"));
+	for (size_t i = 0; i < indexArg.length(); i++)
+	{
+		if (!isDigit(indexArg.charAt(i)))
 		{
-			if (!TesLight::LedConfigurationEndpoint::configChangedCallback())
-			{
-				TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The callback function returned with an error."));
-				webServer->send(500, F("text/plain"), F("Failed to call the callback function."));
-				return;
-			}
+			TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The index of the LED zone is not a number."));
+			webServer->send(400, F("text/plain"), F("The index of the LED zone must be a number."));
+			return;
 		}
 	}
-	else
+
+	const long index = indexArg.toInt();
+	if (index < 0 || index >= LED_NUM_ZONES)
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to save LED configuration."));
-		webServer->send(500, F("text/plain"), F("Failed to save LED configuration."));
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The index of the LED zone is invalid."));
+		webServer->send(400, F("text/plain"), (String)F("The index of the LED zone must be between 0 and ") + String(LED_NUM_ZONES - 1) + F("."));
 		return;
 	}
 
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("LED configuration saved. Sending the response."));
+	const String encoded = webServer->arg(F("data"));
+	size_t length;
+	uint8_t *decoded = TesLight::Base64Util::decode(encoded, length);
+	if (decoded == nullptr)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to decode request."));
+		webServer->send(500, F("application/octet-stream"), F("Failed to decode request."));
+		return;
+	}
+
+	if (length != 29)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Length of decoded data is invalid."));
+		delete[] decoded;
+		webServer->send(400, F("text/plain"), F("The length of the decoded data must be exactly 29 bytes."));
+		return;
+	}
+
+	TesLight::InMemoryBinaryFile binary(length);
+	binary.loadFrom(decoded, length);
+	delete[] decoded;
+
+	TesLight::Configuration::LedConfig config;
+	TesLight::LedConfigurationEndpoint::readLedConfig(binary, config);
+	if (!validateLedPin(config.ledPin) || !validateLedCount(config.ledCount) || !validateAnimatorType(config.type))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, (String)F("The LED configuration at index ") + String(index) + F(" is invalid."));
+		webServer->send(400, F("text/plain"), (String)F("The LED configuration at index ") + String(index) + F(" is invalid."));
+		return;
+	}
+
+	TesLight::LedConfigurationEndpoint::configuration->setLedConfig(config, index);
+	if (!TesLight::LedConfigurationEndpoint::saveAndApply())
+	{
+		return;
+	}
+
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("LED zone configuration saved. Sending the response."));
 	webServer->send(200);
 }
 
+/**
+ * @brief Read the configuration of a single LED zone from the binary data.
+ * @param binary binary data received from the client
+ * @param ledConfig LED configuration which is filled with the data
+ */
+void TesLight::LedConfigurationEndpoint::readLedConfig(TesLight::InMemoryBinaryFile &binary, TesLight::Configuration::LedConfig &ledConfig)
+{
+	binary.read(ledConfig.ledPin);
+	binary.read(ledConfig.ledCount);
+	binary.read(ledConfig.type);
+	binary.read(ledConfig.speed);
+	binary.read(ledConfig.offset);
+	binary.read(ledConfig.brightness);
+	binary.read(ledConfig.reverse);
+	binary.read(ledConfig.fadeSpeed);
+	for (uint8_t j = 0; j < ANIMATOR_NUM_CUSTOM_FIELDS; j++)
+	{
+		binary.read(ledConfig.customField[j]);
+	}
+	binary.read(ledConfig.ledVoltage);
+	binary.read(ledConfig.ledChannelCurrent[0]);
+	binary.read(ledConfig.ledChannelCurrent[1]);
+	binary.read(ledConfig.ledChannelCurrent[2]);
+}
+
+/**
+ * @brief Save the configuration and call the callback function to apply it.
+ * An error response is sent to the client in case of a failure.
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::LedConfigurationEndpoint::saveAndApply()
+{
+	if (!TesLight::LedConfigurationEndpoint::configuration->save())
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to save LED configuration."));
+		webServer->send(500, F("text/plain"), F("Failed to save LED configuration."));
+		return false;
+	}
+
+	if (TesLight::LedConfigurationEndpoint::configChangedCallback)
+	{
+		if (!TesLight::LedConfigurationEndpoint::configChangedCallback())
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The callback function returned with an error."));
+			webServer->send(500, F("text/plain"), F("Failed to call the callback function."));
+			return false;
+		}
+	}
+
+	return true;
+}
+
 /**
  * @brief Verify if the pin is a valid led output pin.
  * @param ledPin pin number
@@ -193,5 +300,5 @@ bool TesLight::LedConfigurationEndpoint::validateLedCount(const int ledCount)
  */
 bool TesLight::LedConfigurationEndpoint::validateAnimatorType(const int animatorType)
 {
-	return (animatorType >= 0 && animatorType <= 17) || animatorType == 255;
+	return (animatorType >= 0 && animatorType <= 17) || animatorType == 254 || animatorType == 255;
 }
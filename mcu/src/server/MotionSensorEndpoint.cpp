@@ -23,6 +23,7 @@ void TesLight::MotionSensorEndpoint::begin(TesLight::Configuration *_configurati
 	webServerManager->addRequestHandler((getBaseUri() + F("config/motion")).c_str(), http_method::HTTP_GET, TesLight::MotionSensorEndpoint::getCalibrationData);
 	webServerManager->addRequestHandler((getBaseUri() + F("config/motion")).c_str(), http_method::HTTP_POST, TesLight::MotionSensorEndpoint::postCalibrationData);
 	webServerManager->addRequestHandler((getBaseUri() + F("config/motion")).c_str(), http_method::HTTP_PATCH, TesLight::MotionSensorEndpoint::runCalibration);
+	webServerManager->addRequestHandler((getBaseUri() + F("config/motion/calibration")).c_str(), http_method::HTTP_GET, TesLight::MotionSensorEndpoint::getCalibrationState);
 }
 
 /**
@@ -108,6 +109,7 @@ void TesLight::MotionSensorEndpoint::postCalibrationData()
 	binary.read(motionSensorCalibration.gyroYDeg);
 	binary.read(motionSensorCalibration.gyroZDeg);
 	TesLight::MotionSensorEndpoint::configuration->setMotionSensorCalibration(motionSensorCalibration);
+	TesLight::MotionSensorEndpoint::motionSensor->setCalibration(motionSensorCalibration);
 
 	if (!TesLight::MotionSensorEndpoint::configuration->save())
 	{
@@ -121,39 +123,43 @@ void TesLight::MotionSensorEndpoint::postCalibrationData()
 }
 
 /**
- * @brief Automatically calibrate the motion sensor.
+ * @brief Start the automatic calibration of the motion sensor. The calibration is run by the I²C bus task,
+ * the result can be requested from the calibration state.
  */
 void TesLight::MotionSensorEndpoint::runCalibration()
 {
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Received request to automatically calibrate the motion sensor."));
 
-	uint8_t result = TesLight::MotionSensorEndpoint::motionSensor->calibrate(true);
-	if (result == 1)
+	if (!TesLight::MotionSensorEndpoint::motionSensor->startCalibration(true))
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to read motion sensor."));
-		webServer->send(500, F("text/plain"), F("Failed to read motion sensor."));
-		return;
-	}
-	else if (result == 2)
-	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Can not calibrate motion sensor becaues the temperature is too low."));
-		webServer->send(500, F("text/plain"), F("Can not calibrate motion sensor becaues the temperature is too low."));
-		return;
-	}
-	else if (result == 3)
-	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Can not calibrate motion sensor becaues the temperature is too high."));
-		webServer->send(500, F("text/plain"), F("Can not calibrate motion sensor becaues the temperature is too high."));
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The motion sensor calibration is already running."));
+		webServer->send(409, F("text/plain"), F("The motion sensor calibration is already running."));
 		return;
 	}
 
-	if (!TesLight::MotionSensorEndpoint::configuration->save())
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Calibration started. Sending the response."));
+	webServer->send(202);
+}
+
+/**
+ * @brief Return the state of the motion sensor calibration as binary data.
+ * 0 is success, 1 a communication error, 2 too cold, 3 too warm, 4 still running and 5 not started.
+ */
+void TesLight::MotionSensorEndpoint::getCalibrationState()
+{
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Received request to get the motion sensor calibration state."));
+
+	TesLight::InMemoryBinaryFile binary(1);
+	binary.write(TesLight::MotionSensorEndpoint::motionSensor->getCalibrationState());
+
+	const String encoded = TesLight::Base64Util::encode(binary.getData(), binary.getBytesWritten());
+	if (encoded == F("BASE64_ERROR"))
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to save motion sensor calibration data."));
-		webServer->send(500, F("text/plain"), F("Failed to save motion sensor calibration data."));
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to encode response."));
+		webServer->send(500, F("application/octet-stream"), F("Failed to encode response."));
 		return;
 	}
 
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Calibration data saved. Sending the response."));
-	webServer->send(200);
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Sending the response."));
+	webServer->send(200, F("application/octet-stream"), encoded);
 }
\ No newline at end of file
@@ -8,14 +8,14 @@
  */
 #include "server/ResetEndpoint.h"
 
-FS *TesLight::ResetEndpoint::fileSystem = nullptr;
+TesLight::Configuration *TesLight::ResetEndpoint::configuration = nullptr;
 
 /**
  * @brief Add all request handler for this {@link TesLight::RestEndpoint} to the {@link TesLight::WebServerManager}.
  */
-void TesLight::ResetEndpoint::begin(FS *_fileSystem)
+void TesLight::ResetEndpoint::begin(TesLight::Configuration *_configuration)
 {
-	ResetEndpoint::fileSystem = _fileSystem;
+	ResetEndpoint::configuration = _configuration;
 	webServerManager->addRequestHandler((getBaseUri() + F("reset/soft")).c_str(), http_method::HTTP_POST, TesLight::ResetEndpoint::handleSoftReset);
 	webServerManager->addRequestHandler((getBaseUri() + F("reset/hard")).c_str(), http_method::HTTP_POST, TesLight::ResetEndpoint::handleHardReset);
 }
@@ -29,7 +29,7 @@ void TesLight::ResetEndpoint::handleSoftReset()
 	webServer->send(200, F("application/text"), F("Controller will reboot."));
 
 	delay(250);
-	TesLight::Updater::reboot(F("Soft Reset"));
+	TesLight::Updater::reboot(F("Soft Reset"), TesLight::ResetEndpoint::configuration);
 }
 
 /**
@@ -40,9 +40,9 @@ void TesLight::ResetEndpoint::handleHardReset()
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Received request to execute a hard reset."));
 	webServer->send(200, F("application/text"), F("The configuration will be reset to defaults. The controller will then reboot. Make sure to reconnect using the default SSID and password."));
 
-	if (!TesLight::ResetEndpoint::fileSystem->remove(CONFIGURATION_FILE_NAME))
+	if (!TesLight::ResetEndpoint::configuration->clear())
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Failed to remove configuration. This might be normal if it was not saved before."));
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Failed to remove configuration."));
 	}
 	else
 	{
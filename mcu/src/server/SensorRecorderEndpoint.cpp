@@ -0,0 +1,149 @@
+/**
+ * @file SensorRecorderEndpoint.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of a REST endpoint to record and replay the sensor data.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "server/SensorRecorderEndpoint.h"
+
+/**
+ * @brief Add all request handler for this {@link TesLight::RestEndpoint} to the {@link TesLight::WebServerManager}.
+ */
+void TesLight::SensorRecorderEndpoint::begin()
+{
+	webServerManager->addRequestHandler((getBaseUri() + F("recorder")).c_str(), http_method::HTTP_GET, TesLight::SensorRecorderEndpoint::getStatus);
+	webServerManager->addRequestHandler((getBaseUri() + F("recorder")).c_str(), http_method::HTTP_POST, TesLight::SensorRecorderEndpoint::startRecording);
+	webServerManager->addRequestHandler((getBaseUri() + F("recorder")).c_str(), http_method::HTTP_DELETE, TesLight::SensorRecorderEndpoint::stopRecording);
+	webServerManager->addRequestHandler((getBaseUri() + F("recorder/replay")).c_str(), http_method::HTTP_POST, TesLight::SensorRecorderEndpoint::startReplay);
+	webServerManager->addRequestHandler((getBaseUri() + F("recorder/replay")).c_str(), http_method::HTTP_DELETE, TesLight::SensorRecorderEndpoint::stopReplay);
+}
+
+/**
+ * @brief Return the status of the recorder and replay as binary data.
+ */
+void TesLight::SensorRecorderEndpoint::getStatus()
+{
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Received request to get the sensor recorder status."));
+
+	TesLight::InMemoryBinaryFile binary(10);
+	binary.write((uint8_t)TesLight::SensorRecorder::isRecording());
+	binary.write((uint8_t)TesLight::SensorReplay::isActive());
+	binary.write(TesLight::SensorRecorder::getRecordCount());
+	binary.write(TesLight::SensorRecorder::getDroppedCount());
+
+	const String encoded = TesLight::Base64Util::encode(binary.getData(), binary.getBytesWritten());
+	if (encoded == F("BASE64_ERROR"))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to encode response."));
+		webServer->send(500, F("application/octet-stream"), F("Failed to encode response."));
+		return;
+	}
+
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Sending the response."));
+	webServer->send(200, F("application/octet-stream"), encoded);
+}
+
+/**
+ * @brief Start a new sensor recording.
+ */
+void TesLight::SensorRecorderEndpoint::startRecording()
+{
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Received request to start a sensor recording."));
+
+	const String fileName = webServer->arg(F("fileName"));
+	if (!TesLight::SensorRecorderEndpoint::verifyFileName(fileName))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The fileName parameter is missing or invalid."));
+		webServer->send(400, F("text/plain"), F("The fileName parameter is missing or invalid."));
+		return;
+	}
+
+	if (!TesLight::SensorRecorder::start(fileName))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to start the sensor recording."));
+		webServer->send(500, F("text/plain"), F("Failed to start the sensor recording."));
+		return;
+	}
+
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Sensor recording started. Sending the response."));
+	webServer->send(200);
+}
+
+/**
+ * @brief Stop the current sensor recording.
+ */
+void TesLight::SensorRecorderEndpoint::stopRecording()
+{
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Received request to stop the sensor recording."));
+	TesLight::SensorRecorder::stop();
+	webServer->send(200);
+}
+
+/**
+ * @brief Start to replay a sensor recording.
+ */
+void TesLight::SensorRecorderEndpoint::startReplay()
+{
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Received request to replay a sensor recording."));
+
+	const String fileName = webServer->arg(F("fileName"));
+	if (!TesLight::SensorRecorderEndpoint::verifyFileName(fileName))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The fileName parameter is missing or invalid."));
+		webServer->send(400, F("text/plain"), F("The fileName parameter is missing or invalid."));
+		return;
+	}
+
+	if (TesLight::SensorRecorder::isRecording())
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Can not replay a sensor recording while recording."));
+		webServer->send(409, F("text/plain"), F("Can not replay a sensor recording while recording."));
+		return;
+	}
+
+	if (!TesLight::SensorReplay::start(fileName))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to start the sensor replay."));
+		webServer->send(500, F("text/plain"), F("Failed to start the sensor replay."));
+		return;
+	}
+
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Sensor replay started. Sending the response."));
+	webServer->send(200);
+}
+
+/**
+ * @brief Stop the current sensor replay.
+ */
+void TesLight::SensorRecorderEndpoint::stopReplay()
+{
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Received request to stop the sensor replay."));
+	TesLight::SensorReplay::stop();
+	webServer->send(200);
+}
+
+/**
+ * @brief Verify the file name and check for invalid characters.
+ * @param fileName received name of the file
+ * @return true when valid
+ * @return false when invalid
+ */
+bool TesLight::SensorRecorderEndpoint::verifyFileName(const String fileName)
+{
+	if (fileName.length() < 1 || fileName.length() > 32)
+	{
+		return false;
+	}
+
+	for (uint16_t i = 0; i < fileName.length(); i++)
+	{
+		if ((fileName[i] < 'A' || fileName[i] > 'Z') && (fileName[i] < 'a' || fileName[i] > 'z') && (fileName[i] < '0' || fileName[i] > '9') && fileName[i] != '.' && fileName[i] != '_' && fileName[i] != '-')
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file TelemetryEndpoint.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of a REST endpoint to read the telemetry history.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "server/TelemetryEndpoint.h"
+
+/**
+ * @brief Add all request handler for this {@link TesLight::RestEndpoint} to the {@link TesLight::WebServerManager}.
+ */
+void TesLight::TelemetryEndpoint::begin()
+{
+	webServerManager->addRequestHandler((getBaseUri() + F("telemetry")).c_str(), http_method::HTTP_GET, TesLight::TelemetryEndpoint::getTelemetry);
+}
+
+/**
+ * @brief Return the telemetry history of the requested resolution as binary data.
+ * The response starts with the number of regulators and the number of samples, followed by the samples from old to new.
+ */
+void TesLight::TelemetryEndpoint::getTelemetry()
+{
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Received request to get the telemetry."));
+
+	const String resolutionName = webServer->arg(F("resolution"));
+	TesLight::Telemetry::Resolution resolution;
+	if (resolutionName == F("second"))
+	{
+		resolution = TesLight::Telemetry::Resolution::SECOND;
+	}
+	else if (resolutionName == F("minute"))
+	{
+		resolution = TesLight::Telemetry::Resolution::MINUTE;
+	}
+	else if (resolutionName == F("hour"))
+	{
+		resolution = TesLight::Telemetry::Resolution::HOUR;
+	}
+	else
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The resolution parameter is missing or invalid."));
+		webServer->send(400, F("text/plain"), F("The resolution parameter is missing or invalid. Use second, minute or hour."));
+		return;
+	}
+
+	const uint16_t sampleCount = TesLight::Telemetry::getSampleCount(resolution);
+	TesLight::InMemoryBinaryFile binary(3 + sampleCount * sizeof(TesLight::Telemetry::Sample));
+	binary.write((uint8_t)REGULATOR_COUNT);
+	binary.write(sampleCount);
+	for (uint16_t i = 0; i < sampleCount; i++)
+	{
+		TesLight::Telemetry::Sample sample;
+		TesLight::Telemetry::getSample(resolution, i, sample);
+		binary.write(sample);
+	}
+
+	const String encoded = TesLight::Base64Util::encode(binary.getData(), binary.getBytesWritten());
+	if (encoded == F("BASE64_ERROR"))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to encode response."));
+		webServer->send(500, F("application/octet-stream"), F("Failed to encode response."));
+		return;
+	}
+
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Sending the response."));
+	webServer->send(200, F("application/octet-stream"), encoded);
+}
@@ -10,17 +10,19 @@
 
 // Initialize
 FS *TesLight::UpdateEndpoint::fileSystem = nullptr;
+TesLight::Configuration *TesLight::UpdateEndpoint::configuration = nullptr;
 File TesLight::UpdateEndpoint::uploadFile = File();
 
 /**
  * @brief Add all request handler for this {@link TesLight::RestEndpoint} to the {@link TesLight::WebServerManager}.
  */
-void TesLight::UpdateEndpoint::begin(FS *_fileSystem)
+void TesLight::UpdateEndpoint::begin(FS *_fileSystem, TesLight::Configuration *_configuration)
 {
 	TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, F("Initialize update endpoint."));
 
 	TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, F("Create storage directory for package file."));
 	TesLight::UpdateEndpoint::fileSystem = _fileSystem;
+	TesLight::UpdateEndpoint::configuration = _configuration;
 	TesLight::UpdateEndpoint::fileSystem->mkdir(UPDATE_DIRECTORY);
 
 	TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, F("Register update endpoints."));
@@ -42,7 +44,7 @@ void TesLight::UpdateEndpoint::postPackage()
 	// Reboot the controller.
 	// Update will be installed after the reboot.
 	delay(1000);
-	TesLight::Updater::reboot(F("Update"));
+	TesLight::Updater::reboot(F("Update"), TesLight::UpdateEndpoint::configuration);
 }
 
 /**
@@ -0,0 +1,521 @@
+/**
+ * @file UploadSessionEndpoint.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of a REST endpoint for resumable uploads of fseq files and update packages.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "server/UploadSessionEndpoint.h"
+
+// Initialize
+FS *TesLight::UploadSessionEndpoint::fileSystem = nullptr;
+TesLight::Configuration *TesLight::UploadSessionEndpoint::configuration = nullptr;
+TesLight::FseqIndex *TesLight::UploadSessionEndpoint::fseqIndex = nullptr;
+uint8_t *TesLight::UploadSessionEndpoint::chunkBuffer = nullptr;
+size_t TesLight::UploadSessionEndpoint::chunkSize = 0;
+bool TesLight::UploadSessionEndpoint::chunkFailed = false;
+
+/**
+ * @brief Add all request handler for this {@link TesLight::RestEndpoint} to the {@link TesLight::WebServerManager}.
+ */
+void TesLight::UploadSessionEndpoint::begin(FS *_fileSystem, TesLight::Configuration *_configuration, TesLight::FseqIndex *_fseqIndex)
+{
+	TesLight::UploadSessionEndpoint::fileSystem = _fileSystem;
+	TesLight::UploadSessionEndpoint::configuration = _configuration;
+	TesLight::UploadSessionEndpoint::fseqIndex = _fseqIndex;
+	TesLight::UploadSessionEndpoint::fileSystem->mkdir(UPLOAD_SESSION_DIRECTORY);
+
+	webServerManager->addRequestHandler((getBaseUri() + F("upload/session")).c_str(), http_method::HTTP_POST, TesLight::UploadSessionEndpoint::createSession);
+	webServerManager->addRequestHandler((getBaseUri() + F("upload/session")).c_str(), http_method::HTTP_GET, TesLight::UploadSessionEndpoint::getSession);
+	webServerManager->addUploadRequestHandler((getBaseUri() + F("upload/session")).c_str(), http_method::HTTP_PUT, TesLight::UploadSessionEndpoint::putChunk, TesLight::UploadSessionEndpoint::chunkUpload);
+	webServerManager->addRequestHandler((getBaseUri() + F("upload/session")).c_str(), http_method::HTTP_DELETE, TesLight::UploadSessionEndpoint::deleteSession);
+	webServerManager->addRequestHandler((getBaseUri() + F("upload/commit")).c_str(), http_method::HTTP_POST, TesLight::UploadSessionEndpoint::commitSession);
+}
+
+/**
+ * @brief Create a new upload session or resume an existing one. The session id is derived from the target, file name, size
+ * and the CRC32 of the whole file, so that a client can resume an interrupted upload by creating the same session again.
+ * Different files never resume into the same session.
+ * The response contains the session id and the offset from which the upload must continue, separated by a semicolon.
+ */
+void TesLight::UploadSessionEndpoint::createSession()
+{
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Received request to create an upload session."));
+	const String target = webServer->arg(F("target"));
+	TesLight::UploadSessionEndpoint::UploadSession session;
+	session.size = strtoul(webServer->arg(F("size")).c_str(), nullptr, 10);
+	session.crc = strtoul(webServer->arg(F("crc")).c_str(), nullptr, 10);
+
+	if (target == F("fseq"))
+	{
+		session.target = TesLight::UploadSessionEndpoint::UploadTarget::FSEQ;
+		session.fileName = webServer->arg(F("fileName"));
+		if (!TesLight::FseqEndpoint::verifyFileName(session.fileName))
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The received file name is invalid."));
+			webServer->send(400, F("text/plain"), F("The received file name is invalid."));
+			return;
+		}
+		else if (TesLight::FileUtil::fileExists(TesLight::UploadSessionEndpoint::fileSystem, (String)FSEQ_DIRECTORY + F("/") + session.fileName))
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, (String)F("A file with name \"") + session.fileName + F("\" already exists."));
+			webServer->send(409, F("text/plain"), (String)F("A file with name \"") + session.fileName + F("\" already exists."));
+			return;
+		}
+	}
+	else if (target == F("update"))
+	{
+		session.target = TesLight::UploadSessionEndpoint::UploadTarget::UPDATE;
+		session.fileName = UPDATE_FILE_NAME;
+	}
+	else
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The target parameter must be \"fseq\" or \"update\"."));
+		webServer->send(400, F("text/plain"), F("The target parameter must be \"fseq\" or \"update\"."));
+		return;
+	}
+
+	if (session.size == 0)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The size parameter must be larger than 0."));
+		webServer->send(400, F("text/plain"), F("The size parameter must be larger than 0."));
+		return;
+	}
+	else if (!webServer->hasArg(F("crc")) || webServer->arg(F("crc")).length() == 0)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("There must be a parameter \"crc\" with the CRC32 of the whole file."));
+		webServer->send(400, F("text/plain"), F("There must be a parameter \"crc\" with the CRC32 of the whole file."));
+		return;
+	}
+
+	const String id = TesLight::UploadSessionEndpoint::getSessionId(session);
+	if (!TesLight::FileUtil::fileExists(TesLight::UploadSessionEndpoint::fileSystem, TesLight::UploadSessionEndpoint::getSessionFileName(id)))
+	{
+		File partFile = TesLight::UploadSessionEndpoint::fileSystem->open(TesLight::UploadSessionEndpoint::getPartFileName(id), FILE_WRITE);
+		if (!partFile || !TesLight::UploadSessionEndpoint::writeSession(id, session))
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to create the upload session."));
+			webServer->send(500, F("text/plain"), F("Failed to create the upload session."));
+			return;
+		}
+		partFile.close();
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("Upload session ") + id + F(" created."));
+	}
+	else
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("Upload session ") + id + F(" resumed."));
+	}
+
+	webServer->send(200, F("text/plain"), id + F(";") + String(TesLight::UploadSessionEndpoint::getOffset(id)));
+}
+
+/**
+ * @brief Return the status of an upload session. The response contains the current offset and the total size, separated by a semicolon.
+ */
+void TesLight::UploadSessionEndpoint::getSession()
+{
+	const String id = webServer->arg(F("id"));
+	TesLight::UploadSessionEndpoint::UploadSession session;
+	if (!TesLight::UploadSessionEndpoint::readSession(id, session))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, (String)F("Upload session ") + id + F(" was not found."));
+		webServer->send(404, F("text/plain"), (String)F("Upload session ") + id + F(" was not found."));
+		return;
+	}
+
+	webServer->send(200, F("text/plain"), String(TesLight::UploadSessionEndpoint::getOffset(id)) + F(";") + String(session.size));
+}
+
+/**
+ * @brief Is called after a chunk was received. The chunk is only appended when the offset matches the
+ * current size of the uploaded data and the CRC32 of the chunk is correct. The response contains the new offset.
+ * When the offset does not match, the response is a 409 with the current offset, from which the client must continue.
+ */
+void TesLight::UploadSessionEndpoint::putChunk()
+{
+	const String id = webServer->arg(F("id"));
+	const uint32_t offset = strtoul(webServer->arg(F("offset")).c_str(), nullptr, 10);
+	const uint32_t crc = strtoul(webServer->arg(F("crc")).c_str(), nullptr, 10);
+
+	if (TesLight::UploadSessionEndpoint::chunkFailed)
+	{
+		TesLight::UploadSessionEndpoint::freeChunkBuffer();
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, (String)F("The chunk was not received completely or is larger than ") + String(UPLOAD_SESSION_MAX_CHUNK_SIZE) + F(" bytes."));
+		webServer->send(400, F("text/plain"), (String)F("The chunk was not received completely or is larger than ") + String(UPLOAD_SESSION_MAX_CHUNK_SIZE) + F(" bytes."));
+		return;
+	}
+
+	TesLight::UploadSessionEndpoint::UploadSession session;
+	if (!TesLight::UploadSessionEndpoint::readSession(id, session))
+	{
+		TesLight::UploadSessionEndpoint::freeChunkBuffer();
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, (String)F("Upload session ") + id + F(" was not found."));
+		webServer->send(404, F("text/plain"), (String)F("Upload session ") + id + F(" was not found."));
+		return;
+	}
+
+	if (TesLight::UploadSessionEndpoint::chunkSize == 0 || crc != crc32_le(0, TesLight::UploadSessionEndpoint::chunkBuffer, TesLight::UploadSessionEndpoint::chunkSize))
+	{
+		TesLight::UploadSessionEndpoint::freeChunkBuffer();
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The chunk is empty or the checksum does not match."));
+		webServer->send(400, F("text/plain"), F("The chunk is empty or the checksum does not match."));
+		return;
+	}
+
+	// The last received chunk is acknowledged again when the client retries it because the response got lost
+	const uint32_t currentOffset = TesLight::UploadSessionEndpoint::getOffset(id);
+	uint32_t partCrc = 0;
+	if (offset + TesLight::UploadSessionEndpoint::chunkSize == currentOffset && TesLight::UploadSessionEndpoint::getPartCrc(id, offset, TesLight::UploadSessionEndpoint::chunkSize, partCrc) && partCrc == crc)
+	{
+		TesLight::UploadSessionEndpoint::freeChunkBuffer();
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("The chunk at offset ") + String(offset) + F(" was already received."));
+		webServer->send(200, F("text/plain"), String(currentOffset));
+		return;
+	}
+	else if (offset != currentOffset)
+	{
+		TesLight::UploadSessionEndpoint::freeChunkBuffer();
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, (String)F("The chunk offset ") + String(offset) + F(" does not match the current offset ") + String(currentOffset) + F("."));
+		webServer->send(409, F("text/plain"), String(currentOffset));
+		return;
+	}
+	else if (offset + TesLight::UploadSessionEndpoint::chunkSize > session.size)
+	{
+		TesLight::UploadSessionEndpoint::freeChunkBuffer();
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The chunk exceeds the size of the upload session."));
+		webServer->send(400, F("text/plain"), F("The chunk exceeds the size of the upload session."));
+		return;
+	}
+
+	File partFile = TesLight::UploadSessionEndpoint::fileSystem->open(TesLight::UploadSessionEndpoint::getPartFileName(id), FILE_APPEND);
+	if (!partFile)
+	{
+		TesLight::UploadSessionEndpoint::freeChunkBuffer();
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to open the upload file."));
+		webServer->send(500, F("text/plain"), F("Failed to open the upload file."));
+		return;
+	}
+
+	const size_t bytesWritten = partFile.write(TesLight::UploadSessionEndpoint::chunkBuffer, TesLight::UploadSessionEndpoint::chunkSize);
+	partFile.close();
+	if (bytesWritten != TesLight::UploadSessionEndpoint::chunkSize)
+	{
+		// The written part of the chunk was verified already, the client can continue from the new offset
+		TesLight::UploadSessionEndpoint::freeChunkBuffer();
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to write chunk to file. Not all bytes were written."));
+		webServer->send(500, F("text/plain"), F("Failed to write chunk to file. Not all bytes were written."));
+		return;
+	}
+
+	TesLight::UploadSessionEndpoint::freeChunkBuffer();
+	webServer->send(200, F("text/plain"), String(currentOffset + bytesWritten));
+}
+
+/**
+ * @brief Receive the data of a chunk into memory. It is written to the file after the checksum was verified.
+ */
+void TesLight::UploadSessionEndpoint::chunkUpload()
+{
+	HTTPUpload &upload = webServer->upload();
+	if (upload.status == UPLOAD_FILE_START)
+	{
+		TesLight::UploadSessionEndpoint::chunkSize = 0;
+		TesLight::UploadSessionEndpoint::chunkFailed = false;
+		if (TesLight::UploadSessionEndpoint::chunkBuffer == nullptr)
+		{
+			TesLight::UploadSessionEndpoint::chunkBuffer = new uint8_t[UPLOAD_SESSION_MAX_CHUNK_SIZE];
+		}
+	}
+	else if (upload.status == UPLOAD_FILE_WRITE)
+	{
+		if (TesLight::UploadSessionEndpoint::chunkFailed)
+		{
+			return;
+		}
+		else if (TesLight::UploadSessionEndpoint::chunkSize + upload.currentSize > UPLOAD_SESSION_MAX_CHUNK_SIZE)
+		{
+			TesLight::UploadSessionEndpoint::chunkFailed = true;
+			return;
+		}
+
+		memcpy(TesLight::UploadSessionEndpoint::chunkBuffer + TesLight::UploadSessionEndpoint::chunkSize, upload.buf, upload.currentSize);
+		TesLight::UploadSessionEndpoint::chunkSize += upload.currentSize;
+	}
+	else if (upload.status == UPLOAD_FILE_ABORTED)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The chunk upload was aborted by the client. The session can be resumed."));
+		TesLight::UploadSessionEndpoint::chunkFailed = true;
+	}
+}
+
+/**
+ * @brief Delete an upload session and the received data.
+ */
+void TesLight::UploadSessionEndpoint::deleteSession()
+{
+	const String id = webServer->arg(F("id"));
+	TesLight::UploadSessionEndpoint::UploadSession session;
+	if (!TesLight::UploadSessionEndpoint::readSession(id, session))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, (String)F("Upload session ") + id + F(" was not found."));
+		webServer->send(404, F("text/plain"), (String)F("Upload session ") + id + F(" was not found."));
+		return;
+	}
+
+	TesLight::UploadSessionEndpoint::removeSession(id);
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("Upload session ") + id + F(" deleted."));
+	webServer->send(200, F("text/plain"), F("Upload session deleted."));
+}
+
+/**
+ * @brief Finish an upload session once all data was received. The CRC32 of the whole file must match the one of the session.
+ * Fseq files are verified and moved into the fseq directory.
+ * Update packages are moved into the update directory and the controller is rebooted to install the update.
+ */
+void TesLight::UploadSessionEndpoint::commitSession()
+{
+	const String id = webServer->arg(F("id"));
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("Received request to commit upload session ") + id + F("."));
+	TesLight::UploadSessionEndpoint::UploadSession session;
+	if (!TesLight::UploadSessionEndpoint::readSession(id, session))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, (String)F("Upload session ") + id + F(" was not found."));
+		webServer->send(404, F("text/plain"), (String)F("Upload session ") + id + F(" was not found."));
+		return;
+	}
+
+	const uint32_t offset = TesLight::UploadSessionEndpoint::getOffset(id);
+	if (offset != session.size)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, (String)F("Upload session is incomplete. Received ") + String(offset) + F(" of ") + String(session.size) + F(" bytes."));
+		webServer->send(409, F("text/plain"), String(offset));
+		return;
+	}
+
+	uint32_t crc = 0;
+	if (!TesLight::UploadSessionEndpoint::getPartCrc(id, 0, session.size, crc) || crc != session.crc)
+	{
+		TesLight::UploadSessionEndpoint::removeSession(id);
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The checksum of the uploaded file does not match. The file will be deleted."));
+		webServer->send(400, F("text/plain"), F("The checksum of the uploaded file does not match. The file will be deleted."));
+		return;
+	}
+
+	if (session.target == TesLight::UploadSessionEndpoint::UploadTarget::FSEQ)
+	{
+		TesLight::FseqLoader fseqLoader(TesLight::UploadSessionEndpoint::fileSystem);
+		const bool valid = fseqLoader.loadFromFile(TesLight::UploadSessionEndpoint::getPartFileName(id));
+		fseqLoader.close();
+		if (!valid)
+		{
+			TesLight::UploadSessionEndpoint::removeSession(id);
+			TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("The uploaded fseq file is invalid and will be deleted."));
+			webServer->send(400, F("text/plain"), F("The uploaded fseq file is invalid and will be deleted."));
+			return;
+		}
+
+		if (!TesLight::UploadSessionEndpoint::fileSystem->rename(TesLight::UploadSessionEndpoint::getPartFileName(id), (String)FSEQ_DIRECTORY + F("/") + session.fileName))
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to move the uploaded fseq file."));
+			webServer->send(500, F("text/plain"), F("Failed to move the uploaded fseq file."));
+			return;
+		}
+
+		TesLight::UploadSessionEndpoint::removeSession(id);
+		if (!TesLight::UploadSessionEndpoint::fseqIndex->add(session.fileName))
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Failed to add the uploaded fseq file to the index."));
+		}
+
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Upload of fseq file completed."));
+		webServer->send(200, F("text/plain"), F("File upload successful."));
+	}
+	else
+	{
+		const String packageFileName = (String)UPDATE_DIRECTORY + F("/") + UPDATE_FILE_NAME;
+		TesLight::UploadSessionEndpoint::fileSystem->mkdir(UPDATE_DIRECTORY);
+		TesLight::UploadSessionEndpoint::fileSystem->remove(packageFileName);
+		if (!TesLight::UploadSessionEndpoint::fileSystem->rename(TesLight::UploadSessionEndpoint::getPartFileName(id), packageFileName))
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to move the uploaded update package."));
+			webServer->send(500, F("text/plain"), F("Failed to move the uploaded update package."));
+			return;
+		}
+		TesLight::UploadSessionEndpoint::removeSession(id);
+
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Package upload successful, update will start after reboot."));
+		webServer->send(200, F("text/plain"), F("Package upload successful, update will start after reboot."));
+
+		// Reboot the controller.
+		// Update will be installed after the reboot.
+		delay(1000);
+		TesLight::Updater::reboot(F("Update"), TesLight::UploadSessionEndpoint::configuration);
+	}
+}
+
+/**
+ * @brief Calculate the id of an upload session from its target, file name, size and the CRC32 of the file.
+ * @param session upload session
+ * @return id of the session as hex string
+ */
+String TesLight::UploadSessionEndpoint::getSessionId(const TesLight::UploadSessionEndpoint::UploadSession &session)
+{
+	uint32_t id = crc32_le(0, (const uint8_t *)session.fileName.c_str(), session.fileName.length());
+	id = crc32_le(id, (const uint8_t *)&session.size, sizeof(session.size));
+	id = crc32_le(id, (const uint8_t *)&session.crc, sizeof(session.crc));
+	id = crc32_le(id, (const uint8_t *)&session.target, sizeof(session.target));
+	return String(id, HEX);
+}
+
+/**
+ * @brief Get the name of the file holding the received data of a session.
+ * @param id id of the session
+ * @return full path and name of the file
+ */
+String TesLight::UploadSessionEndpoint::getPartFileName(const String id)
+{
+	return (String)UPLOAD_SESSION_DIRECTORY + F("/") + id + F(".part");
+}
+
+/**
+ * @brief Get the name of the file holding the information of a session.
+ * @param id id of the session
+ * @return full path and name of the file
+ */
+String TesLight::UploadSessionEndpoint::getSessionFileName(const String id)
+{
+	return (String)UPLOAD_SESSION_DIRECTORY + F("/") + id + F(".session");
+}
+
+/**
+ * @brief Read the information of a session from the SD card.
+ * @param id id of the session
+ * @param session reference variable holding the session
+ * @return true when successful
+ * @return false when the session does not exist
+ */
+bool TesLight::UploadSessionEndpoint::readSession(const String id, TesLight::UploadSessionEndpoint::UploadSession &session)
+{
+	if (id.length() == 0 || id.length() > 8)
+	{
+		return false;
+	}
+
+	TesLight::BinaryFile file(TesLight::UploadSessionEndpoint::fileSystem);
+	if (!TesLight::FileUtil::fileExists(TesLight::UploadSessionEndpoint::fileSystem, TesLight::UploadSessionEndpoint::getSessionFileName(id)) || !file.open(TesLight::UploadSessionEndpoint::getSessionFileName(id), FILE_READ))
+	{
+		return false;
+	}
+
+	uint8_t target = 0;
+	const bool valid = file.read(target) && file.read(session.size) && file.read(session.crc) && file.readString(session.fileName);
+	file.close();
+	session.target = (TesLight::UploadSessionEndpoint::UploadTarget)target;
+	return valid && TesLight::UploadSessionEndpoint::getSessionId(session) == id;
+}
+
+/**
+ * @brief Write the information of a session to the SD card.
+ * @param id id of the session
+ * @param session session to write
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::UploadSessionEndpoint::writeSession(const String id, const TesLight::UploadSessionEndpoint::UploadSession &session)
+{
+	TesLight::BinaryFile file(TesLight::UploadSessionEndpoint::fileSystem);
+	if (!file.open(TesLight::UploadSessionEndpoint::getSessionFileName(id), FILE_WRITE))
+	{
+		return false;
+	}
+
+	const bool success = file.write((uint8_t)session.target) && file.write(session.size) && file.write(session.crc) && file.writeString(session.fileName);
+	file.close();
+	return success;
+}
+
+/**
+ * @brief Get the number of bytes received for a session.
+ * @param id id of the session
+ * @return number of received bytes
+ */
+uint32_t TesLight::UploadSessionEndpoint::getOffset(const String id)
+{
+	File partFile = TesLight::UploadSessionEndpoint::fileSystem->open(TesLight::UploadSessionEndpoint::getPartFileName(id), FILE_READ);
+	if (!partFile)
+	{
+		return 0;
+	}
+
+	const uint32_t offset = partFile.size();
+	partFile.close();
+	return offset;
+}
+
+/**
+ * @brief Calculate the CRC32 of a range of the received data of a session.
+ * @param id id of the session
+ * @param offset start of the range
+ * @param size size of the range
+ * @param crc reference variable holding the CRC32 of the range
+ * @return true when successful
+ * @return false when the range could not be read
+ */
+bool TesLight::UploadSessionEndpoint::getPartCrc(const String id, const uint32_t offset, const uint32_t size, uint32_t &crc)
+{
+	File partFile = TesLight::UploadSessionEndpoint::fileSystem->open(TesLight::UploadSessionEndpoint::getPartFileName(id), FILE_READ);
+	if (!partFile)
+	{
+		return false;
+	}
+	else if (!partFile.seek(offset))
+	{
+		partFile.close();
+		return false;
+	}
+
+	uint8_t *buffer = new uint8_t[UPLOAD_SESSION_CRC_BUFFER_SIZE];
+	uint32_t remaining = size;
+	crc = 0;
+	while (remaining > 0)
+	{
+		const size_t blockSize = remaining < UPLOAD_SESSION_CRC_BUFFER_SIZE ? remaining : UPLOAD_SESSION_CRC_BUFFER_SIZE;
+		if (partFile.read(buffer, blockSize) != blockSize)
+		{
+			delete[] buffer;
+			partFile.close();
+			return false;
+		}
+
+		crc = crc32_le(crc, buffer, blockSize);
+		remaining -= blockSize;
+	}
+
+	delete[] buffer;
+	partFile.close();
+	return true;
+}
+
+/**
+ * @brief Remove the data and information of a session from the SD card.
+ * @param id id of the session
+ */
+void TesLight::UploadSessionEndpoint::removeSession(const String id)
+{
+	TesLight::UploadSessionEndpoint::fileSystem->remove(TesLight::UploadSessionEndpoint::getPartFileName(id));
+	TesLight::UploadSessionEndpoint::fileSystem->remove(TesLight::UploadSessionEndpoint::getSessionFileName(id));
+}
+
+/**
+ * @brief Free the memory of the chunk buffer.
+ */
+void TesLight::UploadSessionEndpoint::freeChunkBuffer()
+{
+	if (TesLight::UploadSessionEndpoint::chunkBuffer != nullptr)
+	{
+		delete[] TesLight::UploadSessionEndpoint::chunkBuffer;
+		TesLight::UploadSessionEndpoint::chunkBuffer = nullptr;
+	}
+	TesLight::UploadSessionEndpoint::chunkSize = 0;
+}
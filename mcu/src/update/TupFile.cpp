@@ -13,6 +13,9 @@
  */
 TesLight::TupFile::TupFile()
 {
+	mbedtls_sha256_init(&this->shaContext);
+	this->window = nullptr;
+	this->inputBuffer = nullptr;
 	this->initHeader();
 }
 
@@ -22,10 +25,11 @@ TesLight::TupFile::TupFile()
 TesLight::TupFile::~TupFile()
 {
 	this->close();
+	mbedtls_sha256_free(&this->shaContext);
 }
 
 /**
- * @brief Open a TUP file and verify it.
+ * @brief Open a TUP file and load the header. The content is verified while it is read, see {@link TesLight::TupFile::verify}.
  * @param fileSystem file system where the file is located
  * @param fileName name of the file to open
  * @return true when the file is opened
@@ -54,92 +58,146 @@ bool TesLight::TupFile::load(FS *fileSystem, const String fileName)
 		return false;
 	}
 
-	if (!this->verify())
+	this->window = new uint8_t[UPDATE_TUP_WINDOW_SIZE];
+	this->inputBuffer = new uint8_t[UPDATE_TUP_INPUT_BUFFER_SIZE];
+	return true;
+}
+
+/**
+ * @brief Read the header of the next data block. The data of the previous block must be read completely before.
+ * The path of the returned block is valid until the next block is read.
+ * @param dataBlock reference to the data block
+ * @return true when successful
+ * @return false when there are no more blocks or the block is invalid
+ */
+bool TesLight::TupFile::readBlock(TesLight::TupFile::TupDataBlock &dataBlock)
+{
+	if (this->blocksRead >= this->tupHeader.numberBlocks)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to read data block. There are no more blocks."));
+		return false;
+	}
+	else if (this->blockRemaining > 0)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to read data block. The data of the previous block was not read completely."));
+		return false;
+	}
+
+	uint8_t type = 0;
+	if (!this->readHashed(&type, 1) || !this->readHashed((uint8_t *)&dataBlock.pathLength, 2))
+	{
+		return false;
+	}
+	else if (dataBlock.pathLength > 255)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Invalid name for data block ") + String(this->blocksRead) + F("."));
+		return false;
+	}
+	else if (!this->readHashed((uint8_t *)this->blockPath, dataBlock.pathLength) || !this->readHashed((uint8_t *)&dataBlock.size, 4))
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to verify TUP file. The file is invalid or corrupted."));
-		this->close();
 		return false;
 	}
 
+	dataBlock.type = (TesLight::TupFile::TupDataType)type;
+	dataBlock.path = this->blockPath;
+	dataBlock.data = nullptr;
+
+	this->blockRemaining = dataBlock.size;
+	this->chunkRemaining = 0;
+	this->blocksRead++;
 	return true;
 }
 
 /**
- * @brief Unpack the content of the valid package to a specified folder on the file system.
- * @param fileSystem file system to which to data is unpacked
- * @param root root folder to which the data is unpacked
- * @return true when the unpacking was successful
- * @return false when there was an error unpacking the data
+ * @brief Read data of the current data block. The data is stored in chunks, each protected by a CRC32.
+ * Compressed chunks are decompressed while reading, using a small sliding window.
+ * The CRC of a chunk is checked as soon as the last byte of the chunk was read.
+ * @param buffer buffer for the data
+ * @param size number of bytes to read
+ * @return true when successful
+ * @return false when the file is truncated or a chunk is corrupted
  */
-bool TesLight::TupFile::unpack(FS *fileSystem, const String root)
+bool TesLight::TupFile::readData(uint8_t *buffer, const size_t size)
 {
-	if (!this->file.seek(13))
+	if (size > this->blockRemaining)
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to unpack TUP file. There is no content."));
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to read data. The requested size exceeds the data block."));
 		return false;
 	}
 
-	TesLight::TupFile::TupDataBlock dataBlock;
-	dataBlock.type = TesLight::TupFile::TupDataType::FIRMWARE;
-	dataBlock.path = new char[256];
-	for (uint32_t i = 0; i < this->tupHeader.numberBlocks; i++)
+	size_t bytesRead = 0;
+	while (bytesRead < size)
 	{
-		this->file.read((uint8_t *)&dataBlock.type, 1);
-		this->file.read((uint8_t *)&dataBlock.pathLength, 2);
-		if (dataBlock.pathLength > 255)
+		if (this->chunkRemaining == 0 && !this->readChunkHeader())
 		{
-			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Invalid name for data block ") + String(i) + F(". Can not continue."));
-			delete[] dataBlock.path;
 			return false;
 		}
-		this->file.read((uint8_t *)dataBlock.path, dataBlock.pathLength);
-		this->file.read((uint8_t *)&dataBlock.size, 4);
 
-		const String absolutePath = this->createAbsolutePath(root + F("/"), dataBlock.path, dataBlock.pathLength);
-		if (dataBlock.type == TesLight::TupFile::TupDataType::DIRECTORY)
+		const size_t length = size - bytesRead < this->chunkRemaining ? size - bytesRead : this->chunkRemaining;
+		if (this->chunkCompressed)
 		{
-			if (!fileSystem->mkdir(absolutePath))
+			if (!this->decompress(buffer + bytesRead, length))
 			{
-				TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to create directory \"") + absolutePath + F("\". Can not continue."));
-				delete[] dataBlock.path;
+				TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to decompress a chunk in data block ") + String(this->blocksRead - 1) + F("."));
 				return false;
 			}
 		}
-		else if (dataBlock.type == TesLight::TupFile::TupDataType::FILE || dataBlock.type == TesLight::TupFile::TupDataType::FIRMWARE)
+		else
 		{
-			File file = fileSystem->open(absolutePath, FILE_WRITE);
-			if (!file)
+			if (!this->readHashed(buffer + bytesRead, length))
 			{
-				TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to write file \"") + absolutePath + F("\". Can not continue."));
-				delete[] dataBlock.path;
 				return false;
 			}
+			this->chunkStoredRemaining -= length;
+		}
 
-			uint8_t buffer[1024];
-			uint32_t readBytes = 0;
-			while (readBytes < dataBlock.size)
-			{
-				uint32_t chunkSize = dataBlock.size - readBytes;
-				if (chunkSize > 1024)
-				{
-					chunkSize = 1024;
-				}
+		this->chunkCrc = crc32_le(this->chunkCrc, buffer + bytesRead, length);
+		this->chunkRemaining -= length;
+		this->blockRemaining -= length;
+		bytesRead += length;
 
-				chunkSize = this->file.read(buffer, chunkSize);
-				readBytes += chunkSize;
+		if (this->chunkRemaining == 0 && (this->chunkStoredRemaining != 0 || this->inputPosition != this->inputLength || this->matchRemaining != 0))
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to read data. A chunk in data block ") + String(this->blocksRead - 1) + F(" has an invalid size."));
+			return false;
+		}
+		else if (this->chunkRemaining == 0 && this->chunkCrc != this->chunkExpectedCrc)
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to read data. The CRC of a chunk in data block ") + String(this->blocksRead - 1) + F(" is invalid."));
+			return false;
+		}
+	}
 
-				uint32_t bytesWritten = 0;
-				while (bytesWritten < chunkSize)
-				{
-					bytesWritten += file.write(buffer + bytesWritten, chunkSize - bytesWritten);
-				}
-			}
+	return true;
+}
 
-			file.close();
-		}
+/**
+ * @brief Verify the TUP file after all blocks and their data was read.
+ * The SHA-256 of the file is compared against the value in the header.
+ * @return true when the file is valid
+ * @return false when the file is invalid
+ */
+bool TesLight::TupFile::verify()
+{
+	if (this->blocksRead != this->tupHeader.numberBlocks || this->blockRemaining != 0 || this->file.position() != this->file.size())
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to verify TUP file. The file was not read completely or contains additional data."));
+		return false;
+	}
+
+	uint8_t hash[32];
+	if (mbedtls_sha256_finish_ret(&this->shaContext, hash) != 0)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to verify TUP file. The SHA-256 could not be calculated."));
+		return false;
+	}
+
+	if (memcmp(hash, this->tupHeader.hash, sizeof(hash)) != 0)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to verify TUP file. The SHA-256 does not match."));
+		return false;
 	}
 
-	delete[] dataBlock.path;
 	return true;
 }
 
@@ -153,6 +211,16 @@ void TesLight::TupFile::close()
 	{
 		this->file.close();
 	}
+	if (this->window != nullptr)
+	{
+		delete[] this->window;
+		this->window = nullptr;
+	}
+	if (this->inputBuffer != nullptr)
+	{
+		delete[] this->inputBuffer;
+		this->inputBuffer = nullptr;
+	}
 }
 
 /**
@@ -165,7 +233,7 @@ TesLight::TupFile::TupHeader TesLight::TupFile::getHeader()
 }
 
 /**
- * @brief Initialize the TUP header.
+ * @brief Initialize the TUP header and reset the verification state.
  */
 void TesLight::TupFile::initHeader()
 {
@@ -174,8 +242,26 @@ void TesLight::TupFile::initHeader()
 	this->tupHeader.magic[2] = 0;
 	this->tupHeader.magic[3] = 0;
 	this->tupHeader.fileVersion = 0;
-	this->tupHeader.hash = 0;
+	memset(this->tupHeader.hash, 0, sizeof(this->tupHeader.hash));
 	this->tupHeader.numberBlocks = 0;
+	this->blocksRead = 0;
+	this->blockRemaining = 0;
+	this->chunkRemaining = 0;
+	this->chunkStoredRemaining = 0;
+	this->chunkCompressed = false;
+	this->chunkCrc = 0;
+	this->chunkExpectedCrc = 0;
+	this->windowPosition = 0;
+	this->inputLength = 0;
+	this->inputPosition = 0;
+	this->flags = 0;
+	this->flagBits = 0;
+	this->matchDistance = 0;
+	this->matchRemaining = 0;
+
+	mbedtls_sha256_free(&this->shaContext);
+	mbedtls_sha256_init(&this->shaContext);
+	mbedtls_sha256_starts_ret(&this->shaContext, 0);
 }
 
 /**
@@ -190,7 +276,7 @@ bool TesLight::TupFile::loadTupHeader()
 		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Could not load TUP header because the file could not be opened."));
 		return false;
 	}
-	else if (this->file.size() < 13)
+	else if (this->file.size() < 41)
 	{
 		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Could not load TUP header. The file is invalid."));
 		return false;
@@ -198,7 +284,7 @@ bool TesLight::TupFile::loadTupHeader()
 
 	this->file.read((uint8_t *)this->tupHeader.magic, 4);
 	this->file.read((uint8_t *)&this->tupHeader.fileVersion, 1);
-	this->file.read((uint8_t *)&this->tupHeader.hash, 4);
+	this->file.read(this->tupHeader.hash, 32);
 	this->file.read((uint8_t *)&this->tupHeader.numberBlocks, 4);
 
 	if (this->tupHeader.magic[0] != 'T' || this->tupHeader.magic[1] != 'L' || this->tupHeader.magic[2] != 'U' || this->tupHeader.magic[3] != 'P')
@@ -207,7 +293,7 @@ bool TesLight::TupFile::loadTupHeader()
 		return false;
 	}
 
-	if (this->tupHeader.fileVersion != 1)
+	if (this->tupHeader.fileVersion != UPDATE_TUP_VERSION)
 	{
 		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to load TUP header. Invalid file version."));
 		return false;
@@ -223,93 +309,157 @@ bool TesLight::TupFile::loadTupHeader()
 }
 
 /**
- * @brief Verify a {@link TesLight::TupFile}.
- * @return true when the file is valid
- * @return false when the file is invalid
+ * @brief Read the header of the next data chunk of the current data block.
+ * A chunk is compressed when its stored size is smaller than its raw size.
+ * @return true when successful
+ * @return false when the chunk header is invalid
  */
-bool TesLight::TupFile::verify()
+bool TesLight::TupFile::readChunkHeader()
 {
-	return this->generateHash() == this->tupHeader.hash;
+	uint32_t rawSize = 0;
+	uint32_t storedSize = 0;
+	if (!this->readHashed((uint8_t *)&rawSize, 4) || !this->readHashed((uint8_t *)&storedSize, 4) || !this->readHashed((uint8_t *)&this->chunkExpectedCrc, 4))
+	{
+		return false;
+	}
+	else if (rawSize == 0 || rawSize > UPDATE_TUP_MAX_CHUNK_SIZE || rawSize > this->blockRemaining || storedSize == 0 || storedSize > rawSize)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Invalid chunk size in data block ") + String(this->blocksRead - 1) + F("."));
+		return false;
+	}
+
+	this->chunkRemaining = rawSize;
+	this->chunkStoredRemaining = storedSize;
+	this->chunkCompressed = storedSize < rawSize;
+	this->chunkCrc = 0;
+	this->windowPosition = 0;
+	this->inputLength = 0;
+	this->inputPosition = 0;
+	this->flagBits = 0;
+	this->matchRemaining = 0;
+	return true;
 }
 
 /**
- * @brief Generate the simple hash to verify the TUP file.
- * @return uint32_t hash
+ * @brief Read bytes from the TUP file and add them to the SHA-256 of the file.
+ * @param buffer buffer for the data
+ * @param size number of bytes to read
+ * @return true when successful
+ * @return false when the file is truncated
  */
-uint32_t TesLight::TupFile::generateHash()
+bool TesLight::TupFile::readHashed(uint8_t *buffer, const size_t size)
 {
-	if (!this->file.seek(13))
+	if (this->file.read(buffer, size) != size)
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to generate hash for TUP file. There is no content."));
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to read data. The file is truncated."));
 		return false;
 	}
 
-	TesLight::TupFile::TupDataBlock dataBlock;
-	dataBlock.type = TesLight::TupFile::TupDataType::FIRMWARE;
-	dataBlock.path = new char[256];
-	uint32_t hash = 7;
-	for (uint32_t i = 0; i < this->tupHeader.numberBlocks; i++)
+	mbedtls_sha256_update_ret(&this->shaContext, buffer, size);
+	return true;
+}
+
+/**
+ * @brief Read a single byte of compressed data of the current chunk. The data is read from the file in blocks.
+ * @param value reference to the value
+ * @return true when successful
+ * @return false when the compressed data of the chunk is exhausted or the file is truncated
+ */
+bool TesLight::TupFile::readCompressed(uint8_t &value)
+{
+	if (this->inputPosition == this->inputLength)
 	{
-		this->file.read((uint8_t *)&dataBlock.type, 1);
-		this->file.read((uint8_t *)&dataBlock.pathLength, 2);
-		if (dataBlock.pathLength > 255)
+		if (this->chunkStoredRemaining == 0)
 		{
-			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("The name of the data block is invalid."));
-			delete[] dataBlock.path;
-			return 0;
+			return false;
 		}
-		this->file.read((uint8_t *)dataBlock.path, dataBlock.pathLength <= 255 ? dataBlock.pathLength : 255);
-		this->file.read((uint8_t *)&dataBlock.size, 4);
-
-		hash = hash * 31 + dataBlock.type;
-		hash = hash * 31 + dataBlock.pathLength;
 
-		for (uint32_t j = 0; j < dataBlock.pathLength; j++)
+		this->inputLength = this->chunkStoredRemaining < UPDATE_TUP_INPUT_BUFFER_SIZE ? this->chunkStoredRemaining : UPDATE_TUP_INPUT_BUFFER_SIZE;
+		this->inputPosition = 0;
+		if (!this->readHashed(this->inputBuffer, this->inputLength))
 		{
-			hash = hash * 31 + dataBlock.path[j];
+			this->inputLength = 0;
+			return false;
 		}
+		this->chunkStoredRemaining -= this->inputLength;
+	}
 
-		hash = hash * 31 + dataBlock.size;
+	value = this->inputBuffer[this->inputPosition++];
+	return true;
+}
 
-		uint8_t buffer[1024];
-		uint32_t readBytes = 0;
-		while (readBytes < dataBlock.size)
+/**
+ * @brief Decompress LZSS data of the current chunk. The state is kept between calls, so a match can span multiple calls.
+ * Each group of 8 items starts with a flag byte. A set bit (starting with the lowest bit) marks a literal byte.
+ * A cleared bit marks a match of 2 bytes with the distance - 1 in the upper 12 bit and the length - 3 in the lower 4 bit.
+ * @param buffer buffer for the decompressed data
+ * @param size number of bytes to decompress
+ * @return true when successful
+ * @return false when the compressed data is invalid
+ */
+bool TesLight::TupFile::decompress(uint8_t *buffer, const size_t size)
+{
+	for (size_t i = 0; i < size; i++)
+	{
+		if (this->matchRemaining == 0)
 		{
-			uint32_t chunkSize = dataBlock.size - readBytes;
-			if (chunkSize > 1024)
+			if (this->flagBits == 0)
 			{
-				chunkSize = 1024;
+				if (!this->readCompressed(this->flags))
+				{
+					return false;
+				}
+				this->flagBits = 8;
 			}
 
-			chunkSize = this->file.read(buffer, chunkSize);
-			readBytes += chunkSize;
+			const bool literal = this->flags & 0x01;
+			this->flags >>= 1;
+			this->flagBits--;
+
+			if (literal)
+			{
+				if (!this->readCompressed(buffer[i]))
+				{
+					return false;
+				}
+				this->window[this->windowPosition] = buffer[i];
+				this->windowPosition = (this->windowPosition + 1) % UPDATE_TUP_WINDOW_SIZE;
+				continue;
+			}
 
-			for (uint16_t j = 0; j < chunkSize; j++)
+			uint8_t high = 0;
+			uint8_t low = 0;
+			if (!this->readCompressed(high) || !this->readCompressed(low))
 			{
-				hash = hash * 31 + buffer[j];
+				return false;
 			}
+			this->matchDistance = ((high << 4) | (low >> 4)) + 1;
+			this->matchRemaining = (low & 0x0F) + 3;
 		}
+
+		buffer[i] = this->window[(this->windowPosition + UPDATE_TUP_WINDOW_SIZE - this->matchDistance) % UPDATE_TUP_WINDOW_SIZE];
+		this->window[this->windowPosition] = buffer[i];
+		this->windowPosition = (this->windowPosition + 1) % UPDATE_TUP_WINDOW_SIZE;
+		this->matchRemaining--;
 	}
 
-	delete[] dataBlock.path;
-	return hash;
+	return true;
 }
 
 /**
  * @brief Construct the absolute path based on the extraction root and the name of the data block.
  * @param root root path
- * @param path relative path to root from TUP
- * @param pathLength length of the realative path
+ * @param dataBlock data block with the path relative to root
  * @return String absolute path
  */
-String TesLight::TupFile::createAbsolutePath(const String root, const char *name, uint16_t nameLength)
+String TesLight::TupFile::createAbsolutePath(const String root, const TesLight::TupFile::TupDataBlock &dataBlock)
 {
 	String absolutePath = root;
-	for (uint16_t i = 0; i < nameLength; i++)
+	for (uint16_t i = 0; i < dataBlock.pathLength; i++)
 	{
-		if (name[i] != '\\')
+		if (dataBlock.path[i] != '\\')
 		{
-			absolutePath += name[i];
+			absolutePath += dataBlock.path[i];
 		}
 		else
 		{
@@ -9,7 +9,9 @@
 #include "update/Updater.h"
 
 /**
- * @brief Run a full system update from a TUP file.
+ * @brief Run a full system update from a TUP file in a single pass. The firmware is written directly into the OTA partition
+ * and all files are unpacked into a staging directory. Only when the whole package was verified, the staged files replace
+ * the old ones and the firmware is activated. When the files can't be replaced, the package is kept to retry on the next boot.
  * @param fileSystem where the TUP file is stored and unpacked
  * @param packageFileName full path and name of the package file
  * @return true when the update was successful
@@ -27,55 +29,111 @@ bool TesLight::Updater::install(FS *fileSystem, const String packageFileName)
 	}
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Update package was found."));
 
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Loading and verifying update package."));
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Loading update package."));
 	TesLight::TupFile tupFile;
 	if (!tupFile.load(fileSystem, packageFileName))
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Verification of the update package failed. The file must be invalid or is corrupted."));
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to load the update package. The file must be invalid or is corrupted."));
+		fileSystem->remove(packageFileName);
 		return false;
 	}
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Update package verified."));
 
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Cleaning file system root."));
-	if (!TesLight::FileUtil::clearRoot(fileSystem))
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Preparing staging directory."));
+	if (TesLight::FileUtil::directoryExists(fileSystem, UPDATE_STAGING_DIRECTORY))
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to clean file system root."));
+		TesLight::FileUtil::deleteDirectory(fileSystem, UPDATE_STAGING_DIRECTORY, true);
+	}
+	if (!fileSystem->mkdir(UPDATE_STAGING_DIRECTORY))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to create staging directory."));
+		tupFile.close();
+		TesLight::Updater::abort(fileSystem, packageFileName);
 		return false;
 	}
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("File system root cleaned. All old data removed."));
 
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Unpacking update package."));
-	if (!tupFile.unpack(fileSystem, F("/")))
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Installing firmware and unpacking files."));
+	uint8_t *buffer = new uint8_t[UPDATE_BUFFER_SIZE];
+	bool firmwareInstalled = false;
+	bool success = true;
+	for (uint32_t i = 0; i < tupFile.getHeader().numberBlocks && success; i++)
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to unpack update package."));
-		fileSystem->remove(packageFileName);
+		TesLight::TupFile::TupDataBlock dataBlock;
+		if (!tupFile.readBlock(dataBlock))
+		{
+			success = false;
+		}
+		else if (dataBlock.type == TesLight::TupFile::TupDataType::FIRMWARE)
+		{
+			success = !firmwareInstalled && TesLight::Updater::writeFirmware(tupFile, dataBlock, buffer);
+			firmwareInstalled = true;
+		}
+		else if (dataBlock.type == TesLight::TupFile::TupDataType::FIRMWARE_DELTA)
+		{
+			success = !firmwareInstalled && TesLight::Updater::applyFirmwareDelta(tupFile, dataBlock, buffer);
+			firmwareInstalled = true;
+		}
+		else if (dataBlock.type == TesLight::TupFile::TupDataType::FILE)
+		{
+			success = TesLight::Updater::unpackFile(fileSystem, tupFile, dataBlock, buffer);
+		}
+		else if (dataBlock.type == TesLight::TupFile::TupDataType::DIRECTORY)
+		{
+			const String path = tupFile.createAbsolutePath((String)UPDATE_STAGING_DIRECTORY + F("/"), dataBlock);
+			success = fileSystem->mkdir(path);
+			if (!success)
+			{
+				TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to create directory \"") + path + F("\"."));
+			}
+		}
+		else
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Unknown type of data block ") + String(i) + F("."));
+			success = false;
+		}
+	}
+	delete[] buffer;
+
+	if (!success || !tupFile.verify())
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to install the update package. The file must be invalid or is corrupted. The old system is kept."));
+		tupFile.close();
+		TesLight::Updater::abort(fileSystem, packageFileName);
 		return false;
 	}
 	tupFile.close();
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Update package was unpacked successfully."));
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Update package verified."));
 
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Deleting update package."));
-	if (!fileSystem->remove(packageFileName))
+	// The firmware is activated last, so that it never runs with the files of the old system
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Replacing files with the staged files."));
+	if (!TesLight::Updater::swapStagedFiles(fileSystem))
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Failed to delete update package. You should delete it manually."));
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to replace all files with the staged files. The update package is kept to retry the update on the next boot."));
+		if (Update.isRunning())
+		{
+			Update.abort();
+		}
+		return false;
 	}
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Update package was deleted successfully."));
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Files were replaced successfully."));
 
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Installing firmware file to controller."));
-	if (!TesLight::Updater::installFirmware(fileSystem, F("/firmware.bin")))
+	if (firmwareInstalled)
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to install firmware file to controller."));
-		fileSystem->remove(F("/firmware.bin"));
-		return false;
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Activating new firmware."));
+		if (!Update.end() || !Update.isFinished())
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to end update procedure: ") + String(Update.getError()));
+			TesLight::Updater::abort(fileSystem, packageFileName);
+			return false;
+		}
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Firmware was installed."));
 	}
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Firmware file was installed."));
 
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Deleting firmware file."));
-	if (!fileSystem->remove(F("/firmware.bin")))
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Deleting update package."));
+	if (!fileSystem->remove(packageFileName))
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Failed to delete firmware file. You should delete it manually."));
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Failed to delete update package. You should delete it manually."));
 	}
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Firmware file was deleted successfully."));
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Update package was deleted successfully."));
 
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Update completed. Reboot is required."));
 	return true;
@@ -83,85 +141,302 @@ bool TesLight::Updater::install(FS *fileSystem, const String packageFileName)
 
 /**
  * @brief This function will reboot the controller. It does not return.
+ * @param reason reason for the reboot
+ * @param configuration when set, pending configuration changes are written before the reboot
  */
-void TesLight::Updater::reboot(const String reason)
+void TesLight::Updater::reboot(const String reason, TesLight::Configuration *configuration)
 {
+	if (configuration != nullptr && !configuration->flush(true))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to write the pending configuration changes before the reboot."));
+	}
+
 	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("Rebooting controller for reason: ") + reason);
 	ESP.restart();
 }
 
 /**
- * @brief Install the firmware file to the flash chip.
- * @param fileSystem where the firmware file is stored
- * @param firmwareFileName full path and name of the firmware file
- * @return true when the update was successful
- * @return false when there was an error installing the firmware
+ * @brief Stream a firmware block from the TUP file into the OTA partition. The firmware is not activated.
+ * @param tupFile opened TUP file
+ * @param dataBlock firmware data block
+ * @param buffer buffer of size {@link UPDATE_BUFFER_SIZE}
+ * @return true when successful
+ * @return false when there was an error
  */
-bool TesLight::Updater::installFirmware(FS *fileSystem, const String firmwareFileName)
+bool TesLight::Updater::writeFirmware(TesLight::TupFile &tupFile, const TesLight::TupFile::TupDataBlock &dataBlock, uint8_t *buffer)
 {
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Installing firmware file."));
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Open firmware file."));
-	File firmware = fileSystem->open(firmwareFileName, FILE_READ);
-	if (!firmware)
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("Writing ") + String(dataBlock.size) + F(" bytes of firmware to the flash memory."));
+	if (dataBlock.size == 0 || !Update.begin(dataBlock.size))
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to open firmware file. The file was not found."));
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("The firmware is empty or there is not enought flash memory to install it."));
 		return false;
 	}
-	else if (firmware.isDirectory())
+
+	uint32_t bytesProcessed = 0;
+	while (bytesProcessed < dataBlock.size)
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to open firmware file. It is a directory. No idea how that could happen."));
-		firmware.close();
+		const size_t chunkSize = dataBlock.size - bytesProcessed < UPDATE_BUFFER_SIZE ? dataBlock.size - bytesProcessed : UPDATE_BUFFER_SIZE;
+		if (!tupFile.readData(buffer, chunkSize) || Update.write(buffer, chunkSize) != chunkSize)
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to write the firmware: ") + String(Update.getError()));
+			return false;
+		}
+		bytesProcessed += chunkSize;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Apply a firmware delta block from the TUP file to the running firmware and stream the result into the OTA partition.
+ * The delta starts with the size and SHA-256 of the base firmware and of the resulting firmware, followed by records.
+ * Each record contains the length of extra data, the length of diff data and the offset in the base firmware.
+ * The extra data is copied, the diff data is added byte by byte to the base firmware, which is read from the running partition.
+ * The firmware is not activated.
+ * @param tupFile opened TUP file
+ * @param dataBlock firmware delta data block
+ * @param buffer buffer of size {@link UPDATE_BUFFER_SIZE}
+ * @return true when successful
+ * @return false when the running firmware does not match the base firmware or there was an error
+ */
+bool TesLight::Updater::applyFirmwareDelta(TesLight::TupFile &tupFile, const TesLight::TupFile::TupDataBlock &dataBlock, uint8_t *buffer)
+{
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Applying firmware delta to the running firmware."));
+	uint32_t remaining = dataBlock.size;
+	uint32_t baseSize = 0;
+	uint8_t baseHash[32];
+	uint32_t resultSize = 0;
+	uint8_t resultHash[32];
+	if (!TesLight::Updater::readDeltaData(tupFile, (uint8_t *)&baseSize, 4, remaining) ||
+		!TesLight::Updater::readDeltaData(tupFile, baseHash, 32, remaining) ||
+		!TesLight::Updater::readDeltaData(tupFile, (uint8_t *)&resultSize, 4, remaining) ||
+		!TesLight::Updater::readDeltaData(tupFile, resultHash, 32, remaining))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to read the header of the firmware delta."));
 		return false;
 	}
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Firmware file loaded."));
 
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Checking size of the firmware file."));
-	const size_t firmwareSize = firmware.size();
-	if (firmwareSize == 0)
+	const esp_partition_t *basePartition = esp_ota_get_running_partition();
+	if (basePartition == nullptr || baseSize == 0 || baseSize > basePartition->size)
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Firmware file is empty."));
-		firmware.close();
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("The base firmware of the delta does not fit the running partition."));
 		return false;
 	}
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("Firmware file has ") + String(firmwareSize) + F("bytes of date."));
 
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Starting firmware update."));
-	if (!Update.begin(firmwareSize))
+	if (!TesLight::Updater::verifyPartition(basePartition, baseSize, baseHash, buffer))
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Not enought flash memory to install firmware file."));
-		firmware.close();
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("The running firmware is not the base firmware of the delta. Please install the full update package."));
 		return false;
 	}
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Firmware update started."));
 
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Writing data to flash memory."));
-	const size_t writtenBytes = Update.writeStream(firmware);
-	if (writtenBytes != firmwareSize)
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("Writing ") + String(resultSize) + F(" bytes of firmware to the flash memory."));
+	if (resultSize == 0 || !Update.begin(resultSize))
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Not all data was written. This is not good..."));
-		firmware.close();
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("The firmware is empty or there is not enought flash memory to install it."));
 		return false;
 	}
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("All data was written into the flash memory."));
 
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Ending update procedure."));
-	if (!Update.end())
+	const size_t chunkSize = UPDATE_BUFFER_SIZE / 2;
+	uint8_t *baseBuffer = buffer + chunkSize;
+	mbedtls_sha256_context shaContext;
+	mbedtls_sha256_init(&shaContext);
+	mbedtls_sha256_starts_ret(&shaContext, 0);
+
+	bool success = true;
+	uint32_t bytesWritten = 0;
+	while (bytesWritten < resultSize && success)
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to end update procedure: ") + String(Update.getError()));
-		firmware.close();
+		uint32_t extraLength = 0;
+		uint32_t diffLength = 0;
+		uint32_t baseOffset = 0;
+		if (!TesLight::Updater::readDeltaData(tupFile, (uint8_t *)&extraLength, 4, remaining) ||
+			!TesLight::Updater::readDeltaData(tupFile, (uint8_t *)&diffLength, 4, remaining) ||
+			!TesLight::Updater::readDeltaData(tupFile, (uint8_t *)&baseOffset, 4, remaining) ||
+			extraLength > resultSize - bytesWritten || diffLength > resultSize - bytesWritten - extraLength ||
+			baseOffset > baseSize || diffLength > baseSize - baseOffset)
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("The firmware delta contains an invalid record."));
+			success = false;
+			break;
+		}
+
+		for (uint32_t i = 0; i < extraLength && success; i += chunkSize)
+		{
+			const size_t length = extraLength - i < chunkSize ? extraLength - i : chunkSize;
+			success = TesLight::Updater::readDeltaData(tupFile, buffer, length, remaining) && Update.write(buffer, length) == length;
+			mbedtls_sha256_update_ret(&shaContext, buffer, length);
+		}
+
+		for (uint32_t i = 0; i < diffLength && success; i += chunkSize)
+		{
+			const size_t length = diffLength - i < chunkSize ? diffLength - i : chunkSize;
+			success = TesLight::Updater::readDeltaData(tupFile, buffer, length, remaining) && esp_partition_read(basePartition, baseOffset + i, baseBuffer, length) == ESP_OK;
+			for (size_t j = 0; j < length && success; j++)
+			{
+				buffer[j] += baseBuffer[j];
+			}
+			success = success && Update.write(buffer, length) == length;
+			mbedtls_sha256_update_ret(&shaContext, buffer, length);
+		}
+
+		bytesWritten += extraLength + diffLength;
+	}
+
+	uint8_t hash[32];
+	mbedtls_sha256_finish_ret(&shaContext, hash);
+	mbedtls_sha256_free(&shaContext);
+
+	if (!success)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to write the firmware: ") + String(Update.getError()));
 		return false;
 	}
-	firmware.close();
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Update procedure ended."));
+	else if (remaining != 0 || memcmp(hash, resultHash, sizeof(hash)) != 0)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("The SHA-256 of the resulting firmware does not match."));
+		return false;
+	}
+
+	return true;
+}
 
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Checking for errors."));
-	if (!Update.isFinished())
+/**
+ * @brief Verify the SHA-256 of the beginning of a flash partition.
+ * @param partition partition to verify
+ * @param size number of bytes to verify
+ * @param hash expected SHA-256
+ * @param buffer buffer of size {@link UPDATE_BUFFER_SIZE}
+ * @return true when the hash matches
+ * @return false when the hash does not match or the partition could not be read
+ */
+bool TesLight::Updater::verifyPartition(const esp_partition_t *partition, const uint32_t size, const uint8_t *hash, uint8_t *buffer)
+{
+	mbedtls_sha256_context shaContext;
+	mbedtls_sha256_init(&shaContext);
+	mbedtls_sha256_starts_ret(&shaContext, 0);
+
+	bool success = true;
+	for (uint32_t i = 0; i < size && success; i += UPDATE_BUFFER_SIZE)
+	{
+		const size_t length = size - i < UPDATE_BUFFER_SIZE ? size - i : UPDATE_BUFFER_SIZE;
+		success = esp_partition_read(partition, i, buffer, length) == ESP_OK;
+		mbedtls_sha256_update_ret(&shaContext, buffer, length);
+	}
+
+	uint8_t partitionHash[32];
+	mbedtls_sha256_finish_ret(&shaContext, partitionHash);
+	mbedtls_sha256_free(&shaContext);
+	return success && memcmp(partitionHash, hash, sizeof(partitionHash)) == 0;
+}
+
+/**
+ * @brief Read data of a firmware delta block and make sure it does not exceed the block.
+ * @param tupFile opened TUP file
+ * @param buffer buffer for the data
+ * @param size number of bytes to read
+ * @param remaining remaining bytes of the data block, reduced by the number of read bytes
+ * @return true when successful
+ * @return false when the block is too small or there was an error reading
+ */
+bool TesLight::Updater::readDeltaData(TesLight::TupFile &tupFile, uint8_t *buffer, const size_t size, uint32_t &remaining)
+{
+	if (size > remaining || !tupFile.readData(buffer, size))
 	{
-		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Found the following error: ") + String(Update.getError()));
 		return false;
 	}
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("No errors found."));
+	remaining -= size;
+	return true;
+}
+
+/**
+ * @brief Unpack a file block from the TUP file into the staging directory.
+ * @param fileSystem file system to which the file is unpacked
+ * @param tupFile opened TUP file
+ * @param dataBlock file data block
+ * @param buffer buffer of size {@link UPDATE_BUFFER_SIZE}
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::Updater::unpackFile(FS *fileSystem, TesLight::TupFile &tupFile, const TesLight::TupFile::TupDataBlock &dataBlock, uint8_t *buffer)
+{
+	const String path = tupFile.createAbsolutePath((String)UPDATE_STAGING_DIRECTORY + F("/"), dataBlock);
+	File file = fileSystem->open(path, FILE_WRITE);
+	if (!file)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to write file \"") + path + F("\"."));
+		return false;
+	}
+
+	uint32_t bytesProcessed = 0;
+	while (bytesProcessed < dataBlock.size)
+	{
+		const size_t chunkSize = dataBlock.size - bytesProcessed < UPDATE_BUFFER_SIZE ? dataBlock.size - bytesProcessed : UPDATE_BUFFER_SIZE;
+		if (!tupFile.readData(buffer, chunkSize) || file.write(buffer, chunkSize) != chunkSize)
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to write file \"") + path + F("\"."));
+			file.close();
+			return false;
+		}
+		bytesProcessed += chunkSize;
+	}
 
-	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Firmware update successful."));
+	file.close();
 	return true;
 }
+
+/**
+ * @brief Remove the old files from the root directory and move the staged files into it.
+ * Protected files and directories like the configuration, log and fseq files are kept.
+ * @param fileSystem file system containing the staging directory
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::Updater::swapStagedFiles(FS *fileSystem)
+{
+	if (!TesLight::FileUtil::clearRoot(fileSystem))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to clean file system root."));
+		return false;
+	}
+
+	bool success = true;
+	uint16_t fileCount = 0;
+	TesLight::FileUtil::countFiles(fileSystem, UPDATE_STAGING_DIRECTORY, fileCount, true);
+	for (uint16_t i = 0; i < fileCount;)
+	{
+		String name;
+		if (!TesLight::FileUtil::getFileNameFromIndex(fileSystem, UPDATE_STAGING_DIRECTORY, i, name, true) || name.length() == 0)
+		{
+			return false;
+		}
+
+		if (fileSystem->rename((String)UPDATE_STAGING_DIRECTORY + F("/") + name, (String)F("/") + name))
+		{
+			fileCount--;
+		}
+		else
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to move \"") + name + F("\" into the root directory."));
+			success = false;
+			i++;
+		}
+	}
+
+	TesLight::FileUtil::deleteDirectory(fileSystem, UPDATE_STAGING_DIRECTORY, true);
+	return success;
+}
+
+/**
+ * @brief Abort a failed update. The firmware update is cancelled and the staged files and the package are deleted.
+ * @param fileSystem file system containing the staging directory and package
+ * @param packageFileName full path and name of the package file
+ */
+void TesLight::Updater::abort(FS *fileSystem, const String packageFileName)
+{
+	if (Update.isRunning())
+	{
+		Update.abort();
+	}
+	TesLight::FileUtil::deleteDirectory(fileSystem, UPDATE_STAGING_DIRECTORY, true);
+	fileSystem->remove(packageFileName);
+}
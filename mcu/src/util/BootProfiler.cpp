@@ -0,0 +1,82 @@
+/**
+ * @file BootProfiler.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the {@link TesLight::BootProfiler}.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "util/BootProfiler.h"
+
+// Initialize
+const __FlashStringHelper *TesLight::BootProfiler::stageName[BOOT_PROFILER_MAX_STAGES];
+unsigned long TesLight::BootProfiler::stageStart[BOOT_PROFILER_MAX_STAGES];
+unsigned long TesLight::BootProfiler::stageDuration[BOOT_PROFILER_MAX_STAGES];
+uint8_t TesLight::BootProfiler::stageCount = 0;
+unsigned long TesLight::BootProfiler::firstFrameTime = 0;
+portMUX_TYPE TesLight::BootProfiler::lock = portMUX_INITIALIZER_UNLOCKED;
+
+/**
+ * @brief Record a finished boot stage. Stages can be recorded from multiple tasks.
+ * @param stage name of the stage
+ * @param start time in µs when the stage was started
+ */
+void TesLight::BootProfiler::record(const __FlashStringHelper *stage, const unsigned long start)
+{
+	const unsigned long duration = micros() - start;
+
+	portENTER_CRITICAL(&lock);
+	if (stageCount < BOOT_PROFILER_MAX_STAGES)
+	{
+		stageName[stageCount] = stage;
+		stageStart[stageCount] = start;
+		stageDuration[stageCount] = duration;
+		stageCount++;
+	}
+	portEXIT_CRITICAL(&lock);
+
+	TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, (String)F("Boot stage '") + stage + F("' took ") + String(duration) + F("µs."));
+}
+
+/**
+ * @brief Mark that the first LED frame was shown. Only the first call is recorded.
+ */
+void TesLight::BootProfiler::markFirstFrame()
+{
+	if (firstFrameTime == 0)
+	{
+		firstFrameTime = micros();
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("First LED frame shown after ") + String(firstFrameTime) + F("µs."));
+	}
+}
+
+/**
+ * @brief Get the time from power on to the first LED frame.
+ * @return time in µs or 0 when no frame was shown yet
+ */
+unsigned long TesLight::BootProfiler::getTimeToFirstFrame()
+{
+	return firstFrameTime;
+}
+
+/**
+ * @brief Log all recorded boot stages with their start time and duration.
+ */
+void TesLight::BootProfiler::printSummary()
+{
+	portENTER_CRITICAL(&lock);
+	const uint8_t count = stageCount;
+	portEXIT_CRITICAL(&lock);
+
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Boot profile:"));
+	for (uint8_t i = 0; i < count; i++)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("  ") + stageName[i] + F(": started at ") + String(stageStart[i]) + F("µs, took ") + String(stageDuration[i]) + F("µs"));
+	}
+
+	if (firstFrameTime != 0)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("  Time to first frame: ") + String(firstFrameTime) + F("µs"));
+	}
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("  Boot completed after ") + String(micros()) + F("µs"));
+}
@@ -77,6 +77,19 @@ bool TesLight::FileUtil::getFileIdentifier(FS *fileSystem, const String fileName
 		return false;
 	}
 
+	TesLight::FileUtil::getFileIdentifier(file, fileName, identifier);
+	file.close();
+	return true;
+}
+
+/**
+ * @brief Calculate a identifier for an already opened file based on it's properties and content.
+ * @param file opened file
+ * @param fileName full path and name of the file
+ * @param identifier reference to the variable holding the identifier
+ */
+void TesLight::FileUtil::getFileIdentifier(File &file, const String fileName, uint32_t &identifier)
+{
 	identifier = 7;
 	for (uint16_t i = 0; i < fileName.length(); i++)
 	{
@@ -84,9 +97,6 @@ bool TesLight::FileUtil::getFileIdentifier(FS *fileSystem, const String fileName
 	}
 	identifier = identifier * 31 + file.size();
 	identifier = identifier * 31 + file.getLastWrite();
-
-	file.close();
-	return true;
 }
 
 /**
@@ -321,7 +331,7 @@ bool TesLight::FileUtil::deleteDirectory(FS *fileSystem, const String directory,
 		}
 		name = directory == F("/") ? (String)F("/") + name : directory + F("/") + name;
 
-		if (name == LOG_FILE_NAME || name == CONFIGURATION_FILE_NAME || name == FSEQ_DIRECTORY || name == UPDATE_DIRECTORY)
+		if (name == LOG_FILE_NAME || name == CONFIGURATION_FILE_NAME || name == CONFIGURATION_BACKUP_FILE_NAME || name == FSEQ_INDEX_FILE_NAME || name == FSEQ_DIRECTORY || name == UPDATE_DIRECTORY || name == SENSOR_RECORDING_DIRECTORY || name == UPLOAD_SESSION_DIRECTORY)
 		{
 			continue;
 		}
@@ -0,0 +1,490 @@
+/**
+ * @file FseqIndex.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the {@link TesLight::FseqIndex}.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "util/FseqIndex.h"
+
+/**
+ * @brief Create a new instance of {@link TesLight::FseqIndex}.
+ * @param fileSystem file system containing the fseq files and the index file
+ * @param directory directory containing the fseq files
+ * @param indexFileName full path and name of the index file
+ */
+TesLight::FseqIndex::FseqIndex(FS *fileSystem, const String directory, const String indexFileName)
+{
+	this->fileSystem = fileSystem;
+	this->directory = directory;
+	this->indexFileName = indexFileName;
+	this->entries = nullptr;
+	this->entryCount = 0;
+	this->entryCapacity = 0;
+	this->directoryDigest = 0;
+}
+
+/**
+ * @brief Destroy the {@link TesLight::FseqIndex}.
+ */
+TesLight::FseqIndex::~FseqIndex()
+{
+	this->clear();
+}
+
+/**
+ * @brief Load the index from the index file. When the file is missing or invalid, the index is rebuilt.
+ * The index is also rebuilt when the names or sizes of the files in the fseq directory changed since the index was saved,
+ * for example because files were copied to the SD card or deleted from it.
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::FseqIndex::load()
+{
+	this->clear();
+
+	File file = this->fileSystem->open(this->indexFileName, FILE_READ);
+	if (!file || file.isDirectory() || file.size() < 8)
+	{
+		if (file)
+		{
+			file.close();
+		}
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Fseq index file not found. Rebuilding index."));
+		return this->rebuild();
+	}
+
+	const size_t size = file.size();
+	uint8_t *buffer = new uint8_t[size];
+	const size_t bytesRead = file.read(buffer, size);
+	file.close();
+
+	uint32_t crc = 0;
+	memcpy(&crc, buffer + size - sizeof(crc), sizeof(crc));
+	if (bytesRead != size || crc != crc32_le(0, buffer, size - sizeof(crc)))
+	{
+		delete[] buffer;
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Fseq index file is corrupted. Rebuilding index."));
+		return this->rebuild();
+	}
+
+	TesLight::InMemoryBinaryFile binary(size - sizeof(crc));
+	binary.loadFrom(buffer, size - sizeof(crc));
+	delete[] buffer;
+
+	uint16_t version = 0;
+	uint16_t count = 0;
+	uint32_t digest = 0;
+	binary.read(version);
+	if (version != FSEQ_INDEX_VERSION)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Fseq index file has an incompatible version. Rebuilding index."));
+		return this->rebuild();
+	}
+
+	binary.read(digest);
+	binary.read(count);
+	if (!this->getDirectoryDigest(this->directoryDigest) || digest != this->directoryDigest)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("The fseq directory was changed. Rebuilding index."));
+		return this->rebuild();
+	}
+
+	for (uint16_t i = 0; i < count; i++)
+	{
+		TesLight::FseqIndex::FseqIndexEntry entry;
+		if (!binary.readString(entry.fileName) || !binary.read(entry.identifier) || !binary.read(entry.fileSize) || !binary.read(entry.channelCount) || !binary.read(entry.frameCount) || !binary.read(entry.stepTime))
+		{
+			TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, F("Fseq index file is invalid. Rebuilding index."));
+			return this->rebuild();
+		}
+		this->insert(entry);
+	}
+
+	TesLight::Logger::log(TesLight::Logger::LogLevel::DEBUG, SOURCE_LOCATION, (String)F("Fseq index loaded with ") + String(this->entryCount) + F(" entries."));
+	return true;
+}
+
+/**
+ * @brief Rebuild the index by scanning the fseq directory once and save it to the index file.
+ * The digest of the directory is calculated during the same scan.
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::FseqIndex::rebuild()
+{
+	this->clear();
+
+	File dir = this->fileSystem->open(this->directory, FILE_READ);
+	if (!dir)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to open the fseq directory."));
+		return false;
+	}
+	else if (!dir.isDirectory())
+	{
+		dir.close();
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to open the fseq directory because it is a file."));
+		return false;
+	}
+
+	this->directoryDigest = 0;
+	bool hasNext = true;
+	while (hasNext)
+	{
+		File file = dir.openNextFile(FILE_READ);
+		if (file)
+		{
+			TesLight::FseqIndex::FseqIndexEntry entry;
+			if (!file.isDirectory())
+			{
+				const String fileName = file.name();
+				const uint32_t fileSize = file.size();
+				this->directoryDigest = crc32_le(this->directoryDigest, (const uint8_t *)fileName.c_str(), fileName.length());
+				this->directoryDigest = crc32_le(this->directoryDigest, (const uint8_t *)&fileSize, sizeof(fileSize));
+				if (this->readEntry(file, entry))
+				{
+					this->insert(entry);
+				}
+			}
+			file.close();
+		}
+		else
+		{
+			hasNext = false;
+		}
+	}
+
+	dir.close();
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("Fseq index rebuilt with ") + String(this->entryCount) + F(" entries."));
+	return this->save();
+}
+
+/**
+ * @brief Add a file from the fseq directory to the index and save the index.
+ * @param fileName name of the file without the directory
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::FseqIndex::add(const String fileName)
+{
+	File file = this->fileSystem->open(this->directory + F("/") + fileName, FILE_READ);
+	if (!file)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to open fseq file ") + fileName + F(" to add it to the index."));
+		return false;
+	}
+
+	TesLight::FseqIndex::FseqIndexEntry entry;
+	const bool valid = !file.isDirectory() && this->readEntry(file, entry);
+	file.close();
+	if (!valid)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to read fseq file ") + fileName + F(" to add it to the index."));
+		return false;
+	}
+
+	this->remove(fileName);
+	this->getDirectoryDigest(this->directoryDigest);
+	return this->insert(entry) && this->save();
+}
+
+/**
+ * @brief Remove a file from the index and save the index.
+ * @param fileName name of the file without the directory
+ * @return true when the file was removed
+ * @return false when the file was not found or the index could not be saved
+ */
+bool TesLight::FseqIndex::remove(const String fileName)
+{
+	for (uint16_t i = 0; i < this->entryCount; i++)
+	{
+		if (this->entries[i].fileName == fileName)
+		{
+			for (uint16_t j = i; j < this->entryCount - 1; j++)
+			{
+				this->entries[j] = this->entries[j + 1];
+			}
+			this->entryCount--;
+			this->getDirectoryDigest(this->directoryDigest);
+			return this->save();
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief Get the number of files in the index.
+ * @return number of files
+ */
+uint16_t TesLight::FseqIndex::getEntryCount()
+{
+	return this->entryCount;
+}
+
+/**
+ * @brief Get an entry of the index by the file identifier.
+ * @param identifier identifier of the file
+ * @param entry reference variable holding the entry
+ * @return true when the entry was found
+ * @return false when there is no file with this identifier
+ */
+bool TesLight::FseqIndex::getEntry(const uint32_t identifier, TesLight::FseqIndex::FseqIndexEntry &entry)
+{
+	const int32_t index = this->find(identifier);
+	if (index < 0)
+	{
+		return false;
+	}
+
+	entry = this->entries[index];
+	return true;
+}
+
+/**
+ * @brief Get the name of a file by the file identifier.
+ * @param identifier identifier of the file
+ * @param fileName reference variable holding the name of the file without the directory
+ * @return true when the file was found
+ * @return false when there is no file with this identifier
+ */
+bool TesLight::FseqIndex::getFileName(const uint32_t identifier, String &fileName)
+{
+	const int32_t index = this->find(identifier);
+	if (index < 0)
+	{
+		fileName.clear();
+		return false;
+	}
+
+	fileName = this->entries[index].fileName;
+	return true;
+}
+
+/**
+ * @brief Get a list of all indexed files with their size and identifier. The list is in the same format as
+ * {@link TesLight::FileUtil::getFileList}.
+ * @return list of files
+ */
+String TesLight::FseqIndex::getFileList()
+{
+	String fileList;
+	for (uint16_t i = 0; i < this->entryCount; i++)
+	{
+		if (i > 0)
+		{
+			fileList += F("\n");
+		}
+		fileList += this->entries[i].fileName + F(";");
+		fileList += String(this->entries[i].fileSize) + F(";");
+		fileList += String(this->entries[i].identifier);
+	}
+	return fileList;
+}
+
+/**
+ * @brief Write the index to the index file with a single write.
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::FseqIndex::save()
+{
+	size_t size = 2 * sizeof(uint16_t) + 2 * sizeof(uint32_t);
+	for (uint16_t i = 0; i < this->entryCount; i++)
+	{
+		size += sizeof(uint16_t) + this->entries[i].fileName.length() + 4 * sizeof(uint32_t) + sizeof(uint8_t);
+	}
+
+	TesLight::InMemoryBinaryFile binary(size);
+	binary.write((uint16_t)FSEQ_INDEX_VERSION);
+	binary.write(this->directoryDigest);
+	binary.write(this->entryCount);
+	for (uint16_t i = 0; i < this->entryCount; i++)
+	{
+		binary.writeString(this->entries[i].fileName);
+		binary.write(this->entries[i].identifier);
+		binary.write(this->entries[i].fileSize);
+		binary.write(this->entries[i].channelCount);
+		binary.write(this->entries[i].frameCount);
+		binary.write(this->entries[i].stepTime);
+	}
+	binary.write(crc32_le(0, binary.getData(), binary.getBytesWritten()));
+
+	File file = this->fileSystem->open(this->indexFileName, FILE_WRITE);
+	if (!file)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to open the fseq index file."));
+		return false;
+	}
+
+	const size_t bytesWritten = file.write(binary.getData(), binary.getBytesWritten());
+	file.close();
+	if (bytesWritten != size)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to write the fseq index file."));
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Calculate a digest over the names and sizes of all files in the fseq directory. The files are not read,
+ * so this is much cheaper than a rebuild of the index.
+ * @param digest reference variable holding the digest
+ * @return true when successful
+ * @return false when the directory could not be opened
+ */
+bool TesLight::FseqIndex::getDirectoryDigest(uint32_t &digest)
+{
+	digest = 0;
+	File dir = this->fileSystem->open(this->directory, FILE_READ);
+	if (!dir || !dir.isDirectory())
+	{
+		if (dir)
+		{
+			dir.close();
+		}
+		return false;
+	}
+
+	bool hasNext = true;
+	while (hasNext)
+	{
+		File file = dir.openNextFile(FILE_READ);
+		if (file)
+		{
+			if (!file.isDirectory())
+			{
+				const String fileName = file.name();
+				const uint32_t fileSize = file.size();
+				digest = crc32_le(digest, (const uint8_t *)fileName.c_str(), fileName.length());
+				digest = crc32_le(digest, (const uint8_t *)&fileSize, sizeof(fileSize));
+			}
+			file.close();
+		}
+		else
+		{
+			hasNext = false;
+		}
+	}
+
+	dir.close();
+	return true;
+}
+
+/**
+ * @brief Create an index entry from an opened file by reading the fseq header.
+ * @param file opened fseq file
+ * @param entry reference variable holding the entry
+ * @return true when successful
+ * @return false when the file is not a fseq file
+ */
+bool TesLight::FseqIndex::readEntry(File &file, TesLight::FseqIndex::FseqIndexEntry &entry)
+{
+	uint8_t header[28];
+	if (file.size() < sizeof(header) || file.read(header, sizeof(header)) != sizeof(header) || memcmp(header, "PSEQ", 4) != 0)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::WARN, SOURCE_LOCATION, (String)F("File ") + file.name() + F(" is not a fseq file and will not be indexed."));
+		return false;
+	}
+
+	entry.fileName = file.name();
+	if (entry.fileName.lastIndexOf('/') >= 0)
+	{
+		entry.fileName = entry.fileName.substring(entry.fileName.lastIndexOf('/') + 1);
+	}
+
+	TesLight::FileUtil::getFileIdentifier(file, this->directory + F("/") + entry.fileName, entry.identifier);
+	entry.fileSize = file.size();
+	memcpy(&entry.channelCount, &header[10], sizeof(entry.channelCount));
+	memcpy(&entry.frameCount, &header[14], sizeof(entry.frameCount));
+	entry.stepTime = header[18];
+	return true;
+}
+
+/**
+ * @brief Insert an entry into the index, keeping the entries sorted by their identifier.
+ * @param entry entry to insert
+ * @return true when successful
+ * @return false when an entry with the same identifier exists
+ */
+bool TesLight::FseqIndex::insert(const TesLight::FseqIndex::FseqIndexEntry &entry)
+{
+	if (this->entryCount == this->entryCapacity)
+	{
+		this->entryCapacity = this->entryCapacity == 0 ? FSEQ_INDEX_INITIAL_CAPACITY : this->entryCapacity * 2;
+		TesLight::FseqIndex::FseqIndexEntry *newEntries = new TesLight::FseqIndex::FseqIndexEntry[this->entryCapacity];
+		for (uint16_t i = 0; i < this->entryCount; i++)
+		{
+			newEntries[i] = this->entries[i];
+		}
+		delete[] this->entries;
+		this->entries = newEntries;
+	}
+
+	uint16_t position = this->entryCount;
+	while (position > 0 && this->entries[position - 1].identifier > entry.identifier)
+	{
+		this->entries[position] = this->entries[position - 1];
+		position--;
+	}
+
+	if (position > 0 && this->entries[position - 1].identifier == entry.identifier)
+	{
+		for (uint16_t i = position; i < this->entryCount; i++)
+		{
+			this->entries[i] = this->entries[i + 1];
+		}
+		return false;
+	}
+
+	this->entries[position] = entry;
+	this->entryCount++;
+	return true;
+}
+
+/**
+ * @brief Find an entry by its identifier using a binary search.
+ * @param identifier identifier of the file
+ * @return index of the entry or -1 when not found
+ */
+int32_t TesLight::FseqIndex::find(const uint32_t identifier)
+{
+	int32_t low = 0;
+	int32_t high = (int32_t)this->entryCount - 1;
+	while (low <= high)
+	{
+		const int32_t middle = low + (high - low) / 2;
+		if (this->entries[middle].identifier == identifier)
+		{
+			return middle;
+		}
+		else if (this->entries[middle].identifier < identifier)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle - 1;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * @brief Remove all entries from the index in memory.
+ */
+void TesLight::FseqIndex::clear()
+{
+	if (this->entries != nullptr)
+	{
+		delete[] this->entries;
+		this->entries = nullptr;
+	}
+	this->entryCount = 0;
+	this->entryCapacity = 0;
+}
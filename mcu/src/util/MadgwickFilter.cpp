@@ -0,0 +1,167 @@
+/**
+ * @file MadgwickFilter.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the {@link TesLight::MadgwickFilter}.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "util/MadgwickFilter.h"
+
+/**
+ * @brief Create a new instance of {@link TesLight::MadgwickFilter}.
+ * @param beta gain of the acceleration correction, higher values trust the acceleration more
+ * @param biasRate rate at which the gyro bias is learned while the sensor is at rest, 0 to disable
+ */
+TesLight::MadgwickFilter::MadgwickFilter(const float beta, const float biasRate)
+{
+	this->beta = beta;
+	this->biasRate = biasRate;
+	this->reset();
+}
+
+/**
+ * @brief Delete the {@link TesLight::MadgwickFilter} instance.
+ */
+TesLight::MadgwickFilter::~MadgwickFilter()
+{
+}
+
+/**
+ * @brief Reset the orientation and the learned gyro bias.
+ */
+void TesLight::MadgwickFilter::reset()
+{
+	this->q0 = 1.0f;
+	this->q1 = 0.0f;
+	this->q2 = 0.0f;
+	this->q3 = 0.0f;
+	this->biasX = 0.0f;
+	this->biasY = 0.0f;
+	this->biasZ = 0.0f;
+}
+
+/**
+ * @brief Update the orientation with a new sample.
+ * While the sensor is at rest, the remaining gyro bias is learned, which limits the drift around the z axis.
+ * @param gyroX rotation around the x axis in rad/s
+ * @param gyroY rotation around the y axis in rad/s
+ * @param gyroZ rotation around the z axis in rad/s
+ * @param accX acceleration on the x axis in any unit
+ * @param accY acceleration on the y axis in any unit
+ * @param accZ acceleration on the z axis in any unit
+ * @param timeStep time since the previous sample in seconds
+ */
+void TesLight::MadgwickFilter::update(float gyroX, float gyroY, float gyroZ, float accX, float accY, float accZ, const float timeStep)
+{
+	const float accNormSquared = accX * accX + accY * accY + accZ * accZ;
+	const float gyroNormSquared = gyroX * gyroX + gyroY * gyroY + gyroZ * gyroZ;
+
+	// Learn the gyro bias while the sensor is at rest (less than ~3°/s and ~1G)
+	if (this->biasRate > 0.0f && gyroNormSquared < 0.0025f && fabsf(accNormSquared - 1.0f) < 0.1f)
+	{
+		this->biasX += (gyroX - this->biasX) * this->biasRate;
+		this->biasY += (gyroY - this->biasY) * this->biasRate;
+		this->biasZ += (gyroZ - this->biasZ) * this->biasRate;
+	}
+	gyroX -= this->biasX;
+	gyroY -= this->biasY;
+	gyroZ -= this->biasZ;
+
+	// Rate of change of the quaternion from the gyro
+	float qDot0 = 0.5f * (-this->q1 * gyroX - this->q2 * gyroY - this->q3 * gyroZ);
+	float qDot1 = 0.5f * (this->q0 * gyroX + this->q2 * gyroZ - this->q3 * gyroY);
+	float qDot2 = 0.5f * (this->q0 * gyroY - this->q1 * gyroZ + this->q3 * gyroX);
+	float qDot3 = 0.5f * (this->q0 * gyroZ + this->q1 * gyroY - this->q2 * gyroX);
+
+	// Gradient descent step towards the measured gravity
+	if (accNormSquared > 0.0f)
+	{
+		const float accNormInv = 1.0f / sqrtf(accNormSquared);
+		accX *= accNormInv;
+		accY *= accNormInv;
+		accZ *= accNormInv;
+
+		const float _2q0 = 2.0f * this->q0;
+		const float _2q1 = 2.0f * this->q1;
+		const float _2q2 = 2.0f * this->q2;
+		const float _2q3 = 2.0f * this->q3;
+		const float _4q0 = 4.0f * this->q0;
+		const float _4q1 = 4.0f * this->q1;
+		const float _4q2 = 4.0f * this->q2;
+		const float _8q1 = 8.0f * this->q1;
+		const float _8q2 = 8.0f * this->q2;
+		const float q0q0 = this->q0 * this->q0;
+		const float q1q1 = this->q1 * this->q1;
+		const float q2q2 = this->q2 * this->q2;
+		const float q3q3 = this->q3 * this->q3;
+
+		float s0 = _4q0 * q2q2 + _2q2 * accX + _4q0 * q1q1 - _2q1 * accY;
+		float s1 = _4q1 * q3q3 - _2q3 * accX + 4.0f * q0q0 * this->q1 - _2q0 * accY - _4q1 + _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * accZ;
+		float s2 = 4.0f * q0q0 * this->q2 + _2q0 * accX + _4q2 * q3q3 - _2q3 * accY - _4q2 + _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * accZ;
+		float s3 = 4.0f * q1q1 * this->q3 - _2q1 * accX + 4.0f * q2q2 * this->q3 - _2q2 * accY;
+
+		const float sNormSquared = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+		if (sNormSquared > 0.0f)
+		{
+			const float sNormInv = 1.0f / sqrtf(sNormSquared);
+			qDot0 -= this->beta * s0 * sNormInv;
+			qDot1 -= this->beta * s1 * sNormInv;
+			qDot2 -= this->beta * s2 * sNormInv;
+			qDot3 -= this->beta * s3 * sNormInv;
+		}
+	}
+
+	// Integrate and normalize the quaternion
+	this->q0 += qDot0 * timeStep;
+	this->q1 += qDot1 * timeStep;
+	this->q2 += qDot2 * timeStep;
+	this->q3 += qDot3 * timeStep;
+
+	const float qNormInv = 1.0f / sqrtf(this->q0 * this->q0 + this->q1 * this->q1 + this->q2 * this->q2 + this->q3 * this->q3);
+	this->q0 *= qNormInv;
+	this->q1 *= qNormInv;
+	this->q2 *= qNormInv;
+	this->q3 *= qNormInv;
+}
+
+/**
+ * @brief Get the direction of the gravity in the sensor frame, with a length of 1.
+ * @param gravityX x component of the gravity
+ * @param gravityY y component of the gravity
+ * @param gravityZ z component of the gravity
+ */
+void TesLight::MadgwickFilter::getGravity(float &gravityX, float &gravityY, float &gravityZ)
+{
+	gravityX = 2.0f * (this->q1 * this->q3 - this->q0 * this->q2);
+	gravityY = 2.0f * (this->q0 * this->q1 + this->q2 * this->q3);
+	gravityZ = this->q0 * this->q0 - this->q1 * this->q1 - this->q2 * this->q2 + this->q3 * this->q3;
+}
+
+/**
+ * @brief Get the rotation around the x axis.
+ * @return float rotation in degree
+ */
+float TesLight::MadgwickFilter::getRotationX()
+{
+	return atan2f(this->q0 * this->q1 + this->q2 * this->q3, 0.5f - this->q1 * this->q1 - this->q2 * this->q2) * 57.29578f;
+}
+
+/**
+ * @brief Get the rotation around the y axis.
+ * @return float rotation in degree
+ */
+float TesLight::MadgwickFilter::getRotationY()
+{
+	const float value = -2.0f * (this->q1 * this->q3 - this->q0 * this->q2);
+	return asinf(value < -1.0f ? -1.0f : value > 1.0f ? 1.0f : value) * 57.29578f;
+}
+
+/**
+ * @brief Get the rotation around the z axis.
+ * @return float rotation in degree
+ */
+float TesLight::MadgwickFilter::getRotationZ()
+{
+	return atan2f(this->q1 * this->q2 + this->q0 * this->q3, 0.5f - this->q2 * this->q2 - this->q3 * this->q3) * 57.29578f;
+}
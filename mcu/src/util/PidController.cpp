@@ -0,0 +1,78 @@
+/**
+ * @file PidController.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the {@link TesLight::PidController}.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "util/PidController.h"
+
+/**
+ * @brief Create a new instance of {@link TesLight::PidController}.
+ * @param kp proportional gain
+ * @param ki integral gain per second
+ * @param kd derivative gain in seconds
+ * @param outputMin minimum output value
+ * @param outputMax maximum output value
+ */
+TesLight::PidController::PidController(const float kp, const float ki, const float kd, const float outputMin, const float outputMax)
+{
+	this->kp = kp;
+	this->ki = ki;
+	this->kd = kd;
+	this->outputMin = outputMin;
+	this->outputMax = outputMax;
+	this->reset();
+}
+
+/**
+ * @brief Delete the {@link TesLight::PidController} instance.
+ */
+TesLight::PidController::~PidController()
+{
+}
+
+/**
+ * @brief Reset the integral and derivative state of the controller.
+ */
+void TesLight::PidController::reset()
+{
+	this->integral = 0.0f;
+	this->lastError = 0.0f;
+	this->initialized = false;
+}
+
+/**
+ * @brief Calculate the next output value of the controller.
+ * The error is only integrated when the output is not saturated or when the integration moves it back into range.
+ * This prevents the integral from winding up while the output is at its limit.
+ * @param error difference between the measured and the desired value
+ * @param timeStep time since the last update in seconds
+ * @return output value between the minimum and maximum
+ */
+float TesLight::PidController::update(const float error, const float timeStep)
+{
+	const float proportional = this->kp * error;
+	const float derivative = this->initialized && timeStep > 0.0f ? this->kd * (error - this->lastError) / timeStep : 0.0f;
+	this->lastError = error;
+	this->initialized = true;
+
+	const float integral = this->integral + this->ki * error * timeStep;
+	const float output = proportional + integral + derivative;
+	if ((output < this->outputMax || error < 0.0f) && (output > this->outputMin || error > 0.0f))
+	{
+		this->integral = integral;
+	}
+
+	const float limited = proportional + this->integral + derivative;
+	if (limited < this->outputMin)
+	{
+		return this->outputMin;
+	}
+	else if (limited > this->outputMax)
+	{
+		return this->outputMax;
+	}
+	return limited;
+}
@@ -0,0 +1,348 @@
+/**
+ * @file StreamReceiver.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the {@link TesLight::StreamReceiver}.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "util/StreamReceiver.h"
+
+/**
+ * @brief Create a new instance of {@link TesLight::StreamReceiver}.
+ * @param channelCount total number of channels (3 per LED) over all zones
+ */
+TesLight::StreamReceiver::StreamReceiver(const uint32_t channelCount)
+{
+	this->channelCount = channelCount;
+	this->enabled = false;
+	this->listening = false;
+	this->ddpPort = STREAM_DDP_PORT;
+	this->e131Port = STREAM_E131_PORT;
+	this->packetBuffer = new uint8_t[STREAM_PACKET_BUFFER_SIZE];
+	this->assemblyBuffer = new uint8_t[channelCount];
+	this->outputBuffer = new uint8_t[channelCount];
+	memset(this->assemblyBuffer, 0, channelCount);
+	memset(this->outputBuffer, 0, channelCount);
+	for (uint8_t i = 0; i < STREAM_JITTER_BUFFER_FRAMES; i++)
+	{
+		this->jitterBuffer[i] = new uint8_t[channelCount];
+	}
+	this->jitterReadIndex = 0;
+	this->jitterFrameCount = 0;
+
+	this->e131UniverseCount = (channelCount + STREAM_E131_UNIVERSE_SIZE - 1) / STREAM_E131_UNIVERSE_SIZE;
+	this->ddpPacketCount = (channelCount + STREAM_DDP_PACKET_PAYLOAD - 1) / STREAM_DDP_PACKET_PAYLOAD;
+	this->e131ReceivedUniverses = 0;
+	this->lastPacketTime = micros();
+	this->receivedFrames = 0;
+	this->droppedFrames = 0;
+}
+
+/**
+ * @brief Destroy the {@link TesLight::StreamReceiver} and close the sockets.
+ */
+TesLight::StreamReceiver::~StreamReceiver()
+{
+	this->end();
+	delete[] this->packetBuffer;
+	delete[] this->assemblyBuffer;
+	delete[] this->outputBuffer;
+	for (uint8_t i = 0; i < STREAM_JITTER_BUFFER_FRAMES; i++)
+	{
+		delete[] this->jitterBuffer[i];
+	}
+}
+
+/**
+ * @brief Start listening for DDP and E1.31 packets.
+ * When the network is not started yet, the sockets are opened as soon as it is available.
+ * @param ddpPort UDP port for DDP packets
+ * @param e131Port UDP port for E1.31 packets
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::StreamReceiver::begin(const uint16_t ddpPort, const uint16_t e131Port)
+{
+	this->end();
+
+	if (this->e131UniverseCount > 32)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, F("Failed to start stream receiver because the channel count exceeds 32 E1.31 universes."));
+		return false;
+	}
+
+	this->ddpPort = ddpPort;
+	this->e131Port = e131Port;
+	this->enabled = true;
+	this->lastPacketTime = micros();
+
+	if (WiFi.getMode() == WIFI_MODE_NULL)
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, F("Network is not started yet. The stream receiver will start listening once it is available."));
+		return true;
+	}
+
+	return this->openSockets();
+}
+
+/**
+ * @brief Stop listening and close the sockets.
+ */
+void TesLight::StreamReceiver::end()
+{
+	if (this->listening)
+	{
+		this->ddpSocket.stop();
+		this->e131Socket.stop();
+		this->listening = false;
+	}
+	this->enabled = false;
+}
+
+/**
+ * @brief Read pending packets from the sockets and assemble them into frames.
+ * At most the packets of one frame are handled per protocol and call, so that a flood of packets can't block the main loop.
+ * The remaining packets are handled on the next call. This should be called as often as possible to avoid packet loss in the network stack.
+ */
+void TesLight::StreamReceiver::receive()
+{
+	if (!this->listening)
+	{
+		if (!this->enabled || WiFi.getMode() == WIFI_MODE_NULL || !this->openSockets())
+		{
+			return;
+		}
+	}
+
+	for (uint32_t i = 0; i < this->ddpPacketCount; i++)
+	{
+		const int packetSize = this->ddpSocket.parsePacket();
+		if (packetSize <= 0)
+		{
+			break;
+		}
+		this->handleDdpPacket(packetSize);
+	}
+
+	for (uint32_t i = 0; i < this->e131UniverseCount; i++)
+	{
+		const int packetSize = this->e131Socket.parsePacket();
+		if (packetSize <= 0)
+		{
+			break;
+		}
+		this->handleE131Packet(packetSize);
+	}
+}
+
+/**
+ * @brief Take the next frame from the jitter buffer and make it the current output frame.
+ * When no new frame is available, the last frame is kept. After a timeout without packets, the output is cleared.
+ */
+void TesLight::StreamReceiver::nextFrame()
+{
+	if (this->jitterFrameCount > 0)
+	{
+		memcpy(this->outputBuffer, this->jitterBuffer[this->jitterReadIndex], this->channelCount);
+		this->jitterReadIndex = (this->jitterReadIndex + 1) % STREAM_JITTER_BUFFER_FRAMES;
+		this->jitterFrameCount--;
+	}
+	else if (micros() - this->lastPacketTime > STREAM_TIMEOUT)
+	{
+		memset(this->outputBuffer, 0, this->channelCount);
+	}
+}
+
+/**
+ * @brief Get the number of channels.
+ * @return total number of channels
+ */
+uint32_t TesLight::StreamReceiver::getChannelCount()
+{
+	return this->channelCount;
+}
+
+/**
+ * @brief Get the number of completely received frames.
+ * @return number of received frames
+ */
+uint32_t TesLight::StreamReceiver::getReceivedFrames()
+{
+	return this->receivedFrames;
+}
+
+/**
+ * @brief Get the number of frames that were dropped because the jitter buffer was full.
+ * @return number of dropped frames
+ */
+uint32_t TesLight::StreamReceiver::getDroppedFrames()
+{
+	return this->droppedFrames;
+}
+
+/**
+ * @brief Read the pixel data of the current output frame.
+ * @param pixelBuffer buffer to which the pixel data is written
+ * @param channelOffset offset of the first channel in the frame
+ * @param bufferSize number of pixels to read
+ * @return true when successful
+ * @return false when the requested range is out of the frame
+ */
+bool TesLight::StreamReceiver::readPixelbuffer(CRGB *pixelBuffer, const uint32_t channelOffset, const size_t bufferSize)
+{
+	if (channelOffset + bufferSize * 3 > this->channelCount)
+	{
+		return false;
+	}
+
+	memcpy((uint8_t *)pixelBuffer, this->outputBuffer + channelOffset, bufferSize * 3);
+	return true;
+}
+
+/**
+ * @brief Open the UDP sockets for DDP and E1.31. The network must be started before.
+ * @return true when successful
+ * @return false when there was an error
+ */
+bool TesLight::StreamReceiver::openSockets()
+{
+	if (!this->ddpSocket.begin(this->ddpPort))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to open UDP socket for DDP on port ") + String(this->ddpPort) + F("."));
+		this->enabled = false;
+		return false;
+	}
+
+	if (!this->e131Socket.begin(this->e131Port))
+	{
+		TesLight::Logger::log(TesLight::Logger::LogLevel::ERROR, SOURCE_LOCATION, (String)F("Failed to open UDP socket for E1.31 on port ") + String(this->e131Port) + F("."));
+		this->ddpSocket.stop();
+		this->enabled = false;
+		return false;
+	}
+
+	TesLight::Logger::log(TesLight::Logger::LogLevel::INFO, SOURCE_LOCATION, (String)F("Listening for DDP on port ") + String(this->ddpPort) + F(" and for E1.31 on port ") + String(this->e131Port) + F("."));
+	this->listening = true;
+	this->lastPacketTime = micros();
+	return true;
+}
+
+/**
+ * @brief Handle a single DDP packet. Data is written to the assembly buffer and a frame is committed when the push flag is set.
+ * @param packetSize size of the received packet
+ */
+void TesLight::StreamReceiver::handleDdpPacket(const size_t packetSize)
+{
+	const size_t length = this->ddpSocket.read(this->packetBuffer, packetSize < STREAM_PACKET_BUFFER_SIZE ? packetSize : STREAM_PACKET_BUFFER_SIZE);
+	if (length < 10)
+	{
+		return;
+	}
+
+	// Byte 0: version (bits 6-7), timecode (0x10), storage (0x08), reply (0x04), query (0x02), push (0x01)
+	const uint8_t flags = this->packetBuffer[0];
+	if ((flags & 0xC0) != 0x40 || (flags & 0x0E) != 0)
+	{
+		return;
+	}
+
+	const size_t headerSize = (flags & 0x10) ? 14 : 10;
+	const uint32_t dataOffset = ((uint32_t)this->packetBuffer[4] << 24) | ((uint32_t)this->packetBuffer[5] << 16) | ((uint32_t)this->packetBuffer[6] << 8) | this->packetBuffer[7];
+	uint32_t dataLength = ((uint32_t)this->packetBuffer[8] << 8) | this->packetBuffer[9];
+	if (headerSize + dataLength > length)
+	{
+		dataLength = length > headerSize ? length - headerSize : 0;
+	}
+
+	if (dataOffset < this->channelCount)
+	{
+		if (dataOffset + dataLength > this->channelCount)
+		{
+			dataLength = this->channelCount - dataOffset;
+		}
+		memcpy(this->assemblyBuffer + dataOffset, this->packetBuffer + headerSize, dataLength);
+	}
+
+	this->lastPacketTime = micros();
+	if (flags & 0x01)
+	{
+		this->commitFrame();
+	}
+}
+
+/**
+ * @brief Handle a single E1.31 data packet. A frame is committed once all universes were received
+ * or when a universe is received a second time before the frame was complete.
+ * @param packetSize size of the received packet
+ */
+void TesLight::StreamReceiver::handleE131Packet(const size_t packetSize)
+{
+	const size_t length = this->e131Socket.read(this->packetBuffer, packetSize < STREAM_PACKET_BUFFER_SIZE ? packetSize : STREAM_PACKET_BUFFER_SIZE);
+	if (length < 126)
+	{
+		return;
+	}
+
+	// Root layer vector must be VECTOR_ROOT_E131_DATA, framing layer vector VECTOR_E131_DATA_PACKET and the DMX start code 0
+	if (memcmp(&this->packetBuffer[4], "ASC-E1.17", 9) != 0 || this->packetBuffer[21] != 0x04 || this->packetBuffer[43] != 0x02 || this->packetBuffer[125] != 0x00)
+	{
+		return;
+	}
+
+	const uint16_t universe = ((uint16_t)this->packetBuffer[113] << 8) | this->packetBuffer[114];
+	if (universe < STREAM_E131_UNIVERSE || universe >= STREAM_E131_UNIVERSE + this->e131UniverseCount)
+	{
+		return;
+	}
+
+	const uint32_t universeIndex = universe - STREAM_E131_UNIVERSE;
+	const uint32_t dataOffset = universeIndex * STREAM_E131_UNIVERSE_SIZE;
+	uint32_t dataLength = (((uint16_t)this->packetBuffer[123] << 8) | this->packetBuffer[124]) - 1;
+	if (dataLength > STREAM_E131_UNIVERSE_SIZE)
+	{
+		dataLength = STREAM_E131_UNIVERSE_SIZE;
+	}
+	if (126 + dataLength > length)
+	{
+		dataLength = length - 126;
+	}
+	if (dataOffset + dataLength > this->channelCount)
+	{
+		dataLength = this->channelCount - dataOffset;
+	}
+
+	// A repeated universe means that parts of the previous frame got lost
+	if (this->e131ReceivedUniverses & (1UL << universeIndex))
+	{
+		this->commitFrame();
+	}
+
+	memcpy(this->assemblyBuffer + dataOffset, this->packetBuffer + 126, dataLength);
+	this->e131ReceivedUniverses |= 1UL << universeIndex;
+	this->lastPacketTime = micros();
+
+	if (this->e131ReceivedUniverses == (this->e131UniverseCount == 32 ? 0xFFFFFFFF : (1UL << this->e131UniverseCount) - 1))
+	{
+		this->commitFrame();
+	}
+}
+
+/**
+ * @brief Copy the assembled frame into the jitter buffer. When the buffer is full, the oldest frame is dropped.
+ */
+void TesLight::StreamReceiver::commitFrame()
+{
+	if (this->jitterFrameCount == STREAM_JITTER_BUFFER_FRAMES)
+	{
+		this->jitterReadIndex = (this->jitterReadIndex + 1) % STREAM_JITTER_BUFFER_FRAMES;
+		this->jitterFrameCount--;
+		this->droppedFrames++;
+	}
+
+	const uint8_t writeIndex = (this->jitterReadIndex + this->jitterFrameCount) % STREAM_JITTER_BUFFER_FRAMES;
+	memcpy(this->jitterBuffer[writeIndex], this->assemblyBuffer, this->channelCount);
+	this->jitterFrameCount++;
+	this->receivedFrames++;
+	this->e131ReceivedUniverses = 0;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file ThermalModel.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the {@link TesLight::ThermalModel}.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "util/ThermalModel.h"
+
+/**
+ * @brief Create a new instance of {@link TesLight::ThermalModel}.
+ * @param thermalResistance temperature rise of the regulators in K per W of LED power
+ * @param timeConstant time in seconds until the regulators reach ~63% of the temperature rise after a power change
+ */
+TesLight::ThermalModel::ThermalModel(const float thermalResistance, const float timeConstant)
+{
+	this->thermalResistance = thermalResistance;
+	this->timeConstant = timeConstant;
+	this->reset();
+}
+
+/**
+ * @brief Delete the {@link TesLight::ThermalModel} instance.
+ */
+TesLight::ThermalModel::~ThermalModel()
+{
+}
+
+/**
+ * @brief Reset the model. It is assumed that the regulators are at ambient temperature.
+ */
+void TesLight::ThermalModel::reset()
+{
+	this->temperature = 0.0f;
+	this->power = 0.0f;
+	this->filteredPower = 0.0f;
+}
+
+/**
+ * @brief Update the model with the measured temperature and the current power draw.
+ * The temperature follows the power draw with a delay, which is modeled by a low pass filter on the power.
+ * @param temperature measured temperature of the regulators in °C
+ * @param power current power draw of the LEDs in W
+ * @param timeStep time since the last update in seconds
+ */
+void TesLight::ThermalModel::update(const float temperature, const float power, const float timeStep)
+{
+	this->temperature = temperature;
+	this->power = power;
+	this->filteredPower += (power - this->filteredPower) * (1.0f - expf(-timeStep / this->timeConstant));
+}
+
+/**
+ * @brief Predict the regulator temperature in the future, assuming the power draw stays the same.
+ * The temperature will move towards the steady state temperature of the current power draw.
+ * @param horizon time in seconds to look ahead
+ * @return predicted temperature in °C
+ */
+float TesLight::ThermalModel::predictTemperature(const float horizon)
+{
+	return this->temperature + (this->power - this->filteredPower) * this->thermalResistance * (1.0f - expf(-horizon / this->timeConstant));
+}
+
+/**
+ * @brief Get the estimated ambient temperature, which is the measured temperature without the rise caused by the LEDs.
+ * @return estimated ambient temperature in °C
+ */
+float TesLight::ThermalModel::getAmbientTemperature()
+{
+	return this->temperature - this->filteredPower * this->thermalResistance;
+}
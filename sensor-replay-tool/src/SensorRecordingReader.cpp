@@ -0,0 +1,163 @@
+/**
+ * @file SensorRecordingReader.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the {@link SensorRecordingReader} class.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "SensorRecordingReader.h"
+
+/**
+ * @brief Create a new instance of {@link SensorRecordingReader}.
+ */
+SensorRecordingReader::SensorRecordingReader()
+{
+	this->accScaleInv = 1.0f;
+	this->gyScaleInv = 1.0f;
+	this->lastMotionTimestamp = 0;
+	this->hasMotionTimestamp = false;
+}
+
+/**
+ * @brief Destroy the {@link SensorRecordingReader} instance and close the recording.
+ */
+SensorRecordingReader::~SensorRecordingReader()
+{
+	this->close();
+}
+
+/**
+ * @brief Open a recording and read its header.
+ * @param fileName path to the recording
+ * @return true when successful
+ * @return false when the file could not be opened or is not a valid recording
+ */
+bool SensorRecordingReader::open(const std::filesystem::path fileName)
+{
+	this->close();
+	this->file.open(fileName, std::ios::binary);
+	if (!this->file.is_open())
+	{
+		return false;
+	}
+
+	TesLight::SensorRecording::FileHeader header;
+	if (!this->file.read((char *)&header, sizeof(header)))
+	{
+		this->close();
+		return false;
+	}
+
+	if (header.magic[0] != 'T' || header.magic[1] != 'L' || header.magic[2] != 'S' || header.magic[3] != 'R' || header.version != SENSOR_RECORDING_VERSION)
+	{
+		this->close();
+		return false;
+	}
+
+	this->accScaleInv = 1.0f / SensorRecordingReader::getAccScaleDiv(header.accScale);
+	this->gyScaleInv = 1.0f / SensorRecordingReader::getGyScaleDiv(header.gyScale);
+	this->hasMotionTimestamp = false;
+	return true;
+}
+
+/**
+ * @brief Close the recording.
+ */
+void SensorRecordingReader::close()
+{
+	if (this->file.is_open())
+	{
+		this->file.close();
+	}
+}
+
+/**
+ * @brief Read the next record from the recording.
+ * @param record reference variable holding the record
+ * @return true when a record was read
+ * @return false when the end of the recording was reached or the last record is incomplete
+ */
+bool SensorRecordingReader::readRecord(TesLight::SensorRecording::Record &record)
+{
+	return this->file.is_open() && this->file.read((char *)&record, sizeof(record));
+}
+
+/**
+ * @brief Convert a motion record into a sample with the same values as if it was read from the MPU6050.
+ * This must be called for all motion records in the order of the recording to get the correct time step.
+ * @param record motion record
+ * @return motion sample
+ */
+SensorRecordingReader::MotionSample SensorRecordingReader::getMotionSample(const TesLight::SensorRecording::Record &record)
+{
+	SensorRecordingReader::MotionSample sample;
+	sample.timestamp = record.timestamp;
+	sample.timeStep = this->hasMotionTimestamp ? (record.timestamp - this->lastMotionTimestamp) / 1000000.0f : 0.0f;
+	sample.accXG = record.data[0] * this->accScaleInv;
+	sample.accYG = record.data[1] * this->accScaleInv;
+	sample.accZG = record.data[2] * this->accScaleInv;
+	sample.gyroXDeg = record.data[3] * this->gyScaleInv;
+	sample.gyroYDeg = record.data[4] * this->gyScaleInv;
+	sample.gyroZDeg = record.data[5] * this->gyScaleInv;
+	sample.temperatureDeg = record.data[6] / 340.0f + 36.53f;
+	this->lastMotionTimestamp = record.timestamp;
+	this->hasMotionTimestamp = true;
+	return sample;
+}
+
+/**
+ * @brief Get the value of a light or temperature record.
+ * @param record light or temperature record
+ * @return brightness in lux or temperature in °C
+ */
+float SensorRecordingReader::getValue(const TesLight::SensorRecording::Record &record)
+{
+	float value = 0.0f;
+	std::memcpy(&value, record.data, sizeof(value));
+	return value;
+}
+
+/**
+ * @brief Get the divider to convert raw acceleration values into g. Matches the MPU6050 driver of the controller.
+ * @param accScale acc scale register value of the MPU6050
+ * @return divider for the raw values
+ */
+float SensorRecordingReader::getAccScaleDiv(const uint8_t accScale)
+{
+	switch (accScale)
+	{
+	case 0B00000000:
+		return 16383.5f;
+	case 0B00001000:
+		return 8191.75f;
+	case 0B00010000:
+		return 4095.875f;
+	case 0B00011000:
+		return 2047.9375f;
+	default:
+		return 1.0f;
+	}
+}
+
+/**
+ * @brief Get the divider to convert raw rotation values into deg/s. Matches the MPU6050 driver of the controller.
+ * @param gyScale gyro scale register value of the MPU6050
+ * @return divider for the raw values
+ */
+float SensorRecordingReader::getGyScaleDiv(const uint8_t gyScale)
+{
+	switch (gyScale)
+	{
+	case 0B00000000:
+		return 131.068f;
+	case 0B00001000:
+		return 65.534f;
+	case 0B00010000:
+		return 32.767f;
+	case 0B00011000:
+		return 16.3835f;
+	default:
+		return 1.0f;
+	}
+}
@@ -0,0 +1,57 @@
+/**
+ * @file SensorRecordingReader.h
+ * @author TheRealKasumi
+ * @brief Contains a class for reading sensor recordings of the TesLight controller on a host.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef SENSOR_RECORDING_READER_H
+#define SENSOR_RECORDING_READER_H
+
+#include <stdint.h>
+#include <string>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+
+#include "sensor/SensorRecording.h"
+
+class SensorRecordingReader
+{
+public:
+	struct MotionSample
+	{
+		uint32_t timestamp;	  // time since the start of the recording in µs
+		float timeStep;		  // time since the previous motion sample in s, 0 for the first sample
+		float accXG;		  // x acceleration in g
+		float accYG;		  // y acceleration in g
+		float accZG;		  // z acceleration in g
+		float gyroXDeg;		  // x rotation in deg/s
+		float gyroYDeg;		  // y rotation in deg/s
+		float gyroZDeg;		  // z rotation in deg/s
+		float temperatureDeg; // temperature of the MPU6050 in °C
+	};
+
+	SensorRecordingReader();
+	~SensorRecordingReader();
+
+	bool open(const std::filesystem::path fileName);
+	void close();
+
+	bool readRecord(TesLight::SensorRecording::Record &record);
+	MotionSample getMotionSample(const TesLight::SensorRecording::Record &record);
+	static float getValue(const TesLight::SensorRecording::Record &record);
+
+private:
+	std::ifstream file;
+	float accScaleInv;
+	float gyScaleInv;
+	uint32_t lastMotionTimestamp;
+	bool hasMotionTimestamp;
+
+	static float getAccScaleDiv(const uint8_t accScale);
+	static float getGyScaleDiv(const uint8_t gyScale);
+};
+
+#endif
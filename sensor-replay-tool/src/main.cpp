@@ -0,0 +1,141 @@
+/**
+ * @file main.cpp
+ * @author TheRealKasumi
+ * @brief Entry point for the TesLight Sensor Replay Tool.
+ * It runs the motion filter of the controller over a sensor recording, so that filter changes can be compared on a host.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <math.h>
+
+#include "configuration/SystemConfiguration.h"
+#include "util/MadgwickFilter.h"
+#include "SensorRecordingReader.h"
+
+// Function declarations
+void rotateToVehicle(float &x, float &y, float &z);
+void printHelp();
+
+/**
+ * @brief Entry point of the application.
+ * @param argc number of command line arguments
+ * @param argv command line argument
+ * @return int status code, 0 for success or the error code otherwise
+ */
+int main(int argc, char *argv[])
+{
+	float calibration[6] = {0.0f};
+	int argument = 1;
+	for (; argument < argc - 2; argument++)
+	{
+		if (std::string(argv[argument]) == "--calibration" && argument + 6 < argc - 2)
+		{
+			for (uint8_t i = 0; i < 6; i++)
+			{
+				calibration[i] = std::stof(argv[++argument]);
+			}
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	if (argc < 3 || argument != argc - 2)
+	{
+		printHelp();
+		exit(1);
+	}
+
+	const std::filesystem::path recordingFile = argv[argc - 2];
+	const std::filesystem::path outputFile = argv[argc - 1];
+	SensorRecordingReader reader;
+	if (!reader.open(recordingFile))
+	{
+		std::cerr << "The recording " << recordingFile << " could not be opened or is not a valid sensor recording." << std::endl;
+		exit(2);
+	}
+
+	std::ofstream output(outputFile);
+	if (!output.is_open())
+	{
+		std::cerr << "The output file " << outputFile << " could not be opened." << std::endl;
+		exit(3);
+	}
+
+	// Process the samples the same way as the motion sensor of the controller
+	TesLight::MadgwickFilter filter(MOTION_SENSOR_FILTER_BETA, MOTION_SENSOR_GYRO_BIAS_RATE);
+	TesLight::SensorRecording::Record record;
+	uint32_t recordCount = 0;
+	output << "type;timestamp;index;pitch;roll;yaw;rollCompensatedAccXG;pitchCompensatedAccYG;value" << std::endl;
+	while (reader.readRecord(record))
+	{
+		recordCount++;
+		if (record.type == TesLight::SensorRecording::RecordType::MOTION)
+		{
+			const SensorRecordingReader::MotionSample sample = reader.getMotionSample(record);
+			float accX = sample.accXG - calibration[0];
+			float accY = sample.accYG - calibration[1];
+			float accZ = sample.accZG - calibration[2];
+			float gyroX = sample.gyroXDeg - calibration[3];
+			float gyroY = sample.gyroYDeg - calibration[4];
+			float gyroZ = sample.gyroZDeg - calibration[5];
+			rotateToVehicle(accX, accY, accZ);
+			rotateToVehicle(gyroX, gyroY, gyroZ);
+
+			filter.update(gyroX * M_PI / 180.0f, gyroY * M_PI / 180.0f, gyroZ * M_PI / 180.0f, accX, accY, accZ, sample.timeStep);
+			float gravityX, gravityY, gravityZ;
+			filter.getGravity(gravityX, gravityY, gravityZ);
+			output << "motion;" << sample.timestamp << ";" << (int)record.index << ";" << filter.getRotationX() << ";" << filter.getRotationY() << ";" << filter.getRotationZ() << ";";
+			output << accX - gravityX << ";" << accY - gravityY << ";" << sample.temperatureDeg << std::endl;
+		}
+		else if (record.type == TesLight::SensorRecording::RecordType::LIGHT)
+		{
+			output << "light;" << record.timestamp << ";" << (int)record.index << ";;;;;;" << SensorRecordingReader::getValue(record) << std::endl;
+		}
+		else if (record.type == TesLight::SensorRecording::RecordType::TEMPERATURE)
+		{
+			output << "temperature;" << record.timestamp << ";" << (int)record.index << ";;;;;;" << SensorRecordingReader::getValue(record) << std::endl;
+		}
+	}
+
+	output.close();
+	std::cout << "Replayed " << recordCount << " records from " << recordingFile << " into " << outputFile << "." << std::endl;
+	exit(0);
+}
+
+/**
+ * @brief Rotate a vector from the sensor frame into the vehicle frame using the mounting rotation of the controller.
+ * @param x x component of the vector
+ * @param y y component of the vector
+ * @param z z component of the vector
+ */
+void rotateToVehicle(float &x, float &y, float &z)
+{
+	static const float rotation[9] = MOTION_SENSOR_MOUNTING_ROTATION;
+	const float sensorX = x;
+	const float sensorY = y;
+	const float sensorZ = z;
+	x = rotation[0] * sensorX + rotation[1] * sensorY + rotation[2] * sensorZ;
+	y = rotation[3] * sensorX + rotation[4] * sensorY + rotation[5] * sensorZ;
+	z = rotation[6] * sensorX + rotation[7] * sensorY + rotation[8] * sensorZ;
+}
+
+/**
+ * @brief Print the help.
+ */
+void printHelp()
+{
+	std::cout << "This tool replays a sensor recording of the TesLight controller on your computer. ";
+	std::cout << "The motion samples are processed by the same filter as on the controller and the result is written to a CSV file. ";
+	std::cout << "The output only depends on the recording, so it can be compared before and after a change of the filter." << std::endl
+			  << std::endl;
+	std::cout << "The calibration of the motion sensor can be given with the option '--calibration <accX> <accY> <accZ> <gyroX> <gyroY> <gyroZ>' in g and deg/s." << std::endl
+			  << std::endl;
+	std::cout << "Please call me again with the following arguments: srt [--calibration <accX> <accY> <accZ> <gyroX> <gyroY> <gyroZ>] <recording_file> <output_file>";
+}
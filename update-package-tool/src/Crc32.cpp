@@ -0,0 +1,54 @@
+/**
+ * @file Crc32.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the {@link Crc32} class.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "Crc32.h"
+
+/**
+ * @brief Calculate or continue the CRC32 of the given data.
+ * The result is the same as the one of the crc32_le function in the ESP32 ROM.
+ * @param crc previous CRC or 0 to start a new calculation
+ * @param data data to add to the CRC
+ * @param length length of the data
+ * @return uint32_t the new CRC
+ */
+uint32_t Crc32::calculate(const uint32_t crc, const uint8_t *data, const size_t length)
+{
+	const uint32_t *table = Crc32::getTable();
+	uint32_t result = ~crc;
+	for (size_t i = 0; i < length; i++)
+	{
+		result = table[(result ^ data[i]) & 0xFF] ^ (result >> 8);
+	}
+	return ~result;
+}
+
+/**
+ * @brief Get the lookup table for the reflected polynomial 0xEDB88320.
+ * The table is created once on the first call, which is thread safe.
+ * @return const uint32_t* pointer to the 256 table entries
+ */
+const uint32_t *Crc32::getTable()
+{
+	static const struct Table
+	{
+		uint32_t values[256];
+		Table()
+		{
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				uint32_t value = i;
+				for (uint8_t j = 0; j < 8; j++)
+				{
+					value = value & 1 ? (value >> 1) ^ 0xEDB88320 : value >> 1;
+				}
+				this->values[i] = value;
+			}
+		}
+	} table;
+	return table.values;
+}
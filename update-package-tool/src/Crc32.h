@@ -0,0 +1,26 @@
+/**
+ * @file Crc32.h
+ * @author TheRealKasumi
+ * @brief Contains a class to calculate the CRC32 (IEEE 802.3) of data.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+class Crc32
+{
+public:
+	static uint32_t calculate(const uint32_t crc, const uint8_t *data, const size_t length);
+
+private:
+	Crc32();
+
+	static const uint32_t *getTable();
+};
+
+#endif
@@ -0,0 +1,171 @@
+/**
+ * @file FirmwareDelta.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the {@link FirmwareDelta} class.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "FirmwareDelta.h"
+
+/**
+ * @brief Create a delta to build the result firmware from the base firmware.
+ * The delta starts with the size and SHA-256 of the base and of the result, followed by a sequence of records.
+ * Each record contains the length of extra data, the length of diff data and the offset in the base firmware.
+ * The extra data is copied to the output, the diff data is added byte by byte to the base firmware at the offset.
+ * Similar to bsdiff, the regions are matched approximately, so the diff data is mostly zero and compresses well.
+ * @param base base firmware which is installed on the controller
+ * @param result new firmware
+ * @return std::vector<uint8_t> delta
+ */
+std::vector<uint8_t> FirmwareDelta::create(const std::vector<uint8_t> &base, const std::vector<uint8_t> &result)
+{
+	std::vector<uint8_t> delta;
+	uint8_t hash[32];
+	Sha256 sha;
+
+	FirmwareDelta::appendUint32(delta, base.size());
+	sha.update(base.data(), base.size());
+	sha.finish(hash);
+	delta.insert(delta.end(), hash, hash + 32);
+
+	sha.reset();
+	FirmwareDelta::appendUint32(delta, result.size());
+	sha.update(result.data(), result.size());
+	sha.finish(hash);
+	delta.insert(delta.end(), hash, hash + 32);
+
+	std::unordered_map<uint64_t, uint32_t> index;
+	index.reserve(base.size());
+	for (size_t i = 0; i + FIRMWARE_DELTA_SEED_LENGTH <= base.size(); i++)
+	{
+		index.emplace(FirmwareDelta::hash(&base[i]), i);
+	}
+
+	size_t position = 0;
+	while (position < result.size())
+	{
+		Region region;
+		if (!FirmwareDelta::findRegion(base, result, index, position, region))
+		{
+			region.resultStart = result.size();
+			region.baseStart = 0;
+			region.length = 0;
+		}
+
+		FirmwareDelta::appendRecord(delta, base, result, position, region);
+		position = region.resultStart + region.length;
+	}
+
+	return delta;
+}
+
+/**
+ * @brief Calculate the hash of {@link FIRMWARE_DELTA_SEED_LENGTH} bytes.
+ * @param data pointer to the data
+ * @return uint64_t hash
+ */
+uint64_t FirmwareDelta::hash(const uint8_t *data)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < FIRMWARE_DELTA_SEED_LENGTH; i++)
+	{
+		hash = (hash ^ data[i]) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+/**
+ * @brief Find the next region in the result, which approximately matches a region in the base firmware.
+ * The region is found by an exact seed match and then extended in both directions while most bytes still match.
+ * @param base base firmware
+ * @param result new firmware
+ * @param index index of the seeds in the base firmware
+ * @param start position in the result to start searching
+ * @param region reference to the found region
+ * @return true when a region was found
+ * @return false when there is no more matching region
+ */
+bool FirmwareDelta::findRegion(const std::vector<uint8_t> &base, const std::vector<uint8_t> &result, const std::unordered_map<uint64_t, uint32_t> &index, const size_t start, Region &region)
+{
+	for (size_t seed = start; seed + FIRMWARE_DELTA_SEED_LENGTH <= result.size(); seed++)
+	{
+		const std::unordered_map<uint64_t, uint32_t>::const_iterator match = index.find(FirmwareDelta::hash(&result[seed]));
+		if (match == index.end() || memcmp(&base[match->second], &result[seed], FIRMWARE_DELTA_SEED_LENGTH) != 0)
+		{
+			continue;
+		}
+
+		const size_t baseSeed = match->second;
+		int64_t score = 0;
+		int64_t bestScore = 0;
+		size_t forward = 0;
+		for (size_t i = 0; seed + i < result.size() && baseSeed + i < base.size() && score > bestScore - FIRMWARE_DELTA_EXTENSION_TOLERANCE; i++)
+		{
+			score += base[baseSeed + i] == result[seed + i] ? 1 : -1;
+			if (score > bestScore)
+			{
+				bestScore = score;
+				forward = i + 1;
+			}
+		}
+
+		int64_t backwardScore = 0;
+		int64_t bestBackwardScore = 0;
+		size_t backward = 0;
+		for (size_t i = 1; i <= seed - start && i <= baseSeed && backwardScore > bestBackwardScore - FIRMWARE_DELTA_EXTENSION_TOLERANCE; i++)
+		{
+			backwardScore += base[baseSeed - i] == result[seed - i] ? 1 : -1;
+			if (backwardScore > bestBackwardScore)
+			{
+				bestBackwardScore = backwardScore;
+				backward = i;
+			}
+		}
+
+		if (bestScore + bestBackwardScore < FIRMWARE_DELTA_MIN_REGION)
+		{
+			continue;
+		}
+
+		region.resultStart = seed - backward;
+		region.baseStart = baseSeed - backward;
+		region.length = backward + forward;
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Append a 32 bit value in little endian byte order.
+ * @param delta delta to append to
+ * @param value value to append
+ */
+void FirmwareDelta::appendUint32(std::vector<uint8_t> &delta, const uint32_t value)
+{
+	delta.push_back(value);
+	delta.push_back(value >> 8);
+	delta.push_back(value >> 16);
+	delta.push_back(value >> 24);
+}
+
+/**
+ * @brief Append a record with the extra data before a region and the diff data of the region.
+ * @param delta delta to append to
+ * @param base base firmware
+ * @param result new firmware
+ * @param extraStart start of the extra data in the result
+ * @param region region matching the base firmware, the extra data ends at the start of the region
+ */
+void FirmwareDelta::appendRecord(std::vector<uint8_t> &delta, const std::vector<uint8_t> &base, const std::vector<uint8_t> &result, const size_t extraStart, const Region &region)
+{
+	FirmwareDelta::appendUint32(delta, region.resultStart - extraStart);
+	FirmwareDelta::appendUint32(delta, region.length);
+	FirmwareDelta::appendUint32(delta, region.baseStart);
+	delta.insert(delta.end(), result.begin() + extraStart, result.begin() + region.resultStart);
+	for (size_t i = 0; i < region.length; i++)
+	{
+		delta.push_back(result[region.resultStart + i] - base[region.baseStart + i]);
+	}
+}
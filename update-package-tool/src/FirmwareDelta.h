@@ -0,0 +1,46 @@
+/**
+ * @file FirmwareDelta.h
+ * @author TheRealKasumi
+ * @brief Contains a class to create a binary delta between two firmware files.
+ * The delta can be applied on the controller while streaming it from the TUP file.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef FIRMWARE_DELTA_H
+#define FIRMWARE_DELTA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <unordered_map>
+#include <cstring>
+
+#include "Sha256.h"
+
+#define FIRMWARE_DELTA_SEED_LENGTH 12		// Length of exact matches used to find a region in the base firmware
+#define FIRMWARE_DELTA_MIN_REGION 32		// Minimum score of a region, shorter regions are stored as extra data
+#define FIRMWARE_DELTA_EXTENSION_TOLERANCE 32 // Score a region can lose while it is extended before the extension stops
+
+class FirmwareDelta
+{
+public:
+	static std::vector<uint8_t> create(const std::vector<uint8_t> &base, const std::vector<uint8_t> &result);
+
+private:
+	FirmwareDelta();
+
+	struct Region
+	{
+		size_t resultStart;
+		size_t baseStart;
+		size_t length;
+	};
+
+	static uint64_t hash(const uint8_t *data);
+	static bool findRegion(const std::vector<uint8_t> &base, const std::vector<uint8_t> &result, const std::unordered_map<uint64_t, uint32_t> &index, const size_t start, Region &region);
+	static void appendUint32(std::vector<uint8_t> &delta, const uint32_t value);
+	static void appendRecord(std::vector<uint8_t> &delta, const std::vector<uint8_t> &base, const std::vector<uint8_t> &result, const size_t extraStart, const Region &region);
+};
+
+#endif
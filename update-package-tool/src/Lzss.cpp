@@ -0,0 +1,102 @@
+/**
+ * @file Lzss.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the {@link Lzss} class.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "Lzss.h"
+
+/**
+ * @brief Compress the data. The output is a sequence of groups, each starting with a flag byte for the next 8 items.
+ * A set bit (starting with the lowest bit) marks a literal byte.
+ * A cleared bit marks a match of 2 bytes with the distance - 1 in the upper 12 bit and the length - 3 in the lower 4 bit.
+ * @param data data to compress
+ * @return std::vector<uint8_t> compressed data
+ */
+std::vector<uint8_t> Lzss::compress(const std::vector<uint8_t> &data)
+{
+	std::vector<uint8_t> output;
+	output.reserve(data.size() + data.size() / 8 + 1);
+
+	std::vector<int32_t> head(1 << LZSS_HASH_BITS, -1);
+	std::vector<int32_t> previous(data.size(), -1);
+	size_t flagPosition = 0;
+	uint8_t flagBits = 8;
+
+	size_t position = 0;
+	while (position < data.size())
+	{
+		if (flagBits == 8)
+		{
+			flagPosition = output.size();
+			output.push_back(0);
+			flagBits = 0;
+		}
+
+		size_t bestLength = 0;
+		size_t bestDistance = 0;
+		if (position + LZSS_MIN_MATCH <= data.size())
+		{
+			const size_t maxLength = data.size() - position < LZSS_MAX_MATCH ? data.size() - position : LZSS_MAX_MATCH;
+			int32_t candidate = head[Lzss::hash(&data[position])];
+			for (uint16_t i = 0; i < LZSS_MAX_CHAIN && candidate >= 0 && position - candidate <= LZSS_WINDOW_SIZE; i++)
+			{
+				size_t length = 0;
+				while (length < maxLength && data[candidate + length] == data[position + length])
+				{
+					length++;
+				}
+				if (length > bestLength)
+				{
+					bestLength = length;
+					bestDistance = position - candidate;
+					if (length == maxLength)
+					{
+						break;
+					}
+				}
+				candidate = previous[candidate];
+			}
+		}
+
+		size_t advance = 1;
+		if (bestLength >= LZSS_MIN_MATCH)
+		{
+			const uint16_t reference = (bestDistance - 1) << 4 | (bestLength - LZSS_MIN_MATCH);
+			output.push_back(reference >> 8);
+			output.push_back(reference & 0xFF);
+			advance = bestLength;
+		}
+		else
+		{
+			output[flagPosition] |= 1 << flagBits;
+			output.push_back(data[position]);
+		}
+		flagBits++;
+
+		for (size_t i = 0; i < advance; i++, position++)
+		{
+			if (position + LZSS_MIN_MATCH <= data.size())
+			{
+				const uint32_t key = Lzss::hash(&data[position]);
+				previous[position] = head[key];
+				head[key] = position;
+			}
+		}
+	}
+
+	return output;
+}
+
+/**
+ * @brief Calculate the hash of the next 3 bytes.
+ * @param data pointer to the data
+ * @return uint32_t hash with {@link LZSS_HASH_BITS} bits
+ */
+uint32_t Lzss::hash(const uint8_t *data)
+{
+	const uint32_t value = (uint32_t)data[0] << 16 | (uint32_t)data[1] << 8 | data[2];
+	return (value * 2654435761U) >> (32 - LZSS_HASH_BITS);
+}
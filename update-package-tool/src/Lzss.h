@@ -0,0 +1,34 @@
+/**
+ * @file Lzss.h
+ * @author TheRealKasumi
+ * @brief Contains a class to compress data with a simple LZSS algorithm.
+ * The format is decoded on the controller with a window of only 4 KiB.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef LZSS_H
+#define LZSS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#define LZSS_WINDOW_SIZE 4096 // Size of the sliding window, distances are stored with 12 bit
+#define LZSS_MIN_MATCH 3	  // Minimum length of a match
+#define LZSS_MAX_MATCH 18	  // Maximum length of a match, lengths are stored with 4 bit
+#define LZSS_HASH_BITS 14	  // Number of bits for the hash table to find matches
+#define LZSS_MAX_CHAIN 64	  // Maximum number of candidates checked for each match
+
+class Lzss
+{
+public:
+	static std::vector<uint8_t> compress(const std::vector<uint8_t> &data);
+
+private:
+	Lzss();
+
+	static uint32_t hash(const uint8_t *data);
+};
+
+#endif
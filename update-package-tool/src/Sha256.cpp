@@ -0,0 +1,183 @@
+/**
+ * @file Sha256.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the {@link Sha256} class.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "Sha256.h"
+
+namespace
+{
+	const uint32_t roundConstants[64] = {
+		0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+		0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+		0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+		0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+		0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+		0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+		0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+		0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+	inline uint32_t rotateRight(const uint32_t value, const uint8_t bits)
+	{
+		return (value >> bits) | (value << (32 - bits));
+	}
+}
+
+/**
+ * @brief Create a new instance of {@link Sha256}.
+ */
+Sha256::Sha256()
+{
+	this->reset();
+}
+
+/**
+ * @brief Destroy the {@link Sha256} instance.
+ */
+Sha256::~Sha256()
+{
+}
+
+/**
+ * @brief Reset the state to start a new calculation.
+ */
+void Sha256::reset()
+{
+	this->state[0] = 0x6a09e667;
+	this->state[1] = 0xbb67ae85;
+	this->state[2] = 0x3c6ef372;
+	this->state[3] = 0xa54ff53a;
+	this->state[4] = 0x510e527f;
+	this->state[5] = 0x9b05688c;
+	this->state[6] = 0x1f83d9ab;
+	this->state[7] = 0x5be0cd19;
+	this->blockLength = 0;
+	this->totalLength = 0;
+}
+
+/**
+ * @brief Add data to the hash.
+ * @param data data to add
+ * @param length length of the data
+ */
+void Sha256::update(const uint8_t *data, const size_t length)
+{
+	this->totalLength += length;
+	size_t offset = 0;
+
+	if (this->blockLength > 0)
+	{
+		while (offset < length && this->blockLength < 64)
+		{
+			this->block[this->blockLength++] = data[offset++];
+		}
+		if (this->blockLength < 64)
+		{
+			return;
+		}
+		this->processBlock(this->block);
+		this->blockLength = 0;
+	}
+
+	while (length - offset >= 64)
+	{
+		this->processBlock(data + offset);
+		offset += 64;
+	}
+
+	while (offset < length)
+	{
+		this->block[this->blockLength++] = data[offset++];
+	}
+}
+
+/**
+ * @brief Finish the calculation and output the hash. Call {@link Sha256::reset} to start a new calculation.
+ * @param hash output for the 32 bytes of the hash
+ */
+void Sha256::finish(uint8_t hash[32])
+{
+	const uint64_t bitLength = this->totalLength * 8;
+	const uint8_t padding = 0x80;
+	const uint8_t zero = 0;
+
+	this->update(&padding, 1);
+	while (this->blockLength != 56)
+	{
+		this->update(&zero, 1);
+	}
+
+	uint8_t lengthBytes[8];
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		lengthBytes[i] = bitLength >> (56 - i * 8);
+	}
+	this->update(lengthBytes, 8);
+
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		hash[i * 4] = this->state[i] >> 24;
+		hash[i * 4 + 1] = this->state[i] >> 16;
+		hash[i * 4 + 2] = this->state[i] >> 8;
+		hash[i * 4 + 3] = this->state[i];
+	}
+}
+
+/**
+ * @brief Process a single block of 64 bytes.
+ * @param data pointer to the block
+ */
+void Sha256::processBlock(const uint8_t *data)
+{
+	uint32_t w[64];
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		w[i] = (uint32_t)data[i * 4] << 24 | (uint32_t)data[i * 4 + 1] << 16 | (uint32_t)data[i * 4 + 2] << 8 | (uint32_t)data[i * 4 + 3];
+	}
+	for (uint8_t i = 16; i < 64; i++)
+	{
+		const uint32_t s0 = rotateRight(w[i - 15], 7) ^ rotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+		const uint32_t s1 = rotateRight(w[i - 2], 17) ^ rotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+		w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+	}
+
+	uint32_t a = this->state[0];
+	uint32_t b = this->state[1];
+	uint32_t c = this->state[2];
+	uint32_t d = this->state[3];
+	uint32_t e = this->state[4];
+	uint32_t f = this->state[5];
+	uint32_t g = this->state[6];
+	uint32_t h = this->state[7];
+
+	for (uint8_t i = 0; i < 64; i++)
+	{
+		const uint32_t s1 = rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25);
+		const uint32_t choice = (e & f) ^ (~e & g);
+		const uint32_t temp1 = h + s1 + choice + roundConstants[i] + w[i];
+		const uint32_t s0 = rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22);
+		const uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+		const uint32_t temp2 = s0 + majority;
+
+		h = g;
+		g = f;
+		f = e;
+		e = d + temp1;
+		d = c;
+		c = b;
+		b = a;
+		a = temp1 + temp2;
+	}
+
+	this->state[0] += a;
+	this->state[1] += b;
+	this->state[2] += c;
+	this->state[3] += d;
+	this->state[4] += e;
+	this->state[5] += f;
+	this->state[6] += g;
+	this->state[7] += h;
+}
@@ -0,0 +1,34 @@
+/**
+ * @file Sha256.h
+ * @author TheRealKasumi
+ * @brief Contains a class to calculate the SHA-256 of data in a streaming way.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+class Sha256
+{
+public:
+	Sha256();
+	~Sha256();
+
+	void reset();
+	void update(const uint8_t *data, const size_t length);
+	void finish(uint8_t hash[32]);
+
+private:
+	uint32_t state[8];
+	uint8_t block[64];
+	size_t blockLength;
+	uint64_t totalLength;
+
+	void processBlock(const uint8_t *data);
+};
+
+#endif
@@ -10,40 +10,42 @@
 
 /**
  * @brief Create a new instance of {@link TUPFile}.
+ * @param compress true to compress the data chunks when they get smaller
+ * @param threadCount number of threads used to process the data chunks
  */
-TUPFile::TUPFile()
+TUPFile::TUPFile(const bool compress, const size_t threadCount) : threadPool(threadCount)
 {
+	this->compress = compress;
 	this->header.magic[0] = 'T';
-	this->header.magic[0] = 'L';
-	this->header.magic[0] = 'U';
-	this->header.magic[0] = 'P';
-	this->header.fileVersion = 1;
-	this->header.hash = 0;
+	this->header.magic[1] = 'L';
+	this->header.magic[2] = 'U';
+	this->header.magic[3] = 'P';
+	this->header.fileVersion = TUP_FILE_VERSION;
+	memset(this->header.hash, 0, sizeof(this->header.hash));
+	this->header.numberBlocks = 0;
 }
 
 /**
- * @brief Destroy the {@link TUPFile} instance and free memory.
+ * @brief Destroy the {@link TUPFile} instance.
  */
 TUPFile::~TUPFile()
 {
-	for (size_t i = 0; i < this->dataBlocks.size(); i++)
-	{
-		const TUPDataBlock dataBlock = this->dataBlocks[i];
-		if (dataBlock.path != nullptr)
-		{
-			delete[] dataBlock.path;
-		}
-		if (dataBlock.data != nullptr)
-		{
-			delete[] dataBlock.data;
-		}
-	}
+}
+
+/**
+ * @brief Set a base firmware. When set, the firmware is stored as delta to the base firmware.
+ * The update can then only be installed on controllers running exactly the base firmware.
+ * @param baseFirmware path to the base firmware file
+ */
+void TUPFile::setBaseFirmware(const std::filesystem::path baseFirmware)
+{
+	this->baseFirmware = baseFirmware;
 }
 
 /**
  * @brief Generate the TUP file based on the given folder.
  * @param rootPath root path of the folder with all update files
- * @return true when the file was generated successfully (in memory)
+ * @return true when the file was generated successfully (only the file list is kept in memory)
  * @return false when there was an error constructing the TUP
  */
 bool TUPFile::generateFromFolder(const std::filesystem::path rootPath)
@@ -80,7 +82,9 @@ bool TUPFile::generateFromFolder(const std::filesystem::path rootPath)
 }
 
 /**
- * @brief Save the in memory TUP file to a file on the disk.
+ * @brief Write the TUP file to the disk. The data of the files is streamed from the source files into the output file.
+ * The chunks are processed by the thread pool, while only a limited number of chunks is kept in memory.
+ * The SHA-256 of everything after the header is calculated while writing and patched into the header at the end.
  * @param fileName output file name for the TUP file
  * @return true when the file was written successfully
  * @return false when there was an error writing the file
@@ -93,32 +97,38 @@ bool TUPFile::saveToFile(const std::filesystem::path fileName)
 		return false;
 	}
 
-	TUPHeader header;
-	header.magic[0] = 'T';
-	header.magic[1] = 'L';
-	header.magic[2] = 'U';
-	header.magic[3] = 'P';
-	header.fileVersion = 1;
-	header.hash = this->generateHash();
-	header.numberBlocks = this->dataBlocks.size();
+	this->header.numberBlocks = this->dataBlocks.size();
+	memset(this->header.hash, 0, sizeof(this->header.hash));
 
-	file.write(header.magic, 4);
-	file.write((char *)&header.fileVersion, 1);
-	file.write((char *)&header.hash, 4);
-	file.write((char *)&header.numberBlocks, 4);
+	file.write(this->header.magic, 4);
+	file.write((char *)&this->header.fileVersion, 1);
+	file.write((char *)this->header.hash, 32);
+	file.write((char *)&this->header.numberBlocks, 4);
 
+	Sha256 sha;
 	for (size_t i = 0; i < this->dataBlocks.size(); i++)
 	{
-		const TUPDataBlock dataBlock = this->dataBlocks[i];
-		file.write((char *)&dataBlock.type, 1);
-		file.write((char *)&dataBlock.pathLength, 2);
-		file.write(dataBlock.path, dataBlock.pathLength);
-		file.write((char *)&dataBlock.size, 4);
-		file.write((char *)dataBlock.data, dataBlock.size);
+		const TUPDataBlock &dataBlock = this->dataBlocks[i];
+		const uint8_t type = dataBlock.type;
+		const uint16_t pathLength = dataBlock.path.length();
+		this->writeHashed(file, sha, &type, 1);
+		this->writeHashed(file, sha, &pathLength, 2);
+		this->writeHashed(file, sha, dataBlock.path.c_str(), pathLength);
+		this->writeHashed(file, sha, &dataBlock.size, 4);
+
+		if (dataBlock.size > 0 && !this->writeBlockData(file, sha, dataBlock))
+		{
+			file.close();
+			return false;
+		}
 	}
 
+	sha.finish(this->header.hash);
+	file.seekp(5);
+	file.write((char *)this->header.hash, 32);
+
 	file.close();
-	return true;
+	return !file.fail();
 }
 
 /**
@@ -129,77 +139,195 @@ void TUPFile::addFolder(const std::filesystem::path path)
 {
 	TUPDataBlock dataBlock;
 	dataBlock.type = TUPDataType::DIRECTORY;
-	dataBlock.pathLength = path.string().length();
-	dataBlock.path = new char[dataBlock.pathLength];
-	memcpy(dataBlock.path, path.string().c_str(), dataBlock.pathLength);
+	dataBlock.path = path.string();
 	dataBlock.size = 0;
-	dataBlock.data = nullptr;
 	this->dataBlocks.push_back(dataBlock);
 }
 
 /**
- * @brief Add a file to the TUP file. The data of the file is loaded into memory and kept for writing it to the disk later.
+ * @brief Add a file to the TUP file. Only the name and size are stored, the data is read when the TUP file is saved.
  * @param fileName absolute file path and name to the file that has to be embedded.
  * @param name relative path and name of the file (to the root folder)
- * @return true when the file was embedded successfully
- * @return false when there was an error embedding the file
+ * @return true when the file was added successfully
+ * @return false when the file is empty or too large
  */
 bool TUPFile::addFile(const std::filesystem::path fileName, const std::filesystem::path name)
 {
-	const size_t fileSize = std::filesystem::file_size(fileName);
-	if (fileSize == 0)
+	const uintmax_t fileSize = std::filesystem::file_size(fileName);
+	if (fileSize == 0 || fileSize > UINT32_MAX)
 	{
 		return false;
 	}
 
-	std::ifstream file(fileName, std::ios::binary);
-	if (!file.is_open())
+	if (name == "firmware.bin" && !this->baseFirmware.empty())
 	{
-		return false;
+		return this->addFirmwareDelta(fileName, name);
 	}
 
 	TUPDataBlock dataBlock;
 	dataBlock.type = name == "firmware.bin" ? TUPDataType::FIRMWARE : TUPDataType::FILE;
-	dataBlock.pathLength = name.string().length();
-	dataBlock.path = new char[dataBlock.pathLength];
-	memcpy(dataBlock.path, name.string().c_str(), dataBlock.pathLength);
+	dataBlock.path = name.string();
 	dataBlock.size = fileSize;
-	dataBlock.data = new uint8_t[fileSize];
+	dataBlock.sourceFile = fileName;
+	this->dataBlocks.push_back(dataBlock);
+	return true;
+}
 
-	if (!file.read((char *)dataBlock.data, fileSize))
+/**
+ * @brief Add the firmware as delta to the base firmware. The delta is kept in memory.
+ * @param fileName absolute file path and name to the firmware
+ * @param name relative path and name of the firmware (to the root folder)
+ * @return true when the delta was created successfully
+ * @return false when one of the firmware files could not be read
+ */
+bool TUPFile::addFirmwareDelta(const std::filesystem::path fileName, const std::filesystem::path name)
+{
+	std::vector<uint8_t> base;
+	std::vector<uint8_t> result;
+	if (!TUPFile::readFile(this->baseFirmware, base) || !TUPFile::readFile(fileName, result))
 	{
-		delete[] dataBlock.path;
-		delete[] dataBlock.data;
-		file.close();
 		return false;
 	}
 
-	file.close();
+	TUPDataBlock dataBlock;
+	dataBlock.type = TUPDataType::FIRMWARE_DELTA;
+	dataBlock.path = name.string();
+	dataBlock.data = FirmwareDelta::create(base, result);
+	dataBlock.size = dataBlock.data.size();
 	this->dataBlocks.push_back(dataBlock);
 	return true;
 }
 
 /**
- * @brief Generate the simple hash for a weak package check.
- * @return uint32_t 4 bytes with the hash
+ * @brief Read a complete file into memory.
+ * @param fileName file to read
+ * @param data reference to the data
+ * @return true when the file was read successfully
+ * @return false when the file could not be read or is empty
  */
-uint32_t TUPFile::generateHash()
+bool TUPFile::readFile(const std::filesystem::path fileName, std::vector<uint8_t> &data)
 {
-	uint32_t hash = 7;
-	for (size_t i = 0; i < this->dataBlocks.size(); i++)
+	std::ifstream file(fileName, std::ios::binary);
+	if (!file.is_open())
 	{
-		const TUPDataBlock dataBlock = this->dataBlocks[i];
-		hash = hash * 31 + dataBlock.type;
-		hash = hash * 31 + dataBlock.pathLength;
-		for (size_t j = 0; j < dataBlock.pathLength; j++)
+		return false;
+	}
+
+	data.resize(std::filesystem::file_size(fileName));
+	return data.size() > 0 && file.read((char *)data.data(), data.size());
+}
+
+/**
+ * @brief Read the source file of a data block in chunks, process them in parallel and write them in order.
+ * Blocks with data in memory are read from memory instead.
+ * @param file output file
+ * @param sha SHA-256 of the data after the header
+ * @param dataBlock data block to write
+ * @return true when the data was written successfully
+ * @return false when the source file could not be read
+ */
+bool TUPFile::writeBlockData(std::ofstream &file, Sha256 &sha, const TUPDataBlock &dataBlock)
+{
+	std::ifstream sourceFile;
+	if (dataBlock.data.empty())
+	{
+		sourceFile.open(dataBlock.sourceFile, std::ios::binary);
+		if (!sourceFile.is_open())
+		{
+			return false;
+		}
+	}
+
+	const size_t maxPendingChunks = this->threadPool.getThreadCount() * TUP_CHUNKS_PER_THREAD;
+	std::deque<std::future<TUPChunk>> pendingChunks;
+	bool success = true;
+	for (uint32_t offset = 0; offset < dataBlock.size && success; offset += TUP_CHUNK_SIZE)
+	{
+		std::vector<uint8_t> data(dataBlock.size - offset < TUP_CHUNK_SIZE ? dataBlock.size - offset : TUP_CHUNK_SIZE);
+		if (!dataBlock.data.empty())
+		{
+			memcpy(data.data(), dataBlock.data.data() + offset, data.size());
+		}
+		else if (!sourceFile.read((char *)data.data(), data.size()))
+		{
+			success = false;
+			break;
+		}
+
+		const bool compress = this->compress;
+		pendingChunks.push_back(this->threadPool.submit<TUPChunk>([data = std::move(data), compress]() mutable
+																   { return TUPFile::processChunk(std::move(data), compress); }));
+
+		if (pendingChunks.size() >= maxPendingChunks)
 		{
-			hash = hash * 31 + dataBlock.path[j];
+			success = this->writeChunk(file, sha, pendingChunks.front());
+			pendingChunks.pop_front();
 		}
-		hash = hash * 31 + dataBlock.size;
-		for (size_t j = 0; j < dataBlock.size; j++)
+	}
+
+	while (!pendingChunks.empty())
+	{
+		success = this->writeChunk(file, sha, pendingChunks.front()) && success;
+		pendingChunks.pop_front();
+	}
+
+	sourceFile.close();
+	return success;
+}
+
+/**
+ * @brief Wait for a processed chunk and write it to the output file.
+ * @param file output file
+ * @param sha SHA-256 of the data after the header
+ * @param future future of the processed chunk
+ * @return true when the chunk was written
+ * @return false when there was an error writing the chunk
+ */
+bool TUPFile::writeChunk(std::ofstream &file, Sha256 &sha, std::future<TUPChunk> &future)
+{
+	const TUPChunk chunk = future.get();
+	const uint32_t storedSize = chunk.data.size();
+	this->writeHashed(file, sha, &chunk.rawSize, 4);
+	this->writeHashed(file, sha, &storedSize, 4);
+	this->writeHashed(file, sha, &chunk.crc, 4);
+	this->writeHashed(file, sha, chunk.data.data(), storedSize);
+	return file.good();
+}
+
+/**
+ * @brief Process a chunk of data. This runs on the worker threads.
+ * The chunk is only stored compressed when the compressed data is smaller than the raw data.
+ * @param data raw data of the chunk
+ * @param compress true to try to compress the chunk
+ * @return TUPFile::TUPChunk the processed chunk
+ */
+TUPFile::TUPChunk TUPFile::processChunk(std::vector<uint8_t> data, const bool compress)
+{
+	TUPChunk chunk;
+	chunk.rawSize = data.size();
+	chunk.crc = Crc32::calculate(0, data.data(), data.size());
+	if (compress)
+	{
+		std::vector<uint8_t> compressed = Lzss::compress(data);
+		if (compressed.size() < data.size())
 		{
-			hash = hash * 31 + dataBlock.data[j];
+			chunk.data = std::move(compressed);
+			return chunk;
 		}
 	}
-	return hash;
-}
\ No newline at end of file
+	chunk.data = std::move(data);
+	return chunk;
+}
+
+/**
+ * @brief Write data to the TUP file and add it to the SHA-256.
+ * @param file output file
+ * @param sha SHA-256 of the data after the header
+ * @param data data to write
+ * @param length length of the data
+ */
+void TUPFile::writeHashed(std::ofstream &file, Sha256 &sha, const void *data, const size_t length)
+{
+	file.write((const char *)data, length);
+	sha.update((const uint8_t *)data, length);
+}
@@ -10,10 +10,24 @@
 #define TUP_FILE_H
 
 #include <stdint.h>
+#include <string>
 #include <vector>
+#include <deque>
 #include <queue>
+#include <future>
 #include <filesystem>
 #include <fstream>
+#include <cstring>
+
+#include "Crc32.h"
+#include "FirmwareDelta.h"
+#include "Lzss.h"
+#include "Sha256.h"
+#include "ThreadPool.h"
+
+#define TUP_FILE_VERSION 3		 // Version of the generated TUP files
+#define TUP_CHUNK_SIZE 65536	 // Maximum size of the data chunks in a data block
+#define TUP_CHUNKS_PER_THREAD 4 // Number of chunks in flight per worker thread, limits the memory usage
 
 class TUPFile
 {
@@ -22,7 +36,7 @@ public:
 	{
 		char magic[4];
 		uint8_t fileVersion;
-		uint32_t hash;
+		uint8_t hash[32];
 		uint32_t numberBlocks;
 	};
 
@@ -30,32 +44,49 @@ public:
 	{
 		FIRMWARE = 0,
 		FILE = 1,
-		DIRECTORY = 2
+		DIRECTORY = 2,
+		FIRMWARE_DELTA = 3
 	};
 
 	struct TUPDataBlock
 	{
 		TUPDataType type;
-		uint16_t pathLength;
-		char *path;
+		std::string path;
 		uint32_t size;
-		uint8_t *data;
+		std::filesystem::path sourceFile;
+		std::vector<uint8_t> data;
 	};
 
-	TUPFile();
+	TUPFile(const bool compress = true, const size_t threadCount = std::thread::hardware_concurrency());
 	~TUPFile();
 
+	void setBaseFirmware(const std::filesystem::path baseFirmware);
 	bool generateFromFolder(const std::filesystem::path rootPath);
 	bool saveToFile(const std::filesystem::path fileName);
 
 private:
+	struct TUPChunk
+	{
+		uint32_t rawSize;
+		uint32_t crc;
+		std::vector<uint8_t> data;
+	};
+
 	TUPHeader header;
 	std::vector<TUPDataBlock> dataBlocks;
+	bool compress;
+	std::filesystem::path baseFirmware;
+	ThreadPool threadPool;
 
 	void addFolder(const std::filesystem::path path);
 	bool addFile(const std::filesystem::path fileName, const std::filesystem::path name);
+	bool addFirmwareDelta(const std::filesystem::path fileName, const std::filesystem::path name);
+	static bool readFile(const std::filesystem::path fileName, std::vector<uint8_t> &data);
 
-	uint32_t generateHash();
+	bool writeBlockData(std::ofstream &file, Sha256 &sha, const TUPDataBlock &dataBlock);
+	bool writeChunk(std::ofstream &file, Sha256 &sha, std::future<TUPChunk> &future);
+	static TUPChunk processChunk(std::vector<uint8_t> data, const bool compress);
+	void writeHashed(std::ofstream &file, Sha256 &sha, const void *data, const size_t length);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,70 @@
+/**
+ * @file ThreadPool.cpp
+ * @author TheRealKasumi
+ * @brief Implementation of the {@link ThreadPool} class.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#include "ThreadPool.h"
+
+/**
+ * @brief Create a new instance of {@link ThreadPool} and start the worker threads.
+ * @param threadCount number of worker threads, at least one thread is started
+ */
+ThreadPool::ThreadPool(const size_t threadCount)
+{
+	this->stopping = false;
+	for (size_t i = 0; i < (threadCount > 0 ? threadCount : 1); i++)
+	{
+		this->workers.emplace_back(&ThreadPool::work, this);
+	}
+}
+
+/**
+ * @brief Destroy the {@link ThreadPool} instance. Waits until all queued tasks are finished.
+ */
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->stopping = true;
+	}
+	this->condition.notify_all();
+	for (size_t i = 0; i < this->workers.size(); i++)
+	{
+		this->workers[i].join();
+	}
+}
+
+/**
+ * @brief Get the number of worker threads.
+ * @return size_t number of worker threads
+ */
+size_t ThreadPool::getThreadCount()
+{
+	return this->workers.size();
+}
+
+/**
+ * @brief Main loop of the worker threads.
+ */
+void ThreadPool::work()
+{
+	while (true)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(this->mutex);
+			this->condition.wait(lock, [this]()
+								 { return this->stopping || !this->tasks.empty(); });
+			if (this->tasks.empty())
+			{
+				return;
+			}
+			task = std::move(this->tasks.front());
+			this->tasks.pop();
+		}
+		task();
+	}
+}
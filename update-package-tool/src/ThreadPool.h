@@ -0,0 +1,59 @@
+/**
+ * @file ThreadPool.h
+ * @author TheRealKasumi
+ * @brief Contains a simple thread pool to process tasks in parallel.
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stddef.h>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+
+class ThreadPool
+{
+public:
+	ThreadPool(const size_t threadCount);
+	~ThreadPool();
+
+	size_t getThreadCount();
+
+	/**
+	 * @brief Submit a task to the pool.
+	 * @param task function to execute on one of the worker threads
+	 * @return std::future with the result of the task
+	 */
+	template <typename Result>
+	std::future<Result> submit(std::function<Result()> task)
+	{
+		std::shared_ptr<std::packaged_task<Result()>> packagedTask = std::make_shared<std::packaged_task<Result()>>(task);
+		std::future<Result> future = packagedTask->get_future();
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->tasks.push([packagedTask]()
+							 { (*packagedTask)(); });
+		}
+		this->condition.notify_one();
+		return future;
+	}
+
+private:
+	std::vector<std::thread> workers;
+	std::queue<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool stopping;
+
+	void work();
+};
+
+#endif
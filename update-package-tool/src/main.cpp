@@ -8,6 +8,7 @@
  */
 #include <iostream>
 #include <filesystem>
+#include <string>
 
 #include "TUPFile.h"
 
@@ -24,14 +25,33 @@ void printHelp();
 int main(int argc, char *argv[])
 {
 	printHeader();
-	if (argc != 3)
+	bool compress = true;
+	std::filesystem::path baseFirmware;
+	int argument = 1;
+	for (; argument < argc - 2; argument++)
+	{
+		if (std::string(argv[argument]) == "--no-compression")
+		{
+			compress = false;
+		}
+		else if (std::string(argv[argument]) == "--base" && argument + 1 < argc - 2)
+		{
+			baseFirmware = argv[++argument];
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	if (argc < 3 || argument != argc - 2)
 	{
 		printHelp();
 		exit(1);
 	}
 
-	const std::filesystem::path outputFile = argv[1];
-	const std::filesystem::path updateFolder = argv[2];
+	const std::filesystem::path outputFile = argv[argc - 2];
+	const std::filesystem::path updateFolder = argv[argc - 1];
 	if (!std::filesystem::exists(updateFolder) || !std::filesystem::is_directory(updateFolder))
 	{
 		std::cerr << "The update folder " << updateFolder << " is not valid." << std::endl
@@ -42,7 +62,19 @@ int main(int argc, char *argv[])
 
 	// Generate the TUP file
 	std::cout << "Generate TesLight Update Package from folder: " << updateFolder << std::endl;
-	TUPFile tupFile;
+	TUPFile tupFile(compress);
+	if (!baseFirmware.empty())
+	{
+		if (!std::filesystem::is_regular_file(baseFirmware))
+		{
+			std::cerr << "The base firmware " << baseFirmware << " is not valid." << std::endl
+					  << std::endl;
+			printHelp();
+			exit(2);
+		}
+		std::cout << "Create firmware delta to base firmware: " << baseFirmware << std::endl;
+		tupFile.setBaseFirmware(baseFirmware);
+	}
 	if (!tupFile.generateFromFolder(updateFolder))
 	{
 		std::cerr << "Failed to generate TesLight Update Package from folder.";
@@ -96,5 +128,9 @@ void printHelp()
 	std::cout << "By convention the firmware file for the controller is called 'firmware.bin' and must be in the root of the update folder. ";
 	std::cout << "Once you copied all files to the update folder, we are ready to go." << std::endl
 			  << std::endl;
-	std::cout << "Please call me again with the following arguments: tupt <output_file> <source_directory>";
+	std::cout << "The data is compressed by default. Use the option '--no-compression' to store it uncompressed. ";
+	std::cout << "With the option '--base <base_firmware>' only the delta to the base firmware is stored. ";
+	std::cout << "Such a package can only be installed on controllers running exactly the base firmware." << std::endl
+			  << std::endl;
+	std::cout << "Please call me again with the following arguments: tupt [--no-compression] [--base <base_firmware>] <output_file> <source_directory>";
 }